@@ -15,6 +15,10 @@
 #include <dsp_fft.h>
 #include <dsp_bfp.h>
 #include <dsp_dct.h>
+#include <dsp_stft.h>
+#include <dsp_fifo.h>
+#include <dsp_goertzel.h>
+#include <dsp_instrument.h>
 
 /* Macro to time function calls
  * After execution of this line the value in cycle_taken is valid.
@@ -4,6 +4,22 @@
 #define DSP_ADAPTIVE_H_
 
 #include <stdint.h>
+#include <dsp_filters.h>
+
+// State length for dsp_adaptive_fdaf, for a filter of num_taps taps processed in blocks of B samples
+#define DSP_ADAPTIVE_FDAF_STATE_LENGTH(num_taps,B) \
+    (DSP_FILTERS_FFT_CONVOLUTION_STATE_LENGTH(num_taps,B) + 5*(B) + 2)
+
+// Number of samples between recomputations of the energy kept by dsp_adaptive_nlms_incremental
+#ifndef DSP_ADAPTIVE_NLMS_RESYNC_PERIOD
+#define DSP_ADAPTIVE_NLMS_RESYNC_PERIOD 4096
+#endif
+
+/** Running state of dsp_adaptive_nlms_incremental, set up by dsp_adaptive_nlms_init. */
+typedef struct {
+    int64_t energy; // x[n]^2 + ... + x[n-N+1]^2, accumulated in 64 bits
+    int32_t count;  // Samples remaining until the energy is recomputed
+} dsp_adaptive_nlms_state_t;
 
 #ifdef __XC__
 extern "C" {
@@ -155,6 +171,212 @@ int32_t dsp_adaptive_nlms
     int32_t q_format
 );
 
+/** This function initializes the running state of an NLMS adaptive filter
+ *  that is processed by dsp_adaptive_nlms_incremental().
+ *
+ *  The energy of the filter state is computed once here, so the FIR state
+ *  array must hold its initial contents (normally all zeros) before this
+ *  function is called.
+ *
+ *  \param  nlms_state        Pointer to the running state to initialize.
+ *  \param  state_data        Pointer to FIR filter state data array of length N.
+ *  \param  num_taps          Filter tap count where N = num_taps = filter order + 1.
+ */
+
+void dsp_adaptive_nlms_init
+(
+    dsp_adaptive_nlms_state_t *nlms_state,
+    const int32_t state_data[],
+    const int32_t num_taps
+);
+
+/** This function implements a normalized LMS adaptive FIR filter that tracks
+ *  the instantaneous power incrementally.
+ *
+ *  The filter behaves exactly as dsp_adaptive_nlms(), and produces bit-identical
+ *  outputs, errors and coefficients for the same inputs. Instead of computing
+ *  ``E = x[n]^2 + x[n-1]^2 + ... + x[n-N+1]^2`` over the whole state on every
+ *  sample, the 64-bit sum is kept in ``nlms_state`` and updated by adding the
+ *  square of the new sample and subtracting the square of the sample leaving
+ *  the state. This removes a pass over N samples from each call.
+ *
+ *  The update is exact, so the energy does not drift. It is nevertheless
+ *  recomputed from the state array every DSP_ADAPTIVE_NLMS_RESYNC_PERIOD samples
+ *  so that the filter recovers if the state array is modified by the
+ *  application.
+ *
+ *  Example of a 100-tap NLMS filter with samples and coefficients represented
+ *  in Q28 fixed-point format:
+ *
+ *  \code
+ *  int32_t filter_coeff[100] = { ... not shown for brevity };
+ *  int32_t filter_state[100] = { 0, 0, 0, 0, ... not shown for brevity };
+ *  dsp_adaptive_nlms_state_t nlms_state;
+ *
+ *  dsp_adaptive_nlms_init( &nlms_state, filter_state, 100 );
+ *
+ *  int32_t output_sample = dsp_adaptive_nlms_incremental
+ *  (
+ *    input_sample, reference_sample, &error_sample,
+ *    filter_coeff_array, filter_state_array, &nlms_state, 100, Q28(0.01), 28
+ *  );
+ *  \endcode
+ *
+ *  \param  input_sample      The new sample to be processed.
+ *  \param  reference_sample  Reference sample.
+ *  \param  error_sample      Pointer to resulting error sample (error = reference - output)
+ *  \param  filter_coeffs     Pointer to FIR coefficients arranged as [b0,b1,b2, ...,bN-1].
+ *  \param  state_data        Pointer to FIR filter state data array of length N.
+ *                            Must be initialized at startup to all zeros.
+ *  \param  nlms_state        Pointer to the running state, initialized by
+ *                            dsp_adaptive_nlms_init().
+ *  \param  num_taps          Filter tap count where N = num_taps = filter order + 1.
+ *  \param  mu                Coefficient adjustment step size, controls rate of convergence.
+ *  \param  q_format          Fixed point format (i.e. number of fractional bits).
+ *  \returns                  The resulting filter output sample.
+ */
+
+int32_t dsp_adaptive_nlms_incremental
+(
+    int32_t input_sample,
+    int32_t reference_sample,
+    int32_t *error_sample,
+    const int32_t filter_coeffs[],
+    int32_t state_data[],
+    dsp_adaptive_nlms_state_t *nlms_state,
+    const int32_t num_taps,
+    const int32_t mu,
+    int32_t q_format
+);
+
+#if defined(__XS2A__)
+
+/** This function initializes a frequency-domain block NLMS adaptive filter.
+ *
+ *  The filter is split into partitions of ``block_length`` (B) taps, and each
+ *  partition is adapted in the frequency domain once per block of B samples
+ *  (a multi-delay block frequency-domain adaptive filter). The cost per sample
+ *  is a small fraction of dsp_adaptive_nlms() for long filters, such as
+ *  acoustic echo cancellation tails of thousands of taps.
+ *
+ *  The filter state starts with a dsp_filters_fft_convolution() state whose
+ *  filter spectra are the adaptive weights, so the filter output is computed
+ *  with the same partitioned overlap-save convolution. This function computes
+ *  the spectra of the initial coefficients, which may be all zeros, and clears
+ *  the state. It is called once, before the first call to dsp_adaptive_fdaf().
+ *
+ *  \code
+ *  int32_t filter_coeff[2048] = { 0 };
+ *  int32_t filter_state[DSP_ADAPTIVE_FDAF_STATE_LENGTH(2048,128)];
+ *  dsp_adaptive_fdaf_init( filter_coeff, 2048, 128, filter_state, 31,
+ *                          dsp_sine_128, dsp_sine_256 );
+ *  \endcode
+ *
+ *  \param  filter_coeffs   Pointer to initial FIR coefficients arranged as
+ *                          ``[b0,b1,b2, ...,bN-1]``.
+ *  \param  num_taps        Filter tap count where ``N`` = ``num_taps``.
+ *  \param  block_length    Number of samples per block (B). Must be a power of
+ *                          two, and at least 4.
+ *  \param  state_data      Pointer to filter state data array of length
+ *                          ``DSP_ADAPTIVE_FDAF_STATE_LENGTH(N,B)``.
+ *                          Must be double word aligned.
+ *  \param  q_format        Fixed point format of the coefficients (i.e. number
+ *                          of fractional bits).
+ *  \param  sine            Array of B/4+1 sine values, as used by
+ *                          dsp_fft_bit_reverse_and_forward_real().
+ *  \param  sin2            Array of B/2+1 sine values, as used by
+ *                          dsp_fft_bit_reverse_and_forward_real().
+ */
+
+void dsp_adaptive_fdaf_init
+(
+    const int32_t filter_coeffs[],
+    const int32_t num_taps,
+    const int32_t block_length,
+    int32_t       state_data[],
+    const int32_t q_format,
+    const int32_t sine[],
+    const int32_t sin2[]
+);
+
+/** This function implements a frequency-domain block NLMS adaptive filter,
+ *  initialized by dsp_adaptive_fdaf_init().
+ *
+ *  Each call processes a block of ``block_length`` (B) samples:
+ *
+ *  \code
+ *  1) Apply the transfer function: output = FIR( input ), as
+ *     dsp_filters_fft_convolution() with the current weights
+ *  2) Compute the error block: error = reference - output
+ *  3) Transform the error, and normalize every frequency bin by the
+ *     power of the input in that bin: E[k] = mu * FFT(error)[k] / P[k]
+ *  4) Adjust the weights of every partition by conj(X[k]) * E[k], where X
+ *     is the spectrum of the input block that partition was applied to
+ *  \endcode
+ *
+ *  The power ``P[k]`` is smoothed over blocks. It follows increases of the
+ *  input power immediately, and decays by 1/8 of the difference per block, so
+ *  that the step size does not overshoot at the onset of the input. A
+ *  regularization term of 1/64 of the mean power over all bins is added to
+ *  avoid large steps in bins without signal.
+ *
+ *  If ``constrained`` is non zero, the gradient of every partition is
+ *  transformed back to the time domain and its second half is cleared
+ *  before it is applied, so that each partition remains a B tap filter. This
+ *  costs two extra FFTs per partition per block, but converges to the
+ *  same solution as a time-domain NLMS. In this mode one partition of the
+ *  weights is also constrained per block, which stops rounding errors from
+ *  building up. If ``constrained`` is zero, the gradient is applied directly,
+ *  which is cheaper but converges more slowly, to a circular approximation of
+ *  the filter, and needs a step size divided by about the number of
+ *  partitions to remain stable.
+ *
+ *  \code
+ *  dsp_adaptive_fdaf( far_end, microphone, echo, residual, filter_state, 2048,
+ *                     128, Q31(0.5), 1, 31, dsp_sine_128, dsp_sine_256 );
+ *  \endcode
+ *
+ *  \param  input_samples      Array of B input samples.
+ *  \param  reference_samples  Array of B reference samples.
+ *  \param  output_samples     Array of B resulting filter output samples.
+ *                             May be the same array as ``input_samples``.
+ *  \param  error_samples      Array of B resulting error samples (error =
+ *                             reference - output). May be the same array as
+ *                             ``reference_samples``.
+ *  \param  state_data         Pointer to filter state data array, initialized
+ *                             by dsp_adaptive_fdaf_init().
+ *  \param  num_taps           Filter tap count where ``N`` = ``num_taps``.
+ *  \param  block_length       Number of samples per block (B).
+ *  \param  mu                 Coefficient adjustment step size in Q31 format,
+ *                             controls rate of convergence.
+ *  \param  constrained        Non zero to constrain the gradient to B taps per
+ *                             partition.
+ *  \param  q_format           Fixed point format of the coefficients, as
+ *                             passed to dsp_adaptive_fdaf_init().
+ *  \param  sine               Array of B/4+1 sine values, as used by
+ *                             dsp_fft_bit_reverse_and_forward_real().
+ *  \param  sin2               Array of B/2+1 sine values, as used by
+ *                             dsp_fft_bit_reverse_and_forward_real().
+ */
+
+void dsp_adaptive_fdaf
+(
+    const int32_t input_samples[],
+    const int32_t reference_samples[],
+    int32_t       output_samples[],
+    int32_t       error_samples[],
+    int32_t       state_data[],
+    const int32_t num_taps,
+    const int32_t block_length,
+    const int32_t mu,
+    const int32_t constrained,
+    const int32_t q_format,
+    const int32_t sine[],
+    const int32_t sin2[]
+);
+
+#endif
+
 #ifdef __XC__
 }
 #endif
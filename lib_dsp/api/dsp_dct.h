@@ -4,10 +4,13 @@
 #define DSP_DCT_H_
 
 #include "stdint.h"
+#include "dsp_complex.h"
 
 /* This library provides a limited set of discrete cosine transforms */
 /* DCT: 48, 32, 24, 16, 12, 8, 6, 4, 3, 2 and 1 point */
 /* inverse DCT: 4, 3, 2, 1 point only */
+/* DCT-II, DCT-III and DCT-IV of any power of two from 8 to 2048 points,
+ * computed through an FFT, and the MDCT built on the DCT-IV */
 
 /** This function performs a 48 point DCT
  *
@@ -157,6 +160,164 @@ void dsp_dct_inverse2(int32_t output[2], int32_t input[2]);
 void dsp_dct_inverse1(int32_t output[1], int32_t input[1]);
 
 
+/** This function performs an N point DCT-II, computed through an N/2 point
+ *  complex FFT.
+ *
+ *  The output uses the same basis vectors as dsp_dct_forward48(), but is
+ *  scaled by 1/N, so the first output is the mean of the input. The input
+ *  may use the full range of an int32_t.
+ *
+ *  The input is reordered into ``scratch``, transformed by dsp_fft_forward(),
+ *  and a single pass of twiddles produces the output, so no memory is
+ *  used on the stack.
+ *
+ *  \param  output          N DCT values.
+ *  \param  input           N input values.
+ *  \param  scratch         Array of N/2 dsp_complex_t elements; its
+ *                          contents are overwritten.
+ *  \param  N               Number of points, a power of two from 8 to 2048.
+ *  \param  sine            Sine table for an N/2 point FFT, for example
+ *                          dsp_sine_512 for N = 1024.
+ *  \param  dct_sine        Sine table of 8N points, for example
+ *                          dsp_sine_8192 for N = 1024.
+ */
+void dsp_dct_forward(int32_t output[], const int32_t input[], dsp_complex_t scratch[],
+                     const uint32_t N, const int32_t sine[], const int32_t dct_sine[]);
+
+/** This function performs an N point DCT-III, the inverse of
+ *  dsp_dct_forward(), computed through an N/2 point complex FFT.
+ *
+ *  The output is ``input[0] + 2 * sum(input[k] * cos(pi*(2n+1)*k/(2N)))``,
+ *  so that the output of dsp_dct_forward() is transformed back to its
+ *  input. As for dsp_fft_inverse() the transform is not scaled, and the
+ *  output must fit in an int32_t with some headroom.
+ *
+ *  \param  output          N output values.
+ *  \param  input           N DCT values.
+ *  \param  scratch         Array of N/2 dsp_complex_t elements; its
+ *                          contents are overwritten.
+ *  \param  N               Number of points, a power of two from 8 to 2048.
+ *  \param  sine            Sine table for an N/2 point FFT.
+ *  \param  dct_sine        Sine table of 8N points.
+ */
+void dsp_dct_inverse(int32_t output[], const int32_t input[], dsp_complex_t scratch[],
+                     const uint32_t N, const int32_t sine[], const int32_t dct_sine[]);
+
+/** This function performs an N point DCT-IV, computed through an N/2 point
+ *  complex FFT.
+ *
+ *  Output k is ``sum(input[n] * cos(pi*(2n+1)*(2k+1)/(4N))) / N``. The
+ *  input may use the full range of an int32_t. This is the transform at
+ *  the core of the MDCT.
+ *
+ *  \param  output          N DCT-IV values.
+ *  \param  input           N input values.
+ *  \param  scratch         Array of N/2 dsp_complex_t elements; its
+ *                          contents are overwritten.
+ *  \param  N               Number of points, a power of two from 8 to 2048.
+ *  \param  sine            Sine table for an N/2 point FFT.
+ *  \param  dct_sine        Sine table of 8N points.
+ */
+void dsp_dct_iv_forward(int32_t output[], const int32_t input[], dsp_complex_t scratch[],
+                        const uint32_t N, const int32_t sine[], const int32_t dct_sine[]);
+
+/** This function performs an N point inverse DCT-IV, the inverse of
+ *  dsp_dct_iv_forward().
+ *
+ *  The DCT-IV is its own inverse up to a factor of N/2; this function
+ *  computes ``2 * sum(input[k] * cos(pi*(2n+1)*(2k+1)/(4N)))``, which
+ *  undoes the scaling of dsp_dct_iv_forward(). The output must fit in an
+ *  int32_t with some headroom.
+ *
+ *  \param  output          N output values.
+ *  \param  input           N DCT-IV values.
+ *  \param  scratch         Array of N/2 dsp_complex_t elements; its
+ *                          contents are overwritten.
+ *  \param  N               Number of points, a power of two from 8 to 2048.
+ *  \param  sine            Sine table for an N/2 point FFT.
+ *  \param  dct_sine        Sine table of 8N points.
+ */
+void dsp_dct_iv_inverse(int32_t output[], const int32_t input[], dsp_complex_t scratch[],
+                        const uint32_t N, const int32_t sine[], const int32_t dct_sine[]);
+
+/** This function computes the rising half of a sine window for
+ *  dsp_mdct_forward() and dsp_mdct_inverse(), ``sin(pi*(n+0.5)/(2M))``.
+ *
+ *  The window of a 2M sample frame is symmetric; only the first M values
+ *  are stored, and the functions mirror them for the second half.
+ *
+ *  \param  window          Array of M values, each a sign bit and a 31 bit
+ *                          fraction.
+ *  \param  M               Number of MDCT coefficients per frame.
+ */
+void dsp_mdct_window_sine(int32_t window[], const uint32_t M);
+
+/** This function computes the rising half of a Kaiser-Bessel-derived window
+ *  for dsp_mdct_forward() and dsp_mdct_inverse().
+ *
+ *  Larger values of alpha give more stopband rejection at the expense of a
+ *  wider main lobe; AAC uses 4 for long blocks and 6 for short blocks. This
+ *  function uses double precision arithmetic and is intended to be called
+ *  at startup.
+ *
+ *  \param  window          Array of M values, each a sign bit and a 31 bit
+ *                          fraction.
+ *  \param  M               Number of MDCT coefficients per frame.
+ *  \param  alpha           Kaiser window parameter.
+ */
+void dsp_mdct_window_kbd(int32_t window[], const uint32_t M, const double alpha);
+
+/** This function computes the MDCT of a block of M new samples, using 2M
+ *  samples windowed by ``window``: the M samples of the previous call, kept
+ *  in ``state``, and the M samples in ``input``.
+ *
+ *  Output k is ``sum(w[n] * x[n] * cos(pi/M*(n+0.5+M/2)*(k+0.5))) / 2M``,
+ *  over the 2M samples of the frame. The windowing and folding of the frame
+ *  are combined with the pre-rotation of an M point DCT-IV, which is
+ *  computed through an M/2 point complex FFT, as dsp_dct_iv_forward().
+ *
+ *  \param  coeffs          M MDCT coefficients.
+ *  \param  input           M new input samples.
+ *  \param  state           M samples of history; initialize to zero.
+ *  \param  scratch         Array of M/2 dsp_complex_t elements; its
+ *                          contents are overwritten.
+ *  \param  M               Number of coefficients, a power of two from 8 to
+ *                          2048.
+ *  \param  window          Rising half of the window, for example from
+ *                          dsp_mdct_window_sine().
+ *  \param  sine            Sine table for an M/2 point FFT, for example
+ *                          dsp_sine_256 for M = 512.
+ *  \param  dct_sine        Sine table of 8M points, for example
+ *                          dsp_sine_4096 for M = 512.
+ */
+void dsp_mdct_forward(int32_t coeffs[], const int32_t input[], int32_t state[],
+                      dsp_complex_t scratch[], const uint32_t M, const int32_t window[],
+                      const int32_t sine[], const int32_t dct_sine[]);
+
+/** This function computes the inverse MDCT of M coefficients and overlap-adds
+ *  it with the previous frame, producing M output samples.
+ *
+ *  Passing the output of dsp_mdct_forward() through this function with the
+ *  same window reconstructs the input, delayed by M samples, provided the
+ *  window satisfies ``w[n]^2 + w[M-1-n]^2 = 1``, as the sine and KBD
+ *  windows do. The second half of each windowed frame is kept in ``state``
+ *  until the next call.
+ *
+ *  \param  output          M output samples.
+ *  \param  coeffs          M MDCT coefficients.
+ *  \param  state           M samples of overlap; initialize to zero.
+ *  \param  scratch         Array of M/2 dsp_complex_t elements; its
+ *                          contents are overwritten.
+ *  \param  M               Number of coefficients, a power of two from 8 to
+ *                          2048.
+ *  \param  window          Rising half of the window.
+ *  \param  sine            Sine table for an M/2 point FFT.
+ *  \param  dct_sine        Sine table of 8M points.
+ */
+void dsp_mdct_inverse(int32_t output[], const int32_t coeffs[], int32_t state[],
+                      dsp_complex_t scratch[], const uint32_t M, const int32_t window[],
+                      const int32_t sine[], const int32_t dct_sine[]);
+
 #ifdef INCLUDE_REFERENCE_DCT
 #include <math.h>
 
@@ -4,6 +4,7 @@
 #define DSP_DESIGN_H_
 
 #include "stdint.h"
+#include "dsp_math.h"
 
 /** This function generates BiQuad filter coefficients for a notch filter.
  *
@@ -251,4 +252,182 @@ void dsp_design_biquad_highshelf
     const int32_t q_format
 );
 
+/** This function generates BiQuad filter coefficients for a notch filter,
+ *  as dsp_design_biquad_notch(), with fixed-point arithmetic.
+ *
+ *  The fixed-point design functions evaluate the same formulas as the
+ *  floating point ones with 64-bit integer intermediates and the Q8.24
+ *  functions of dsp_math, so they are much faster on xCORE, which has no
+ *  floating point unit. They are intended for redesigning filters at run
+ *  time, for example on a control core that hands the coefficients to
+ *  dsp_filters_biquads_smooth(). The coefficients are within about one part
+ *  in a million of those of the floating point functions, limited by the
+ *  precision of dsp_math_sin().
+ *
+ *  Example showing the coefficients of a notch filter at Fs/4 using Q28
+ *  fixed-point formatting.
+ *
+ *  \code
+ *  int32_t coeffs[5];
+ *  dsp_design_biquad_notch_fixed( Q31(0.25), Q24(0.707), coeffs, 28 );
+ *  \endcode
+ *
+ *  \param  filter_frequency   Filter center frequency normalized to the sampling frequency,
+ *                             in Q1.31 format. ``0 < frequency < 0.5``, where 0.5 represents Fs/2.
+ *  \param  filter_Q           The filter Q-factor, in Q8.24 format.
+ *  \param  biquad_coeffs      The array used to contain the resulting filter coefficients.
+ *                             Filter coefficients are ordered as ``[b0,b1,b2,-a1,-a2]``.
+ *  \param  q_format           Fixed point format of coefficients (i.e. number of fractional bits),
+ *                             at most 30.
+ */
+
+void dsp_design_biquad_notch_fixed
+(
+    int32_t filter_frequency,
+    q8_24   filter_Q,
+    int32_t biquad_coeffs[5],
+    const int32_t q_format
+);
+
+/** This function generates BiQuad filter coefficients for a low-pass filter,
+ *  as dsp_design_biquad_lowpass(), with fixed-point arithmetic (see
+ *  dsp_design_biquad_notch_fixed()).
+ *
+ *  \param  filter_frequency   Filter cutoff (-3db) frequency normalized to Fs, in Q1.31
+ *                             format. ``0 < frequency < 0.5``, where 0.5 represents Fs/2.
+ *  \param  filter_Q           The filter Q-factor, in Q8.24 format.
+ *  \param  biquad_coeffs      The array used to contain the resulting filter coefficients.
+ *                             Filter coefficients are ordered as ``[b0,b1,b2,-a1,-a2]``.
+ *  \param  q_format           Fixed point format of coefficients (i.e. number of fractional bits),
+ *                             at most 30.
+ */
+
+void dsp_design_biquad_lowpass_fixed
+(
+    int32_t filter_frequency,
+    q8_24   filter_Q,
+    int32_t biquad_coeffs[5],
+    const int32_t q_format
+);
+
+/** This function generates BiQuad filter coefficients for a high-pass filter,
+ *  as dsp_design_biquad_highpass(), with fixed-point arithmetic (see
+ *  dsp_design_biquad_notch_fixed()).
+ *
+ *  \param  filter_frequency   Filter cutoff (-3db) frequency normalized to Fs, in Q1.31
+ *                             format. ``0 < frequency < 0.5``, where 0.5 represents Fs/2.
+ *  \param  filter_Q           The filter Q-factor, in Q8.24 format.
+ *  \param  biquad_coeffs      The array used to contain the resulting filter coefficients.
+ *                             Filter coefficients are ordered as ``[b0,b1,b2,-a1,-a2]``.
+ *  \param  q_format           Fixed point format of coefficients (i.e. number of fractional bits),
+ *                             at most 30.
+ */
+
+void dsp_design_biquad_highpass_fixed
+(
+    int32_t filter_frequency,
+    q8_24   filter_Q,
+    int32_t biquad_coeffs[5],
+    const int32_t q_format
+);
+
+/** This function generates BiQuad filter coefficients for an all-pass filter,
+ *  as dsp_design_biquad_allpass(), with fixed-point arithmetic (see
+ *  dsp_design_biquad_notch_fixed()).
+ *
+ *  \param  filter_frequency   Filter center frequency normalized to Fs, in Q1.31
+ *                             format. ``0 < frequency < 0.5``, where 0.5 represents Fs/2.
+ *  \param  filter_Q           The filter Q-factor, in Q8.24 format.
+ *  \param  biquad_coeffs      The array used to contain the resulting filter coefficients.
+ *                             Filter coefficients are ordered as ``[b0,b1,b2,-a1,-a2]``.
+ *  \param  q_format           Fixed point format of coefficients (i.e. number of fractional bits),
+ *                             at most 30.
+ */
+
+void dsp_design_biquad_allpass_fixed
+(
+    int32_t filter_frequency,
+    q8_24   filter_Q,
+    int32_t biquad_coeffs[5],
+    const int32_t q_format
+);
+
+/** This function generates BiQuad filter coefficients for a peaking filter,
+ *  as dsp_design_biquad_peaking(), with fixed-point arithmetic (see
+ *  dsp_design_biquad_notch_fixed()).
+ *
+ *  Example showing the coefficients of one band of an equalizer, at 1kHz
+ *  for a sample rate of 48kHz with +3dB gain, using Q28 fixed-point
+ *  formatting.
+ *
+ *  \code
+ *  int32_t coeffs[5];
+ *  dsp_design_biquad_peaking_fixed( Q31(1000.0/48000.0), Q24(0.707), Q24(3.0), coeffs, 28 );
+ *  \endcode
+ *
+ *  \param  filter_frequency   Filter center frequency normalized to Fs, in Q1.31
+ *                             format. ``0 < frequency < 0.5``, where 0.5 represents Fs/2.
+ *  \param  filter_Q           The filter Q-factor, in Q8.24 format.
+ *  \param  peak_gain_db       The filter gain in dB (postive or negative), in Q8.24 format.
+ *  \param  biquad_coeffs      The array used to contain the resulting filter coefficients.
+ *                             Filter coefficients are ordered as ``[b0,b1,b2,-a1,-a2]``.
+ *  \param  q_format           Fixed point format of coefficients (i.e. number of fractional bits),
+ *                             at most 30.
+ */
+
+void dsp_design_biquad_peaking_fixed
+(
+    int32_t filter_frequency,
+    q8_24   filter_Q,
+    q8_24   peak_gain_db,
+    int32_t biquad_coeffs[5],
+    const int32_t q_format
+);
+
+/** This function generates BiQuad filter coefficients for a bass shelving
+ *  filter, as dsp_design_biquad_lowshelf(), with fixed-point arithmetic (see
+ *  dsp_design_biquad_notch_fixed()).
+ *
+ *  \param  filter_frequency   Filter frequency (+3db or -3db point) normalized to Fs, in
+ *                             Q1.31 format. ``0 < frequency < 0.5``, where 0.5 represents Fs/2.
+ *  \param  filter_Q           The filter Q-factor, in Q8.24 format.
+ *  \param  shelf_gain_db      The filter shelf gain in dB (postive or negative), in Q8.24 format.
+ *  \param  biquad_coeffs      The array used to contain the resulting filter coefficients.
+ *                             Filter coefficients are ordered as ``[b0,b1,b2,-a1,-a2]``.
+ *  \param  q_format           Fixed point format of coefficients (i.e. number of fractional bits),
+ *                             at most 30.
+ */
+
+void dsp_design_biquad_lowshelf_fixed
+(
+    int32_t filter_frequency,
+    q8_24   filter_Q,
+    q8_24   shelf_gain_db,
+    int32_t biquad_coeffs[5],
+    const int32_t q_format
+);
+
+/** This function generates BiQuad filter coefficients for a treble shelving
+ *  filter, as dsp_design_biquad_highshelf(), with fixed-point arithmetic (see
+ *  dsp_design_biquad_notch_fixed()).
+ *
+ *  \param  filter_frequency   Filter frequency (+3db or -3db point) normalized to Fs, in
+ *                             Q1.31 format. ``0 < frequency < 0.5``, where 0.5 represents Fs/2.
+ *  \param  filter_Q           The filter Q-factor, in Q8.24 format.
+ *  \param  shelf_gain_db      The filter shelf gain in dB (postive or negative), in Q8.24 format.
+ *  \param  biquad_coeffs      The array used to contain the resulting filter coefficients.
+ *                             Filter coefficients are ordered as ``[b0,b1,b2,-a1,-a2]``.
+ *  \param  q_format           Fixed point format of coefficients (i.e. number of fractional bits),
+ *                             at most 30.
+ */
+
+void dsp_design_biquad_highshelf_fixed
+(
+    int32_t filter_frequency,
+    q8_24   filter_Q,
+    q8_24   shelf_gain_db,
+    int32_t biquad_coeffs[5],
+    const int32_t q_format
+);
+
 #endif
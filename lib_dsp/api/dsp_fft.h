@@ -5,7 +5,45 @@
 
 #include <stdint.h>
 #include <dsp_complex.h>
+#include <xccompat.h>
 
+/** Selects one sine table for FFTs of all sizes. When 0 (the default) every
+ * function that takes a sine table for N points reads the N/4+1 values of
+ * dsp_sine_N, and each table that is used is linked in. When set to a power
+ * of two M between 4 and 16384, every such function reads the M/4+1 values
+ * of the table for M points with a stride of M/N instead, so N must be at
+ * most M. Only that table is linked in, as dsp_sine_shared, and the names
+ * dsp_sine_N and FFT_SINE(N) all refer to it, so code that passes them is
+ * unchanged. The results are bit exact, as the values of dsp_sine_N are
+ * every (M/N)th value of the table for M points.
+ */
+#ifndef DSP_SINE_SHARED
+#define DSP_SINE_SHARED 0
+#endif
+
+/** Selects sine tables generated at run time. When 0 (the default) the
+ * dsp_sine_N tables are constants in the library. When 1 no tables are
+ * linked in, and the names dsp_sine_N are not declared: the application
+ * fills a buffer with dsp_fft_sine_generate() during initialization and
+ * passes it instead. Combined with DSP_SINE_SHARED one buffer of
+ * DSP_SINE_SHARED/4+1 words serves FFTs of all sizes.
+ */
+#ifndef DSP_SINE_GENERATED
+#define DSP_SINE_GENERATED 0
+#endif
+
+// Number of points of, and stride through, the table read by a function
+// given a sine table for N points
+#if DSP_SINE_SHARED
+#define DSP_SINE_POINTS(N) (DSP_SINE_SHARED)
+#define DSP_SINE_STRIDE(N) (DSP_SINE_SHARED / (N))
+#else
+#define DSP_SINE_POINTS(N) (N)
+#define DSP_SINE_STRIDE(N) 1
+#endif
+
+#if !DSP_SINE_GENERATED
+#if !DSP_SINE_SHARED
 extern const int32_t dsp_sine_4[];
 extern const int32_t dsp_sine_8[];
 extern const int32_t dsp_sine_16[];
@@ -19,10 +57,58 @@ extern const int32_t dsp_sine_2048[];
 extern const int32_t dsp_sine_4096[];
 extern const int32_t dsp_sine_8192[];
 extern const int32_t dsp_sine_16384[];
+#else
+extern const int32_t dsp_sine_shared[];
+#define dsp_sine_4      dsp_sine_shared
+#define dsp_sine_8      dsp_sine_shared
+#define dsp_sine_16     dsp_sine_shared
+#define dsp_sine_32     dsp_sine_shared
+#define dsp_sine_64     dsp_sine_shared
+#define dsp_sine_128    dsp_sine_shared
+#define dsp_sine_256    dsp_sine_shared
+#define dsp_sine_512    dsp_sine_shared
+#define dsp_sine_1024   dsp_sine_shared
+#define dsp_sine_2048   dsp_sine_shared
+#define dsp_sine_4096   dsp_sine_shared
+#define dsp_sine_8192   dsp_sine_shared
+#define dsp_sine_16384  dsp_sine_shared
+#endif
+#endif
+
+/** Selects the kernels used by dsp_fft_forward() and dsp_fft_inverse() on
+ * xCORE-200. When 0 (the default) the radix-2 assembly kernels are used.
+ * When 1, radix-4 kernels are used instead, with a final radix-2 pass when
+ * log2(N) is odd. These make half as many passes over the data and need
+ * three complex multiplies per four points instead of four. Both take the
+ * same bit reversed input and dsp_sine_N tables, and give the same output
+ * scaling; results may differ in the least significant bits.
+ */
+#ifndef DSP_FFT_RADIX4
+#define DSP_FFT_RADIX4 0
+#endif
+
+// Maximum number of radix 2, 3, 4 and 5 passes of dsp_fft_mixed_forward
+#define DSP_FFT_MIXED_MAX_FACTORS 16
+
+// State length for dsp_fft_mixed_init, for an N point transform
+#define DSP_FFT_MIXED_STATE_LENGTH(N) (2 + DSP_FFT_MIXED_MAX_FACTORS + 4*(N))
 
 #define FFT_SINE0(N) dsp_sine_ ## N
 #define FFT_SINE(N) FFT_SINE0(N)
 
+/** This function fills an array with the sine table for an N point FFT,
+ * for use when DSP_SINE_GENERATED is set. The values are computed with a
+ * CORDIC in 64-bit integer arithmetic, so no floating point code is linked
+ * in, and the table is identical to dsp_sine_N. The CORDIC takes 56 iterations per value, so
+ * it is meant to be called once during initialization.
+ *
+ * \param[out]    sine  Array of N/4+1 sine values, each represented as a sign bit,
+ *                      and a 31 bit fraction. 1 is represented by 0x7fffffff.
+ * \param[in]     N     Number of points of the FFT, a power of two between 4
+ *                      and 16384. With DSP_SINE_SHARED, use DSP_SINE_SHARED.
+ */
+void dsp_fft_sine_generate( int32_t sine[], const uint32_t N );
+
 /** This function splits the spectrum of the FFT of two real sequences. Takes
  * the result of a double-packed dsp_complex_t array that has undergone
  * an FFT. This function splits the result into two arrays, one for each real
@@ -67,6 +153,43 @@ void dsp_fft_short_to_long( const dsp_complex_short_t s[], dsp_complex_t l[], co
  */
 void dsp_fft_long_to_short( const dsp_complex_t l[], dsp_complex_short_t s[], const uint32_t N );
 
+/** This function performs index bit reversing on an array of
+ * dsp_complex_short_t elements, prior to dsp_fft_forward_short() or
+ * dsp_fft_inverse_short().
+ *
+ * \param[in,out] pts   Array of dsp_complex_short_t elements.
+ * \param[in]     N     Number of points. Must be a power of two.
+ */
+void dsp_fft_bit_reverse_short( dsp_complex_short_t pts[], const uint32_t N );
+
+/** This function computes a forward FFT on 16-bit complex values, in place.
+ * It computes the same transform as converting the array with
+ * dsp_fft_short_to_long(), calling dsp_fft_forward() and converting back with
+ * dsp_fft_long_to_short(), without the 32-bit copy of the data. The
+ * butterflies accumulate in 32 bits and each pass is rounded to 16 bits,
+ * so the output may differ from the 32-bit transform in the last few bits.
+ * As for dsp_fft_forward() the output is scaled by 1/N, and the input must
+ * be bit reversed beforehand with dsp_fft_bit_reverse_short().
+ *
+ * \param[in,out] pts   Array of dsp_complex_short_t elements.
+ * \param[in]     N     Number of points. Must be a power of two.
+ * \param[in]     sine  Array of N/4+1 sine values, as for dsp_fft_forward();
+ *                      for example, for a 1024 point FFT use dsp_sine_1024.
+ */
+void dsp_fft_forward_short( dsp_complex_short_t pts[], const uint32_t N, const int32_t sine[] );
+
+/** This function computes an inverse FFT on 16-bit complex values, in place.
+ * As for dsp_fft_inverse() the output is not scaled, so the input must have
+ * enough headroom for the gain of the transform; results that exceed 16 bits
+ * are saturated. The input must be bit reversed beforehand with
+ * dsp_fft_bit_reverse_short().
+ *
+ * \param[in,out] pts   Array of dsp_complex_short_t elements.
+ * \param[in]     N     Number of points. Must be a power of two.
+ * \param[in]     sine  Array of N/4+1 sine values, as for dsp_fft_forward().
+ */
+void dsp_fft_inverse_short( dsp_complex_short_t pts[], const uint32_t N, const int32_t sine[] );
+
 /** This function preforms index bit reversing on the the arrays around prior to computing an FFT. A
  * calling sequence for a forward FFT involves dsp_fft_bit_reverse() followed by
  * dsp_fft_forward(), and for an inverse FFT it involves dsp_fft_bit_reverse() followed
@@ -233,5 +356,457 @@ void dsp_fft_bit_reverse_and_inverse_real (
     const int32_t         sine[],
     const int32_t         sin2[]
     );
+
+/** Output of dsp_fft_real_spectrum(). */
+typedef enum {
+    DSP_FFT_SPECTRUM_MAGNITUDE, // sqrt(re^2 + im^2) of each bin
+    DSP_FFT_SPECTRUM_POWER      // (re^2 + im^2) >> 31 of each bin
+} dsp_fft_spectrum_t;
+
+/** This function computes the Hann window for dsp_fft_real_spectrum(); the
+ * window of an N sample frame is 0.5 - 0.5 * cos(2 * pi * (n + 0.5) / N).
+ * The window is symmetric, and only the first N/2 values are stored.
+ *
+ * \param[out] window  Array of N/2 values, each a sign bit and a 31 bit
+ *                     fraction.
+ * \param[in]  N       Number of samples in the frame.
+ */
+void dsp_fft_window_hann( int32_t window[], const uint32_t N );
+
+/** This function computes the Blackman window for dsp_fft_real_spectrum();
+ * the window of an N sample frame is 0.42 - 0.5 * cos(2 * pi * (n + 0.5) / N)
+ * + 0.08 * cos(4 * pi * (n + 0.5) / N). Only the first N/2 values are
+ * stored.
+ *
+ * \param[out] window  Array of N/2 values, each a sign bit and a 31 bit
+ *                     fraction.
+ * \param[in]  N       Number of samples in the frame.
+ */
+void dsp_fft_window_blackman( int32_t window[], const uint32_t N );
+
+/** This function computes the magnitude or power spectrum of N windowed
+ * real samples. It gives the same bins as applying the window, calling
+ * dsp_fft_bit_reverse_and_forward_real() and computing the magnitude or
+ * power of the result, but the window is applied while the samples are
+ * bit reversed, and the spectrum is written while the two halves of the
+ * spectrum are separated, so there is no separate windowing, post
+ * processing or magnitude pass over the data.
+ *
+ * Bin k of the spectrum, for k = 0 .. N/2, is written to spectrum[k]; bins
+ * 0 and N/2 are the DC and Nyquist terms. The contents of pts are
+ * overwritten.
+ *
+ * The array pts must be double word aligned.
+ *
+ * \param[out]    spectrum  Array of N/2+1 magnitudes or powers.
+ * \param[in,out] pts       Array of N real samples, used as scratch.
+ * \param[in]     window    Array of N/2 values, the first half of a symmetric
+ *                          window, for example from dsp_fft_window_hann().
+ *                          Sample n and sample N-1-n are both multiplied by
+ *                          window[n].
+ * \param[in]     N         Number of samples. Must be a power of two, and at
+ *                          least 8.
+ * \param[in]     sine      Sine table for an N/2 point FFT, as for
+ *                          dsp_fft_bit_reverse_and_forward_real().
+ * \param[in]     sin2      Sine table for an N point FFT, as above.
+ * \param[in]     output    Whether magnitudes or powers are written.
+ */
+void dsp_fft_real_spectrum( uint32_t spectrum[], int32_t pts[], const int32_t window[],
+                            const uint32_t N, const int32_t sine[], const int32_t sin2[],
+                            const dsp_fft_spectrum_t output );
+
+/** This function prepares the state of a mixed-radix FFT of N points, where
+ * N is any product of the factors 2, 3 and 5, such as 480, 960 or 1536.
+ *
+ * N is factored into radix 4, 2, 3 and 5 passes, and a table of N twiddle
+ * factors is computed into the state. This uses double precision
+ * arithmetic and is intended to be called once at startup; the state can
+ * then be used for any number of calls to dsp_fft_mixed_forward() and
+ * dsp_fft_mixed_inverse().
+ *
+ * \param[out]    state  State array of length ``DSP_FFT_MIXED_STATE_LENGTH(N)``.
+ * \param[in]     N      Number of points.
+ * \returns              The number of passes, or 0 if N has a prime factor other
+ *                       than 2, 3 or 5, or needs more than DSP_FFT_MIXED_MAX_FACTORS passes.
+ */
+int32_t dsp_fft_mixed_init( int32_t state[], const uint32_t N );
+
+/** This function computes a forward FFT of N points, for N a product of 2, 3
+ * and 5, as set up by dsp_fft_mixed_init().
+ *
+ * The complex input signal is supplied in natural order and the output is
+ * in natural order; no bit reversal is needed. As for dsp_fft_forward(), the
+ * output is scaled by 1/N, each pass dividing by its radix.
+ *
+ * The passes are computed out of place, alternating between ``pts`` and
+ * scratch space in the state, so the state must not be shared between
+ * transforms that run at the same time.
+ *
+ * \param[in,out] pts    Array of N dsp_complex_t elements.
+ * \param[in]     state  State array initialized by dsp_fft_mixed_init().
+ */
+void dsp_fft_mixed_forward( dsp_complex_t pts[], int32_t state[] );
+
+/** This function computes an inverse FFT of N points, for N a product of 2, 3
+ * and 5, as set up by dsp_fft_mixed_init().
+ *
+ * The input and output are in natural order. As for dsp_fft_inverse(), the
+ * output is not scaled, so the input must have enough headroom for a gain
+ * of up to N. The radix 3 and 5 passes saturate on overflow; the radix 2
+ * and 4 passes do not.
+ *
+ * \param[in,out] pts    Array of N dsp_complex_t elements.
+ * \param[in]     state  State array initialized by dsp_fft_mixed_init().
+ */
+void dsp_fft_mixed_inverse( dsp_complex_t pts[], int32_t state[] );
+
+/** This function computes a forward FFT in block floating point. The
+ * complex input signal must be supplied in bit-reversed order, as for
+ * dsp_fft_forward().
+ *
+ * All points share one exponent, which is tracked from pass to pass. A pass
+ * is computed without scaling when the previous pass left enough headroom
+ * for its growth, and otherwise shifts right by only as many bits as are
+ * needed; quiet inputs are normalized up before the first pass. The
+ * headroom is measured as the outputs of each pass are stored, so there is
+ * no separate headroom pass between butterflies. Quiet and loud signals
+ * are therefore transformed with the same relative precision, and the
+ * input needs no headroom.
+ *
+ * The output multiplied by 2 to the power of the returned exponent is the
+ * unscaled DFT of the input. For comparison, the output of
+ * dsp_fft_forward() has an exponent of log2(N).
+ *
+ * \param[in,out] pts   Array of N dsp_complex_t elements.
+ * \param[in]     N     Length of the FFT; a power of two.
+ * \param[in]     sine  Array of N/4+1 sine values, as for dsp_fft_forward().
+ * \returns             The exponent of the output, relative to the input.
+ */
+int32_t dsp_fft_forward_bfp( dsp_complex_t pts[], const uint32_t N, const int32_t sine[] );
+
+/** This function computes an inverse FFT in block floating point. The
+ * complex input signal must be supplied in bit-reversed order, as for
+ * dsp_fft_inverse(), and the pass scaling is as for dsp_fft_forward_bfp().
+ *
+ * The output multiplied by 2 to the power of the returned exponent is the
+ * unscaled inverse DFT of the input; the output of dsp_fft_inverse() has an
+ * exponent of 0. The inverse of dsp_fft_forward_bfp() with exponent e is
+ * recovered by subtracting log2(N) from the sum of e and the returned exponent.
+ *
+ * \param[in,out] pts   Array of N dsp_complex_t elements.
+ * \param[in]     N     Length of the FFT; a power of two.
+ * \param[in]     sine  Array of N/4+1 sine values, as for dsp_fft_forward().
+ * \returns             The exponent of the output, relative to the input.
+ */
+int32_t dsp_fft_inverse_bfp( dsp_complex_t pts[], const uint32_t N, const int32_t sine[] );
+
+#if defined(__XS2A__)
+
+/** This function computes a forward FFT on several logical cores in parallel.
+ *
+ * The input and output are identical in meaning and ordering to those of
+ * dsp_fft_forward(): the input must have been bit reversed with
+ * dsp_fft_bit_reverse(), and the output is in natural order and right
+ * shifted log2(N) times.
+ *
+ * The transform is split into ``num_cores`` FFTs of N/num_cores points on
+ * consecutive blocks of the array, one per logical core, followed by the
+ * final log2(num_cores) passes, which combine points N/num_cores apart and
+ * apply the twiddle factors. These are again divided between the cores, each
+ * core completing a range of columns. The results may differ from those of
+ * dsp_fft_forward() in the least significant bits.
+ *
+ * The cores share the array, so they all run on the tile that the function
+ * is called on; num_cores-1 logical cores must be free on that tile for the
+ * duration of the call.
+ *
+ * \param[in,out] pts       Array of dsp_complex_t elements.
+ * \param[in]     N         Number of points. Must be a power of two. If it is less
+ *                          than num_cores * num_cores, the FFT is computed on the
+ *                          calling core only.
+ * \param[in]     sine      Array of N/4+1 sine values, each represented as a sign bit,
+ *                          and a 31 bit fraction. 1 should be represented as 0x7fffffff.
+ *                          For example, for an 8192 point FFT use dsp_sine_8192.
+ * \param[in]     sub_sine  Array of N/num_cores/4+1 sine values, represented as above.
+ *                          For example, for an 8192 point FFT on 4 cores use dsp_sine_2048.
+ * \param[in]     num_cores Number of logical cores to use: 1, 2, 4 or 8. Any other
+ *                          value computes the FFT on the calling core only.
+ */
+void dsp_fft_forward_parallel (
+    dsp_complex_t pts[],
+    const uint32_t        N,
+    const int32_t         sine[],
+    const int32_t         sub_sine[],
+    const uint32_t        num_cores );
+
+/** This function computes an inverse FFT on several logical cores in parallel.
+ *
+ * The input and output are identical in meaning and ordering to those of
+ * dsp_fft_inverse(), including its input range, and the work is divided
+ * between the cores as described for dsp_fft_forward_parallel().
+ *
+ * \param[in,out] pts       Array of dsp_complex_t elements.
+ * \param[in]     N         Number of points. Must be a power of two. If it is less
+ *                          than num_cores * num_cores, the FFT is computed on the
+ *                          calling core only.
+ * \param[in]     sine      Array of N/4+1 sine values, each represented as a sign bit,
+ *                          and a 31 bit fraction. 1 should be represented as 0x7fffffff.
+ *                          For example, for an 8192 point FFT use dsp_sine_8192.
+ * \param[in]     sub_sine  Array of N/num_cores/4+1 sine values, represented as above.
+ *                          For example, for an 8192 point FFT on 4 cores use dsp_sine_2048.
+ * \param[in]     num_cores Number of logical cores to use: 1, 2, 4 or 8. Any other
+ *                          value computes the FFT on the calling core only.
+ */
+void dsp_fft_inverse_parallel (
+    dsp_complex_t pts[],
+    const uint32_t        N,
+    const int32_t         sine[],
+    const int32_t         sub_sine[],
+    const uint32_t        num_cores );
+
+/** This function computes a forward FFT, performing the bit reversal of
+ * dsp_fft_bit_reverse() in the same sweep over the data as the first two
+ * passes of the transform.
+ *
+ * The input is in natural order and the output is that of
+ * dsp_fft_bit_reverse() followed by dsp_fft_forward(): in natural order and
+ * right shifted log2(N) times. The first two passes need no multiplies, so
+ * each group of 16 points is read once, permuted and transformed, and
+ * written back in place, saving a full pass over memory. The permutation
+ * itself is done in C; the remaining passes always use the assembly radix-4
+ * passes of DSP_FFT_RADIX4, whatever its setting.
+ *
+ * dsp_fft_bit_reverse() is integrated into this function and must not be
+ * called separately.
+ *
+ * The array must be double word aligned.
+ *
+ * \param[in,out] pts   Array of dsp_complex_t elements.
+ * \param[in]     N     Number of points. Must be a power of two, at least 4.
+ * \param[in]     sine  Array of N/4+1 sine values, each represented as a sign bit,
+ *                      and a 31 bit fraction. 1 should be represented as 0x7fffffff.
+ *                      For example, for a 1024 point FFT use dsp_sine_1024.
+ */
+void dsp_fft_bit_reverse_and_forward (
+    dsp_complex_t pts[],
+    const uint32_t        N,
+    const int32_t         sine[] );
+
+/** This function computes an inverse FFT, performing the bit reversal of
+ * dsp_fft_bit_reverse() in the same sweep over the data as the first two
+ * passes of the transform.
+ *
+ * The input is in natural order and the output is that of
+ * dsp_fft_bit_reverse() followed by dsp_fft_inverse(), with the same input
+ * range. The passes are arranged as for dsp_fft_bit_reverse_and_forward().
+ *
+ * dsp_fft_bit_reverse() is integrated into this function and must not be
+ * called separately.
+ *
+ * The array must be double word aligned.
+ *
+ * \param[in,out] pts   Array of dsp_complex_t elements.
+ * \param[in]     N     Number of points. Must be a power of two, at least 4.
+ * \param[in]     sine  Array of N/4+1 sine values, as for dsp_fft_bit_reverse_and_forward().
+ */
+void dsp_fft_bit_reverse_and_inverse (
+    dsp_complex_t pts[],
+    const uint32_t        N,
+    const int32_t         sine[] );
+
+/** This function computes forward FFTs of a batch of complex signals.
+ *
+ * The signals are stored one after the other, so that ``pts`` can be viewed
+ * as an array ``dsp_complex_t [n_signals][N]``; signal S occupies elements
+ * S*N to S*N+N-1. Each signal is transformed in place exactly as by
+ * dsp_fft_bit_reverse() followed by dsp_fft_forward(): output is in natural
+ * order and right shifted log2(N) times.
+ *
+ * dsp_fft_bit_reverse() is integrated into this function and must not be
+ * called separately.
+ *
+ * The passes are interleaved across the signals: each twiddle factor is
+ * loaded once per pass and used for the butterflies of all signals, and the
+ * loop setup is shared, rather than repeated for every signal.
+ *
+ * The array must be double word aligned.
+ *
+ * \param[in,out] pts       Array of n_signals*N dsp_complex_t elements.
+ * \param[in]     n_signals Number of signals in the batch.
+ * \param[in]     N         Number of points in each signal. Must be a power of two.
+ * \param[in]     sine      Array of N/4+1 sine values, each represented as a sign bit,
+ *                          and a 31 bit fraction. 1 should be represented as 0x7fffffff.
+ *                          For example, for 256 point FFTs use dsp_sine_256.
+ */
+void dsp_fft_forward_batch (
+    dsp_complex_t pts[],
+    const uint32_t        n_signals,
+    const uint32_t        N,
+    const int32_t         sine[] );
+
+/** This function computes inverse FFTs of a batch of complex signals.
+ *
+ * The layout of ``pts`` is as for dsp_fft_forward_batch(). Each signal is
+ * transformed in place exactly as by dsp_fft_bit_reverse() followed by
+ * dsp_fft_inverse(), with the same input range.
+ *
+ * dsp_fft_bit_reverse() is integrated into this function and must not be
+ * called separately.
+ *
+ * The array must be double word aligned.
+ *
+ * \param[in,out] pts       Array of n_signals*N dsp_complex_t elements.
+ * \param[in]     n_signals Number of signals in the batch.
+ * \param[in]     N         Number of points in each signal. Must be a power of two.
+ * \param[in]     sine      Array of N/4+1 sine values, as for dsp_fft_forward_batch().
+ */
+void dsp_fft_inverse_batch (
+    dsp_complex_t pts[],
+    const uint32_t        n_signals,
+    const uint32_t        N,
+    const int32_t         sine[] );
+
+/** This function computes forward FFTs of a batch of real signals, two per
+ * complex FFT.
+ *
+ * Signals 2*A and 2*A+1 are packed into the real and imaginary parts of
+ * array A of ``pts``, viewed as ``dsp_complex_t [(n_signals+1)/2][N]``. The
+ * arrays are transformed with dsp_fft_forward_batch() and each is then
+ * split with dsp_fft_split_spectrum(), so that on output ``pts`` can be
+ * viewed as ``dsp_complex_t [n_signals][N/2]`` half-spectra, one per real
+ * signal, in the format described for dsp_fft_split_spectrum().
+ *
+ * If n_signals is odd the imaginary parts of the last array must be zero on
+ * input; the half-spectrum following the last signal is then zero.
+ *
+ * dsp_fft_bit_reverse() is integrated into this function and must not be
+ * called separately.
+ *
+ * The array must be double word aligned.
+ *
+ * \param[in,out] pts       Array of (n_signals+1)/2*N dsp_complex_t elements.
+ * \param[in]     n_signals Number of real signals in the batch.
+ * \param[in]     N         Number of points in each real signal. Must be a power of two.
+ * \param[in]     sine      Array of N/4+1 sine values, as for dsp_fft_forward_batch().
+ */
+void dsp_fft_forward_tworeals_batch (
+    dsp_complex_t pts[],
+    const uint32_t        n_signals,
+    const uint32_t        N,
+    const int32_t         sine[] );
+
+/** This function computes inverse FFTs of a batch of real signals, two per
+ * complex FFT. It is the inverse of dsp_fft_forward_tworeals_batch(): the
+ * half-spectra are merged with dsp_fft_merge_spectra() and the arrays are
+ * transformed with dsp_fft_inverse_batch(), leaving signals 2*A and 2*A+1 in
+ * the real and imaginary parts of array A.
+ *
+ * The array must be double word aligned.
+ *
+ * \param[in,out] pts       Array of (n_signals+1)/2*N dsp_complex_t elements.
+ * \param[in]     n_signals Number of real signals in the batch.
+ * \param[in]     N         Number of points in each real signal. Must be a power of two.
+ * \param[in]     sine      Array of N/4+1 sine values, as for dsp_fft_forward_batch().
+ */
+void dsp_fft_inverse_tworeals_batch (
+    dsp_complex_t pts[],
+    const uint32_t        n_signals,
+    const uint32_t        N,
+    const int32_t         sine[] );
+
+#ifdef __XC__
+#define UNSAFE unsafe
+#else
+#define UNSAFE
+#endif //__XC_
+
+// Length of the twiddle array of dsp_fft_plan_init, for an N point transform
+#define DSP_FFT_PLAN_TWIDDLES_LENGTH(N) ((N) - 1)
+
+// Length of the twiddle array of dsp_fft_plan_init_real, for N real samples
+#define DSP_FFT_PLAN_REAL_TWIDDLES_LENGTH(N) ((N)/2 - 1 + (N)/4)
+
+/** Type that holds a plan for FFTs of one length, set up by
+ * dsp_fft_plan_init() or dsp_fft_plan_init_real(). The twiddle factors are
+ * held in an array supplied by the caller, which must stay allocated for
+ * as long as the plan is used; one plan can be shared by any number of
+ * transforms, on any core.
+ */
+typedef struct {
+    uint32_t N;                            // Number of complex points
+    const dsp_complex_t * UNSAFE twiddles; // Twiddle factors in pass order
+} dsp_fft_plan_t;
+
+/** This function prepares a plan for complex FFTs of N points.
+ *
+ * The N-1 twiddle factors of all passes are computed from the sine table
+ * and stored in ``twiddles`` in the order in which the passes use them, so
+ * that dsp_fft_plan_forward() and dsp_fft_plan_inverse() read them
+ * sequentially, one double word per twiddle, instead of indexing the
+ * quarter wave table with a stride and mirroring it for the cosine.
+ *
+ * \param[out] plan      Plan to initialize.
+ * \param[out] twiddles  Array of ``DSP_FFT_PLAN_TWIDDLES_LENGTH(N)`` elements,
+ *                       double word aligned.
+ * \param[in]  N         Number of points. Must be a power of two.
+ * \param[in]  sine      Array of N/4+1 sine values, as for dsp_fft_forward().
+ */
+void dsp_fft_plan_init( REFERENCE_PARAM(dsp_fft_plan_t, plan), dsp_complex_t twiddles[],
+                        const uint32_t N, const int32_t sine[] );
+
+/** This function prepares a plan for FFTs of N real samples, as for
+ * dsp_fft_bit_reverse_and_forward_real(). The plan also holds the twiddle
+ * factors of the N/2 point complex FFT, so it can be used with
+ * dsp_fft_plan_forward() and dsp_fft_plan_inverse() for N/2 points.
+ *
+ * \param[out] plan      Plan to initialize.
+ * \param[out] twiddles  Array of ``DSP_FFT_PLAN_REAL_TWIDDLES_LENGTH(N)``
+ *                       elements, double word aligned.
+ * \param[in]  N         Number of real samples. Must be a power of two.
+ * \param[in]  sine      Sine table for an N/2 point FFT, for example
+ *                       dsp_sine_256 for N = 512.
+ * \param[in]  sin2      Sine table for an N point FFT, for example dsp_sine_512.
+ */
+void dsp_fft_plan_init_real( REFERENCE_PARAM(dsp_fft_plan_t, plan), dsp_complex_t twiddles[],
+                             const uint32_t N, const int32_t sine[], const int32_t sin2[] );
+
+/** This function computes a forward FFT with a plan. The input must be bit
+ * reversed, and the output is the same as that of dsp_fft_forward() with
+ * DSP_FFT_RADIX4 set to 0, right shifted log2(N) times. The passes are
+ * those of dsp_fft_forward(), with each twiddle loaded from the plan
+ * instead of from the sine table.
+ *
+ * \param[in,out] pts   Array of N dsp_complex_t elements, double word aligned.
+ * \param[in]     plan  Plan for N points.
+ */
+void dsp_fft_plan_forward( dsp_complex_t pts[], REFERENCE_PARAM(const dsp_fft_plan_t, plan) );
+
+/** This function computes an inverse FFT with a plan. The input must be bit
+ * reversed, and the output is the same as that of dsp_fft_inverse() with
+ * DSP_FFT_RADIX4 set to 0, unscaled.
+ *
+ * \param[in,out] pts   Array of N dsp_complex_t elements, double word aligned.
+ * \param[in]     plan  Plan for N points.
+ */
+void dsp_fft_plan_inverse( dsp_complex_t pts[], REFERENCE_PARAM(const dsp_fft_plan_t, plan) );
+
+/** This function computes the FFT of N real samples with a plan, with the
+ * same input and output as dsp_fft_bit_reverse_and_forward_real().
+ *
+ * \param[in,out] pts   Array of N integers, double word aligned.
+ * \param[in]     plan  Plan set up by dsp_fft_plan_init_real() for N samples.
+ */
+void dsp_fft_plan_forward_real( int32_t pts[], REFERENCE_PARAM(const dsp_fft_plan_t, plan) );
+
+/** This function computes the inverse FFT of N real samples with a plan,
+ * with the same input and output as dsp_fft_bit_reverse_and_inverse_real().
+ *
+ * \param[in,out] pts   Array of N integers, double word aligned.
+ * \param[in]     plan  Plan set up by dsp_fft_plan_init_real() for N samples.
+ */
+void dsp_fft_plan_inverse_real( int32_t pts[], REFERENCE_PARAM(const dsp_fft_plan_t, plan) );
+
+#endif
+
 #endif
 
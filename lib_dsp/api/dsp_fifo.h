@@ -0,0 +1,119 @@
+// Copyright (c) 2017, XMOS Ltd, All rights reserved
+
+#ifndef DSP_FIFO_H_
+#define DSP_FIFO_H_
+
+#include <stdint.h>
+
+/* Single producer, single consumer FIFO of fixed size blocks, for passing
+ * samples or spectra between logical cores on the same tile. The FIFO is
+ * held in a state array in shared memory; the producer only advances the
+ * write position and the consumer only advances the read position, so no
+ * lock is needed and no call ever waits.
+ *
+ * Blocks are filled and consumed in place: dsp_fifo_write_reserve() gives
+ * the offset in the state array of the next free block, which is handed
+ * to the consumer by dsp_fifo_write_commit(); dsp_fifo_read_acquire()
+ * gives the offset of the oldest block, which is returned to the producer
+ * by dsp_fifo_read_release(). A stage of a pipeline can thus run a library
+ * function, for example dsp_filters_fir_block(), from a block of its input
+ * FIFO straight into a block of its output FIFO.
+ *
+ * From xC, the state array is shared between tasks through an unsafe
+ * pointer, for example:
+ *
+ *   int32_t fifo[DSP_FIFO_STATE_LENGTH(64, 4)];
+ *
+ *   dsp_fifo_init(fifo, 64, 4);
+ *   unsafe {
+ *     int32_t * unsafe p = fifo;
+ *     par {
+ *       producer(p);
+ *       consumer(p);
+ *     }
+ *   }
+ */
+
+// State length for dsp_fifo_init(), for depth blocks of block_length words
+#define DSP_FIFO_STATE_LENGTH(block_length, depth) (4 + (block_length) * (depth))
+
+/* State length in dsp_complex_t elements, for depth blocks of block_length
+ * complex values. Declaring the state as an array of dsp_complex_t keeps
+ * each block double word aligned; it is initialized with a block_length of
+ * 2 * block_length words.
+ */
+#define DSP_FIFO_COMPLEX_STATE_LENGTH(block_length, depth) (2 + (block_length) * (depth))
+
+/** This function initializes an empty FIFO of depth blocks, each of
+ *  block_length words. It must be called before the producer and the
+ *  consumer start.
+ *
+ *  \param  fifo          State array of length
+ *                        ``DSP_FIFO_STATE_LENGTH(block_length, depth)``.
+ *  \param  block_length  Number of words in a block.
+ *  \param  depth         Number of blocks, at least 1.
+ */
+void dsp_fifo_init( int32_t fifo[], const uint32_t block_length, const uint32_t depth );
+
+/** This function returns the number of blocks committed by the producer
+ *  and not yet released by the consumer. It may be called from either
+ *  side.
+ *
+ *  \param  fifo  State array initialized by dsp_fifo_init().
+ *  \returns      Number of blocks in the FIFO, between 0 and depth.
+ */
+uint32_t dsp_fifo_level( const int32_t fifo[] );
+
+/** This function gives the producer the next free block. The block may
+ *  be written until dsp_fifo_write_commit() is called; calling this
+ *  function again before then gives the same block.
+ *
+ *  \param  fifo  State array initialized by dsp_fifo_init().
+ *  \returns      Offset of the block in ``fifo``, or -1 if the FIFO is full.
+ */
+int32_t dsp_fifo_write_reserve( const int32_t fifo[] );
+
+/** This function passes the block given by dsp_fifo_write_reserve() to
+ *  the consumer. All writes to the block are complete before the consumer
+ *  can see it.
+ *
+ *  \param  fifo  State array initialized by dsp_fifo_init().
+ */
+void dsp_fifo_write_commit( int32_t fifo[] );
+
+/** This function gives the consumer the oldest committed block. The block
+ *  may be read, or modified in place, until dsp_fifo_read_release() is
+ *  called.
+ *
+ *  \param  fifo  State array initialized by dsp_fifo_init().
+ *  \returns      Offset of the block in ``fifo``, or -1 if the FIFO is
+ *                empty.
+ */
+int32_t dsp_fifo_read_acquire( const int32_t fifo[] );
+
+/** This function returns the block given by dsp_fifo_read_acquire() to the
+ *  producer.
+ *
+ *  \param  fifo  State array initialized by dsp_fifo_init().
+ */
+void dsp_fifo_read_release( int32_t fifo[] );
+
+/** This function copies a block into the FIFO, as
+ *  dsp_fifo_write_reserve() and dsp_fifo_write_commit().
+ *
+ *  \param  fifo   State array initialized by dsp_fifo_init().
+ *  \param  block  Array of block_length words.
+ *  \returns       1 if the block was written, 0 if the FIFO is full.
+ */
+int32_t dsp_fifo_write( int32_t fifo[], const int32_t block[] );
+
+/** This function copies the oldest block out of the FIFO, as
+ *  dsp_fifo_read_acquire() and dsp_fifo_read_release().
+ *
+ *  \param  fifo   State array initialized by dsp_fifo_init().
+ *  \param  block  Array of block_length words.
+ *  \returns       1 if a block was read, 0 if the FIFO is empty.
+ */
+int32_t dsp_fifo_read( int32_t fifo[], int32_t block[] );
+
+#endif
@@ -9,6 +9,28 @@
 #define DSP_NUM_COEFFS_PER_BIQUAD 5  // Number of coefficients per biquad
 #define DSP_NUM_STATES_PER_BIQUAD 4  // Number of state values per biquad
 
+#define DSP_FILTERS_FIR_BLOCK_STATE_LENGTH(num_taps) (2*(num_taps)+2)  // State length for dsp_filters_fir_block
+
+// Polyphase resampler sizes, for a prototype filter of num_taps taps and an interpolation factor L
+#define DSP_FILTERS_RESAMPLER_TAPS_PER_PHASE(num_taps,L) (((((num_taps)+(L)-1)/(L))+1)&~1)
+#define DSP_FILTERS_RESAMPLER_COEFFS_LENGTH(num_taps,L)  ((L)*DSP_FILTERS_RESAMPLER_TAPS_PER_PHASE(num_taps,L))
+#define DSP_FILTERS_RESAMPLER_STATE_LENGTH(num_taps,L)   (2*DSP_FILTERS_RESAMPLER_TAPS_PER_PHASE(num_taps,L)+2)
+
+// Symmetric and sparse FIR sizes, for a filter of num_taps taps and an interpolation factor L
+#define DSP_FILTERS_FIR_SYMMETRIC_COEFFS_LENGTH(num_taps) (((num_taps)+1)/2)
+#define DSP_FILTERS_FIR_SPARSE_COEFFS_LENGTH(num_taps)    (2*(num_taps)+4)
+#define DSP_FILTERS_INTERPOLATE_STATE_LENGTH(num_taps,L)  DSP_FILTERS_FIR_BLOCK_STATE_LENGTH(((num_taps)+(L)-1)/(L))
+#define DSP_FILTERS_INTERPOLATE_SYMMETRIC_COEFFS_LENGTH(num_taps,L) \
+    (((L)/2)*((((num_taps)/(L))+1)&~1) + ((L)&1)*(((((num_taps)/(L))+1)/2+1)&~1))
+#define DSP_FILTERS_INTERPOLATE_SPARSE_COEFFS_LENGTH(num_taps,L) \
+    ((L)*(2*(((num_taps)+(L)-1)/(L))+4))
+
+// Partitioned FFT convolution sizes, for a filter of num_taps taps processed in blocks of B samples
+#define DSP_FILTERS_FFT_CONVOLUTION_PARTITIONS(num_taps,B)   (((num_taps)+(B)-1)/(B))
+#define DSP_FILTERS_FFT_CONVOLUTION_STATE_LENGTH(num_taps,B) \
+    (2 + ((DSP_FILTERS_FFT_CONVOLUTION_PARTITIONS(num_taps,B)+1)&~1) + \
+     4*(B)*DSP_FILTERS_FFT_CONVOLUTION_PARTITIONS(num_taps,B) + 5*(B))
+
 /** This function implements a Finite Impulse Response (FIR) filter.
  *
  *  The function operates on a single sample of input and output data (i.e.
@@ -60,6 +82,58 @@ int32_t dsp_filters_fir
     const int32_t q_format
 );
 
+/** This function implements a Finite Impulse Response (FIR) filter on a block
+ *  of samples.
+ *
+ *  The function operates on ``num_samples`` samples of input and output data
+ *  per call. The results are bit-exact with calling dsp_filters_fir() once for
+ *  every input sample, but the state is kept in a double-length history
+ *  buffer (every sample is stored twice, ``num_taps`` words apart), so the
+ *  state data is not shifted for every sample. Each new sample costs two
+ *  stores instead of ``num_taps`` stores.
+ *
+ *  The state array has a different layout from the one used by
+ *  dsp_filters_fir() and the two must not be mixed on the same state array.
+ *  Both ``filter_coeffs`` and ``state_data`` must be double word aligned.
+ *
+ *  The following example filters a block of 32 samples with a 256-tap filter
+ *  with samples and coefficients represented in Q28 fixed-point format.
+ *  \code
+ *  int32_t filter_coeff[256] = { ... not shown for brevity };
+ *  int32_t filter_state[DSP_FILTERS_FIR_BLOCK_STATE_LENGTH(256)] = { 0 };
+ *  dsp_filters_fir_block( input, output, 32, filter_coeff, filter_state, 256, 28 );
+ *  \endcode
+ *
+ *  Multiplication results are accumulated in a 64-bit accumulator.
+ *  If overflow occurs in the final 64-bit result, it is saturated at the minimum/maximum value
+ *  given the fixed-point format and finally shifted right by ``q_format`` bits.
+ *  The saturation is only done after the last multiplication.
+ *  To avoid 64-bit overflow in the intermediate results, the fixed point format must be chosen
+ *  according to num_taps.
+ *
+ *  \param  input_samples   Array of ``num_samples`` samples to be processed.
+ *  \param  output_samples  Array of ``num_samples`` resulting filter output samples.
+ *  \param  num_samples     Number of samples to process.
+ *  \param  filter_coeffs   Pointer to FIR coefficients array arranged
+ *                          as ``[b0,b1,b2,...,bN-1]``.
+ *  \param  state_data      Pointer to filter state data array of length
+ *                          ``DSP_FILTERS_FIR_BLOCK_STATE_LENGTH(N)``.
+ *                          Must be initialized at startup to all zeros.
+ *  \param  num_taps        Number of filter taps (N = ``num_taps`` = filter order + 1).
+ *  \param  q_format        Fixed point format (i.e. number of fractional bits).
+ */
+
+void dsp_filters_fir_block
+(
+    const int32_t input_samples[],
+    int32_t       output_samples[],
+    const int32_t num_samples,
+    const int32_t filter_coeffs[],
+    int32_t       state_data[],
+    const int32_t num_taps,
+    const int32_t q_format
+);
+
 /** This function pushes samples into an Finite Impulse Response (FIR) filter
  *  state array, without processing the filter.
  *
@@ -167,7 +241,9 @@ void dsp_filters_interpolate
  *  according to num_taps.
  *
  *
- *  \param  input_samples  The new samples to be decimated.
+ *  \param  input_samples  The new samples to be decimated. The output is
+ *                         computed for ``input_samples[0]``; the others are
+ *                         kept, newest first, as history for the next call.
  *  \param  filter_coeffs  Pointer to FIR coefficients array arranged
  *                         as ``[b0,b1,b2,...,bN-1]``.
  *  \param  state_data     Pointer to filter state data array of length N-1.
@@ -188,6 +264,388 @@ int32_t dsp_filters_decimate
     const int32_t q_format
 );
 
+/** This function implements a linear phase FIR filter with symmetric
+ *  coefficients on a block of samples.
+ *
+ *  The coefficients of a linear phase filter are symmetric, ``b[k] =
+ *  b[N-1-k]``, so only the first half of them is stored, and each pair of
+ *  samples that share a coefficient is added before it is multiplied:
+ *  ``y[n] = b0*(x[n]+x[n-N+1]) + b1*(x[n-1]+x[n-N+2]) + ...``. This halves
+ *  the number of multiply-accumulates and coefficient loads per sample.
+ *  Both odd (type I, with a middle tap) and even (type II) lengths are
+ *  supported.
+ *
+ *  A pair sum that overflows 32 bits is corrected in the 64-bit accumulator,
+ *  so the input samples may use the full scale, and the results are
+ *  bit-exact with calling dsp_filters_fir() with all ``num_taps``
+ *  coefficients for every input sample, with the same q_format and
+ *  saturation behaviour.
+ *
+ *  The state array has the layout used by dsp_filters_fir_block() and is
+ *  not shifted for every sample. ``filter_coeffs`` must be double word
+ *  aligned.
+ *
+ *  The following example filters a block of 32 samples with a 63-tap
+ *  filter with samples and coefficients represented in Q28 fixed-point
+ *  format.
+ *  \code
+ *  int32_t filter_coeff[DSP_FILTERS_FIR_SYMMETRIC_COEFFS_LENGTH(63)] = { ... not shown for brevity };
+ *  int32_t filter_state[DSP_FILTERS_FIR_BLOCK_STATE_LENGTH(63)] = { 0 };
+ *  dsp_filters_fir_symmetric_block( input, output, 32, filter_coeff, filter_state, 63, 28 );
+ *  \endcode
+ *
+ *  \param  input_samples   Array of ``num_samples`` samples to be processed.
+ *  \param  output_samples  Array of ``num_samples`` resulting filter output samples.
+ *  \param  num_samples     Number of samples to process.
+ *  \param  filter_coeffs   Pointer to the first half of the FIR coefficients,
+ *                          arranged as ``[b0,b1,...,b((N-1)/2)]``.
+ *  \param  state_data      Pointer to filter state data array of length
+ *                          ``DSP_FILTERS_FIR_BLOCK_STATE_LENGTH(num_taps)``.
+ *                          Must be initialized at startup to all zeros.
+ *  \param  num_taps        Number of filter taps (N = ``num_taps`` = filter order + 1).
+ *  \param  q_format        Fixed point format (i.e. number of fractional bits).
+ */
+
+void dsp_filters_fir_symmetric_block
+(
+    const int32_t input_samples[],
+    int32_t       output_samples[],
+    const int32_t num_samples,
+    const int32_t filter_coeffs[],
+    int32_t       state_data[],
+    const int32_t num_taps,
+    const int32_t q_format
+);
+
+/** This function implements a decimating linear phase FIR filter with
+ *  symmetric coefficients.
+ *
+ *  Each call takes ``decim_factor`` samples in the order used by
+ *  dsp_filters_decimate(): the filter output is computed for
+ *  ``input_samples[0]``, and the other samples are kept, newest first, as
+ *  history for the next call. The filter is only evaluated once per output
+ *  sample, as in dsp_filters_fir_symmetric_block(), and the result is
+ *  bit-exact with dsp_filters_decimate() given all ``num_taps``
+ *  coefficients.
+ *
+ *  \param  input_samples  The ``decim_factor`` new samples to be decimated.
+ *  \param  filter_coeffs  Pointer to the first half of the FIR coefficients,
+ *                         arranged as ``[b0,b1,...,b((N-1)/2)]``. Must be double word aligned.
+ *  \param  state_data     Pointer to filter state data array of length
+ *                         ``DSP_FILTERS_FIR_BLOCK_STATE_LENGTH(num_taps)``.
+ *                         Must be initialized at startup to all zeros.
+ *  \param  num_taps       Number of filter taps (N = num_taps = filter order + 1).
+ *  \param  decim_factor   The decimation factor/index (i.e. the down-sampling ratio).
+ *  \param  q_format       Fixed point format (i.e. number of fractional bits).
+ *  \returns               The resulting decimated sample.
+ */
+
+int32_t dsp_filters_decimate_symmetric
+(
+    const int32_t input_samples[],
+    const int32_t filter_coeffs[],
+    int32_t       state_data[],
+    const int32_t num_taps,
+    const int32_t decim_factor,
+    const int32_t q_format
+);
+
+/** This function arranges the coefficients of a symmetric FIR filter for
+ *  dsp_filters_interpolate_symmetric().
+ *
+ *  Phase ``p`` of an interpolator holds the coefficients ``b[kL+p]``. For a
+ *  symmetric filter whose length is a multiple of the interpolation factor,
+ *  phase ``L-1-p`` holds the same coefficients as phase ``p`` in reverse
+ *  order, and the middle phase of an odd factor is itself symmetric, so
+ *  only half of the polyphase coefficients are stored.
+ *
+ *  \param  filter_coeffs     Pointer to the first half of the FIR coefficients,
+ *                            arranged as ``[b0,b1,...,b((N-1)/2)]``.
+ *  \param  num_taps          Number of filter taps, a multiple of ``interp_factor``.
+ *  \param  interp_factor     The interpolation factor (i.e. the up-sampling ratio).
+ *  \param  polyphase_coeffs  Array of length
+ *                            ``DSP_FILTERS_INTERPOLATE_SYMMETRIC_COEFFS_LENGTH(num_taps, interp_factor)``
+ *                            that receives the polyphase coefficients.
+ *                            Must be double word aligned.
+ */
+
+void dsp_filters_interpolate_symmetric_init
+(
+    const int32_t filter_coeffs[],
+    const int32_t num_taps,
+    const int32_t interp_factor,
+    int32_t       polyphase_coeffs[]
+);
+
+/** This function implements an interpolating linear phase FIR filter with
+ *  symmetric coefficients.
+ *
+ *  Each call takes one input sample and produces ``interp_factor`` output
+ *  samples, oldest first, bit-exact with dsp_filters_fir() on the input
+ *  up-sampled with zeros. The two phases that share coefficients in
+ *  reverse order are computed in one pass, so each coefficient is loaded
+ *  once for both, and the middle phase of an odd factor adds sample pairs
+ *  as in dsp_filters_fir_symmetric_block().
+ *
+ *  \param  input_sample      The new sample to be processed.
+ *  \param  polyphase_coeffs  Coefficients arranged by dsp_filters_interpolate_symmetric_init().
+ *  \param  state_data        Pointer to filter state data array of length
+ *                            ``DSP_FILTERS_INTERPOLATE_STATE_LENGTH(num_taps, interp_factor)``.
+ *                            Must be initialized at startup to all zeros.
+ *  \param  num_taps          Number of filter taps, a multiple of ``interp_factor``.
+ *  \param  interp_factor     The interpolation factor (i.e. the up-sampling ratio).
+ *  \param  output_samples    The resulting ``interp_factor`` interpolated samples.
+ *  \param  q_format          Fixed point format (i.e. number of fractional bits).
+ */
+
+void dsp_filters_interpolate_symmetric
+(
+    int32_t       input_sample,
+    const int32_t polyphase_coeffs[],
+    int32_t       state_data[],
+    const int32_t num_taps,
+    const int32_t interp_factor,
+    int32_t       output_samples[],
+    const int32_t q_format
+);
+
+/** This function converts the coefficients of a FIR filter with runs of
+ *  zero taps into the sparse form used by dsp_filters_fir_sparse_block()
+ *  and dsp_filters_decimate_sparse().
+ *
+ *  The non-zero taps are grouped into segments, each stored as its first
+ *  tap, its length and its coefficients. A run of zeros shorter than
+ *  ``min_zero_run`` is kept inside a segment, because starting a new
+ *  segment costs about as much as a few multiply-accumulates.
+ *
+ *  \param  filter_coeffs   Pointer to FIR coefficients array arranged
+ *                          as ``[b0,b1,b2,...,bN-1]``.
+ *  \param  num_taps        Number of filter taps.
+ *  \param  min_zero_run    Shortest run of zeros that ends a segment, at least 1.
+ *  \param  sparse_coeffs   Array of length ``DSP_FILTERS_FIR_SPARSE_COEFFS_LENGTH(num_taps)``
+ *                          that receives the sparse coefficients. Must be double word aligned.
+ *  \returns                Number of words of ``sparse_coeffs`` used.
+ */
+
+int32_t dsp_filters_fir_sparse_init
+(
+    const int32_t filter_coeffs[],
+    const int32_t num_taps,
+    const int32_t min_zero_run,
+    int32_t       sparse_coeffs[]
+);
+
+/** This function implements a FIR filter with sparse coefficients on a
+ *  block of samples.
+ *
+ *  Only the segments of non-zero taps built by dsp_filters_fir_sparse_init()
+ *  are multiplied. The results are bit-exact with calling dsp_filters_fir()
+ *  with all ``num_taps`` coefficients for every input sample, and have the
+ *  same q_format and saturation behaviour. The state array has the layout
+ *  used by dsp_filters_fir_block().
+ *
+ *  \param  input_samples   Array of ``num_samples`` samples to be processed.
+ *  \param  output_samples  Array of ``num_samples`` resulting filter output samples.
+ *  \param  num_samples     Number of samples to process.
+ *  \param  sparse_coeffs   Coefficients built by dsp_filters_fir_sparse_init().
+ *  \param  state_data      Pointer to filter state data array of length
+ *                          ``DSP_FILTERS_FIR_BLOCK_STATE_LENGTH(num_taps)``.
+ *                          Must be initialized at startup to all zeros.
+ *  \param  num_taps        Number of filter taps (N = ``num_taps`` = filter order + 1).
+ *  \param  q_format        Fixed point format (i.e. number of fractional bits).
+ */
+
+void dsp_filters_fir_sparse_block
+(
+    const int32_t input_samples[],
+    int32_t       output_samples[],
+    const int32_t num_samples,
+    const int32_t sparse_coeffs[],
+    int32_t       state_data[],
+    const int32_t num_taps,
+    const int32_t q_format
+);
+
+/** This function implements a decimating FIR filter with sparse
+ *  coefficients.
+ *
+ *  Each call takes ``decim_factor`` samples in the order used by
+ *  dsp_filters_decimate(), and returns the filter output for
+ *  ``input_samples[0]``, computed as in dsp_filters_fir_sparse_block(). The
+ *  result is bit-exact with dsp_filters_decimate() given all ``num_taps``
+ *  coefficients.
+ *
+ *  \param  input_samples  The ``decim_factor`` new samples to be decimated.
+ *  \param  sparse_coeffs  Coefficients built by dsp_filters_fir_sparse_init().
+ *  \param  state_data     Pointer to filter state data array of length
+ *                         ``DSP_FILTERS_FIR_BLOCK_STATE_LENGTH(num_taps)``.
+ *                         Must be initialized at startup to all zeros.
+ *  \param  num_taps       Number of filter taps (N = num_taps = filter order + 1).
+ *  \param  decim_factor   The decimation factor/index (i.e. the down-sampling ratio).
+ *  \param  q_format       Fixed point format (i.e. number of fractional bits).
+ *  \returns               The resulting decimated sample.
+ */
+
+int32_t dsp_filters_decimate_sparse
+(
+    const int32_t input_samples[],
+    const int32_t sparse_coeffs[],
+    int32_t       state_data[],
+    const int32_t num_taps,
+    const int32_t decim_factor,
+    const int32_t q_format
+);
+
+/** This function converts the coefficients of a FIR filter with runs of
+ *  zero taps into the sparse polyphase form used by
+ *  dsp_filters_interpolate_sparse().
+ *
+ *  Phase ``p`` holds the coefficients ``b[kL+p]``, and each phase is stored
+ *  as by dsp_filters_fir_sparse_init().
+ *
+ *  \param  filter_coeffs   Pointer to FIR coefficients array arranged
+ *                          as ``[b0,b1,b2,...,bN-1]``.
+ *  \param  num_taps        Number of filter taps.
+ *  \param  interp_factor   The interpolation factor (i.e. the up-sampling ratio).
+ *  \param  min_zero_run    Shortest run of zeros in a phase that ends a segment, at least 1.
+ *  \param  sparse_coeffs   Array of length
+ *                          ``DSP_FILTERS_INTERPOLATE_SPARSE_COEFFS_LENGTH(num_taps, interp_factor)``
+ *                          that receives the sparse coefficients. Must be double word aligned.
+ *  \returns                Number of words of ``sparse_coeffs`` used.
+ */
+
+int32_t dsp_filters_interpolate_sparse_init
+(
+    const int32_t filter_coeffs[],
+    const int32_t num_taps,
+    const int32_t interp_factor,
+    const int32_t min_zero_run,
+    int32_t       sparse_coeffs[]
+);
+
+/** This function implements an interpolating FIR filter with sparse
+ *  coefficients.
+ *
+ *  Each call takes one input sample and produces ``interp_factor`` output
+ *  samples, oldest first, bit-exact with dsp_filters_fir() on the input
+ *  up-sampled with zeros. Only the non-zero segments of each phase are
+ *  multiplied.
+ *
+ *  \param  input_sample    The new sample to be processed.
+ *  \param  sparse_coeffs   Coefficients built by dsp_filters_interpolate_sparse_init().
+ *  \param  state_data      Pointer to filter state data array of length
+ *                          ``DSP_FILTERS_INTERPOLATE_STATE_LENGTH(num_taps, interp_factor)``.
+ *                          Must be initialized at startup to all zeros.
+ *  \param  num_taps        Number of filter taps.
+ *  \param  interp_factor   The interpolation factor (i.e. the up-sampling ratio).
+ *  \param  output_samples  The resulting ``interp_factor`` interpolated samples.
+ *  \param  q_format        Fixed point format (i.e. number of fractional bits).
+ */
+
+void dsp_filters_interpolate_sparse
+(
+    int32_t       input_sample,
+    const int32_t sparse_coeffs[],
+    int32_t       state_data[],
+    const int32_t num_taps,
+    const int32_t interp_factor,
+    int32_t       output_samples[],
+    const int32_t q_format
+);
+
+/** This function initializes a rational polyphase resampler.
+ *
+ *  A resampler changes the sample rate by a rational factor L/M, by
+ *  conceptually up-sampling by ``interp_factor`` (L), filtering at the
+ *  up-sampled rate with a prototype low-pass FIR filter, and down-sampling by
+ *  ``decim_factor`` (M). For example, 44.1 kHz to 48 kHz conversion uses
+ *  L = 160 and M = 147.
+ *
+ *  This function splits the prototype filter into L polyphase sub-filters of
+ *  ``DSP_FILTERS_RESAMPLER_TAPS_PER_PHASE(N,L)`` taps each (padded with zeros
+ *  to an even count), so that callers do not have to rearrange the
+ *  coefficients by hand. It also clears the state. It is called once, before
+ *  the first call to dsp_filters_resampler().
+ *
+ *  \code
+ *  int32_t proto[480] = { ... not shown for brevity };
+ *  int32_t poly[DSP_FILTERS_RESAMPLER_COEFFS_LENGTH(480,160)];
+ *  int32_t state[DSP_FILTERS_RESAMPLER_STATE_LENGTH(480,160)];
+ *  dsp_filters_resampler_init( proto, 480, 160, poly, state );
+ *  \endcode
+ *
+ *  \param  filter_coeffs     Pointer to prototype FIR coefficients array arranged
+ *                            as ``[b0,b1,b2,...,bN-1]``, designed at the up-sampled rate.
+ *  \param  num_taps          Number of prototype filter taps (N = ``num_taps``).
+ *  \param  interp_factor     The interpolation factor L.
+ *  \param  polyphase_coeffs  Pointer to the resulting polyphase coefficient array of length
+ *                            ``DSP_FILTERS_RESAMPLER_COEFFS_LENGTH(N,L)``.
+ *                            Must be double word aligned.
+ *  \param  state_data        Pointer to the filter state data array of length
+ *                            ``DSP_FILTERS_RESAMPLER_STATE_LENGTH(N,L)``.
+ *                            Must be double word aligned.
+ */
+
+void dsp_filters_resampler_init
+(
+    const int32_t filter_coeffs[],
+    const int32_t num_taps,
+    const int32_t interp_factor,
+    int32_t       polyphase_coeffs[],
+    int32_t       state_data[]
+);
+
+/** This function implements a rational polyphase resampler.
+ *
+ *  The function operates on a block of ``num_samples`` input samples and
+ *  produces the output samples that fall within that block, returning their
+ *  count. For every output sample only the polyphase sub-filter of the
+ *  corresponding phase is evaluated, so no multiplications are spent on
+ *  zero-stuffed input samples or on output samples that are discarded.
+ *  The results are bit-exact with applying dsp_filters_fir() with the
+ *  prototype filter to the zero-stuffed up-sampled signal and keeping every
+ *  M-th output.
+ *
+ *  The number of output samples produced by one call is at most
+ *  ``(num_samples * L + M - 1) / M``. The prototype filter gain should be L
+ *  to preserve the signal level when interpolating.
+ *
+ *  \code
+ *  int32_t count = dsp_filters_resampler( input, 147, output, poly, state, 480, 160, 147, 31 );
+ *  \endcode
+ *
+ *  Multiplication results are accumulated in a 64-bit accumulator.
+ *  If overflow occurs in the final 64-bit result, it is saturated at the minimum/maximum value
+ *  given the fixed-point format and finally shifted right by ``q_format`` bits.
+ *  The saturation is only done after the last multiplication.
+ *
+ *  \param  input_samples     Array of ``num_samples`` input samples.
+ *  \param  num_samples       Number of input samples.
+ *  \param  output_samples    Array for the resulting output samples.
+ *  \param  polyphase_coeffs  Pointer to the polyphase coefficient array
+ *                            initialized by dsp_filters_resampler_init().
+ *  \param  state_data        Pointer to the state data array
+ *                            initialized by dsp_filters_resampler_init().
+ *  \param  num_taps          Number of prototype filter taps (N = ``num_taps``).
+ *  \param  interp_factor     The interpolation factor L.
+ *  \param  decim_factor      The decimation factor M.
+ *  \param  q_format          Fixed point format (i.e. number of fractional bits).
+ *  \returns                  The number of output samples written.
+ */
+
+int32_t dsp_filters_resampler
+(
+    const int32_t input_samples[],
+    const int32_t num_samples,
+    int32_t       output_samples[],
+    const int32_t polyphase_coeffs[],
+    int32_t       state_data[],
+    const int32_t num_taps,
+    const int32_t interp_factor,
+    const int32_t decim_factor,
+    const int32_t q_format
+);
+
 /** This function implements a second order IIR filter (direct form I).
  *
  *  The function operates on a single sample of input and output data (i.e. and
@@ -283,4 +741,302 @@ int32_t dsp_filters_biquads
     const int32_t q_format
 );
 
+/** This function implements a cascaded direct form I BiQuad filter on a
+ *  frame of interleaved multi-channel data.
+ *
+ *  The function operates on ``num_samples`` samples of each of
+ *  ``num_channels`` channels per call. The input and output frames are
+ *  interleaved, i.e. sample ``n`` of channel ``c`` is stored at index
+ *  ``n * num_channels + c``. All channels are filtered with the same cascade
+ *  of BiQuad sections.
+ *
+ *  The results are bit-exact with calling dsp_filters_biquads() once for every
+ *  sample of every channel, with a separate state array per channel. The frame
+ *  is processed one section at a time, so the coefficients of a section are
+ *  loaded once and held in registers while all channels and samples are swept.
+ *  The state array is arranged section by section, and within each section
+ *  channel by channel (``DSP_NUM_STATES_PER_BIQUAD`` values per channel), so it
+ *  is accessed sequentially.
+ *
+ *  The coefficients use the same format as dsp_filters_biquads(), as produced
+ *  by the dsp_design_biquad functions.
+ *
+ *  Example showing a 3x cascaded Biquad filter applied to a frame of 32 samples
+ *  of 16 channels, with samples and coefficients represented in Q28 fixed-point
+ *  format:
+ *
+ *  \code
+ *  int32_t filter_coeff[3*DSP_NUM_COEFFS_PER_BIQUAD] = { ... not shown for brevity };
+ *  int32_t filter_state[3*16*DSP_NUM_STATES_PER_BIQUAD] = { 0 };
+ *  dsp_filters_biquads_interleaved( frame, frame, 16, 32, filter_coeff, filter_state, 3, 28 );
+ *  \endcode
+ *
+ *  The IIR algorithm involves multiplication between 32-bit filter
+ *  coefficients and 32-bit state data producing a 64-bit result for each
+ *  coefficient and state data pair. Multiplication results are accumulated in a
+ *  64-bit accumulator.
+ *  If overflow occurs in the final 64-bit result, it is saturated at the minimum/maximum value
+ *  given the fixed-point format and finally shifted right by ``q_format`` bits.
+ *
+ *  \param  input_samples   Interleaved input frame of ``num_channels`` * ``num_samples`` samples.
+ *  \param  output_samples  Interleaved output frame of ``num_channels`` * ``num_samples`` samples.
+ *                          May be the same array as ``input_samples``.
+ *  \param  num_channels    Number of interleaved channels.
+ *  \param  num_samples     Number of samples per channel in the frame.
+ *  \param  filter_coeffs   Pointer to biquad coefficients array for all BiQuad sections.
+ *                          Arranged as ``[section1:b0,b1,b2,-a1,-a2,...sectionN:b0,b1,b2,-a1,-a2]``.
+ *  \param  state_data      Pointer to filter state data array (initialized at startup to zeros).
+ *                          The length of the state data array is
+ *                          ``num_sections`` * ``num_channels`` * 4. Must be double word aligned.
+ *  \param  num_sections    Number of BiQuad sections.
+ *  \param  q_format        Fixed point format (i.e. number of fractional bits).
+ */
+
+void dsp_filters_biquads_interleaved
+(
+    const int32_t input_samples[],
+    int32_t       output_samples[],
+    const int32_t num_channels,
+    const int32_t num_samples,
+    const int32_t filter_coeffs[],
+    int32_t       state_data[],
+    const int32_t num_sections,
+    const int32_t q_format
+);
+
+/** This function implements a direct form I BiQuad filter on one sample of
+ *  each channel of a stereo pair, with the same coefficients for both
+ *  channels.
+ *
+ *  The results are bit-exact with calling dsp_filters_biquad() on each
+ *  channel with its own state array. The two channels are computed with
+ *  separate accumulators, and each coefficient is loaded once for both.
+ *  The multiply-accumulates, state loads and stores each take a full issue
+ *  slot, so the saving over two calls is the coefficient loads and the
+ *  overhead of one call, not a doubling of throughput.
+ *
+ *  Example showing a stereo Biquad filter with samples and coefficients
+ *  represented in Q28 fixed-point format:
+ *
+ *  \code
+ *  int32_t filter_coeff[DSP_NUM_COEFFS_PER_BIQUAD] = { Q28(+0.5), Q28(-0.1), Q28(-0.5), Q28(-0.1), Q28(0.1) };
+ *  int32_t filter_state[2*DSP_NUM_STATES_PER_BIQUAD] = { 0 };
+ *  int32_t samples[2] = { left, right };
+ *  dsp_filters_biquad_stereo( samples, filter_coeff, filter_state, 28 );
+ *  \endcode
+ *
+ *  \param  samples        Left and right input samples, replaced by the
+ *                         filtered samples.
+ *  \param  filter_coeffs  Pointer to biquad coefficients array arranged as ``[b0,b1,b2,-a1,-a2]``.
+ *  \param  state_data     Pointer to filter state data array (initialized at startup to zeros),
+ *                         holding the 4 state values of the left channel
+ *                         followed by those of the right channel. The
+ *                         length of the state data array is 8. Must be
+ *                         double word aligned.
+ *  \param  q_format       Fixed point format (i.e. number of fractional bits).
+ */
+
+void dsp_filters_biquad_stereo
+(
+    int32_t       samples[2],
+    const int32_t filter_coeffs[DSP_NUM_COEFFS_PER_BIQUAD],
+    int32_t       state_data[2*DSP_NUM_STATES_PER_BIQUAD],
+    const int32_t q_format
+);
+
+/** This function implements a cascaded direct form I BiQuad filter on one
+ *  sample of each channel of a stereo pair, with the same coefficients for
+ *  both channels.
+ *
+ *  The results are bit-exact with calling dsp_filters_biquads() on each
+ *  channel with its own state array; the sections are computed as in
+ *  dsp_filters_biquad_stereo(), and take about as long as one section of
+ *  each channel with dsp_filters_biquads().
+ *
+ *  \param  samples        Left and right input samples, replaced by the
+ *                         filtered samples.
+ *  \param  filter_coeffs  Pointer to biquad coefficients array for all BiQuad sections.
+ *                         Arranged as ``[section1:b0,b1,b2,-a1,-a2,...sectionN:b0,b1,b2,-a1,-a2]``.
+ *  \param  state_data     Pointer to filter state data array (initialized at startup to zeros).
+ *                         Each section has 4 state values for the left
+ *                         channel followed by 4 for the right channel, so
+ *                         the length of the state data array is
+ *                         ``num_sections`` * 8. Must be double word aligned.
+ *  \param  num_sections   Number of BiQuad sections.
+ *  \param  q_format       Fixed point format (i.e. number of fractional bits).
+ */
+
+void dsp_filters_biquads_stereo
+(
+    int32_t       samples[2],
+    const int32_t filter_coeffs[],
+    int32_t       state_data[],
+    const int32_t num_sections,
+    const int32_t q_format
+);
+
+/** This function implements a cascaded direct form I BiQuad filter on a
+ *  block of samples, while moving the coefficients linearly from their
+ *  current values to a new set of target values over the block.
+ *
+ *  Replacing the coefficients of a running filter in one step causes a
+ *  discontinuity in its output, heard as zipper noise when a control such
+ *  as an equalizer gain is moved. This function instead steps every
+ *  coefficient of every section by ``1/num_samples`` of its change per
+ *  sample, and uses the target coefficients exactly for the last sample of
+ *  the block. On return ``filter_coeffs`` holds the target coefficients,
+ *  so the next block may be filtered with the same target, with a new one,
+ *  or with dsp_filters_biquads_interleaved(). When the current and target
+ *  coefficients are equal the results are bit-exact with calling
+ *  dsp_filters_biquads() once for every sample.
+ *
+ *  The coefficients of a section move along a straight line between two
+ *  stable filters, and the set of stable ``-a1,-a2`` pairs is convex, so
+ *  every intermediate filter is stable as well.
+ *
+ *  New targets are best designed away from the audio core, for example
+ *  with the fixed-point dsp_design_biquad functions on a control core,
+ *  and handed over through a FIFO of coefficient blocks (see dsp_fifo.h)
+ *  which the audio core polls once per block:
+ *
+ *  \code
+ *  int32_t coeffs[8*DSP_NUM_COEFFS_PER_BIQUAD];
+ *  int32_t target[8*DSP_NUM_COEFFS_PER_BIQUAD];
+ *  int32_t state[8*DSP_NUM_STATES_PER_BIQUAD] = { 0 };
+ *
+ *  dsp_fifo_read( fifo, target );
+ *  dsp_filters_biquads_smooth( block, block, 32, coeffs, target, state, 8, 28 );
+ *  \endcode
+ *
+ *  \param  input_samples   Block of ``num_samples`` input samples.
+ *  \param  output_samples  Block of ``num_samples`` output samples.
+ *                          May be the same array as ``input_samples``.
+ *  \param  num_samples     Number of samples in the block.
+ *  \param  filter_coeffs   Pointer to the current biquad coefficients array for all BiQuad
+ *                          sections, arranged as ``[section1:b0,b1,b2,-a1,-a2,...sectionN:b0,b1,b2,-a1,-a2]``.
+ *                          Replaced by the target coefficients.
+ *  \param  target_coeffs   Pointer to the target biquad coefficients array, arranged as
+ *                          ``filter_coeffs``.
+ *  \param  state_data      Pointer to filter state data array (initialized at startup to zeros).
+ *                          The length of the state data array is ``num_sections`` * 4.
+ *                          Must be double word aligned.
+ *  \param  num_sections    Number of BiQuad sections.
+ *  \param  q_format        Fixed point format (i.e. number of fractional bits).
+ */
+
+void dsp_filters_biquads_smooth
+(
+    const int32_t input_samples[],
+    int32_t       output_samples[],
+    const int32_t num_samples,
+    int32_t       filter_coeffs[],
+    const int32_t target_coeffs[],
+    int32_t       state_data[],
+    const int32_t num_sections,
+    const int32_t q_format
+);
+
+
+#if defined(__XS2A__)
+
+/** This function initializes a partitioned overlap-save FFT convolution.
+ *
+ *  Long FIR filters (thousands of taps) are too expensive to run with
+ *  dsp_filters_fir(), which costs one multiply-accumulate per tap per sample.
+ *  The FFT convolution splits the filter into partitions of ``block_length``
+ *  (B) taps, and filters blocks of B samples in the frequency domain: each
+ *  block costs one real FFT and one inverse real FFT of 2B points, plus one
+ *  complex vector multiply-accumulate of B bins per partition. The partition
+ *  size trades latency (B samples) against throughput (larger blocks cost
+ *  fewer cycles per sample).
+ *
+ *  This function computes the spectrum of every partition of the filter, and
+ *  stores all spectra as a single block floating point vector, normalized with
+ *  dsp_bfp_cls() and dsp_bfp_shl() so that they use the full precision of
+ *  their 32-bit values. It also clears the state. It is called once, before
+ *  the first call to dsp_filters_fft_convolution().
+ *
+ *  The sine tables are the ones needed by dsp_fft_bit_reverse_and_forward_real()
+ *  for a 2B point FFT. For example, when B is 256 use dsp_sine_256 and
+ *  dsp_sine_512.
+ *
+ *  \code
+ *  int32_t filter_coeff[4096] = { ... not shown for brevity };
+ *  int32_t filter_state[DSP_FILTERS_FFT_CONVOLUTION_STATE_LENGTH(4096,256)];
+ *  dsp_filters_fft_convolution_init( filter_coeff, 4096, 256, filter_state,
+ *                                    dsp_sine_256, dsp_sine_512 );
+ *  \endcode
+ *
+ *  \param  filter_coeffs   Pointer to FIR coefficients array arranged
+ *                          as ``[b0,b1,b2,...,bN-1]``.
+ *  \param  num_taps        Number of filter taps (N = ``num_taps``).
+ *  \param  block_length    Number of samples per block (B). Must be a power of
+ *                          two, and at least 4.
+ *  \param  state_data      Pointer to filter state data array of length
+ *                          ``DSP_FILTERS_FFT_CONVOLUTION_STATE_LENGTH(N,B)``.
+ *                          Must be double word aligned.
+ *  \param  sine            Array of B/4+1 sine values, as used by
+ *                          dsp_fft_bit_reverse_and_forward_real().
+ *  \param  sin2            Array of B/2+1 sine values, as used by
+ *                          dsp_fft_bit_reverse_and_forward_real().
+ */
+
+void dsp_filters_fft_convolution_init
+(
+    const int32_t filter_coeffs[],
+    const int32_t num_taps,
+    const int32_t block_length,
+    int32_t       state_data[],
+    const int32_t sine[],
+    const int32_t sin2[]
+);
+
+/** This function filters a block of samples with a partitioned overlap-save
+ *  FFT convolution, initialized by dsp_filters_fft_convolution_init().
+ *
+ *  Each call processes ``block_length`` (B) input samples and produces B output
+ *  samples, which are the same as ``dsp_filters_fir()`` applied to the input
+ *  apart from rounding errors in the FFTs. The output is delayed by the
+ *  block: output samples are only available once all B input samples are.
+ *
+ *  The input spectra are kept in a frequency-domain delay line, each with its
+ *  own block floating point exponent, so that quiet passages are filtered
+ *  with the same relative precision as loud ones. The head room needed by the
+ *  inverse FFT is computed for each block, and the output is shifted back and
+ *  saturated.
+ *
+ *  \code
+ *  dsp_filters_fft_convolution( input, output, filter_state, 4096, 256, 31,
+ *                               dsp_sine_256, dsp_sine_512 );
+ *  \endcode
+ *
+ *  \param  input_samples   Array of B samples to be processed.
+ *  \param  output_samples  Array of B resulting filter output samples.
+ *                          May be the same array as ``input_samples``.
+ *  \param  state_data      Pointer to filter state data array, initialized by
+ *                          dsp_filters_fft_convolution_init().
+ *  \param  num_taps        Number of filter taps (N = ``num_taps``).
+ *  \param  block_length    Number of samples per block (B).
+ *  \param  q_format        Fixed point format of the filter coefficients
+ *                          (i.e. number of fractional bits).
+ *  \param  sine            Array of B/4+1 sine values, as used by
+ *                          dsp_fft_bit_reverse_and_forward_real().
+ *  \param  sin2            Array of B/2+1 sine values, as used by
+ *                          dsp_fft_bit_reverse_and_forward_real().
+ */
+
+void dsp_filters_fft_convolution
+(
+    const int32_t input_samples[],
+    int32_t       output_samples[],
+    int32_t       state_data[],
+    const int32_t num_taps,
+    const int32_t block_length,
+    const int32_t q_format,
+    const int32_t sine[],
+    const int32_t sin2[]
+);
+
+#endif
+
 #endif
@@ -0,0 +1,121 @@
+// Copyright (c) 2017, XMOS Ltd, All rights reserved
+
+#ifndef DSP_GOERTZEL_H_
+#define DSP_GOERTZEL_H_
+
+#include <stdint.h>
+#include "dsp_complex.h"
+
+/* Single bins of the DFT of a real signal, for monitoring a set of tones
+ * without computing a full FFT. Each bin k is bin k of an N point DFT,
+ * where N is a power of two, and costs O(1) per input sample; the
+ * coefficients are taken from the sine table of an N point FFT, for
+ * example dsp_sine_1024 for N = 1024.
+ *
+ * The Goertzel functions compute the bins of consecutive frames of N
+ * samples. The sliding DFT functions compute the bins of the last N
+ * samples, and can be read after any sample.
+ *
+ * The bins are scaled by 1/N, as the output of dsp_fft_forward(), so a
+ * full scale sinusoid at the frequency of bin k gives a magnitude of 0.5.
+ * They are returned as dsp_complex_t, with the phase relative to the first
+ * sample of the frame, and can be passed on to
+ * dsp_complex_magnitude_vector() or dsp_math_atan2_hypot().
+ */
+
+// State length for dsp_goertzel_init(), for num_bins bins
+#define DSP_GOERTZEL_STATE_LENGTH(num_bins) (4 + 9 * (num_bins))
+
+// State length for dsp_goertzel_sliding_init(), for num_bins bins of an N point DFT
+#define DSP_GOERTZEL_SLIDING_STATE_LENGTH(N, num_bins) (4 + (N) + 6 * (num_bins))
+
+/** This function initializes the state of a bank of Goertzel filters, one
+ *  for each bin. The first frame starts with the next sample passed to
+ *  dsp_goertzel_update().
+ *
+ *  Each filter keeps its state in 64 bits, with as many bits of headroom
+ *  as the resonance of bin k needs for full scale input, so the input needs
+ *  no headroom. Near bins 0 and N/2, where a Goertzel filter is most
+ *  sensitive to its coefficient, 2cos(w) is kept as the difference from 2
+ *  or -2 with 30 significant bits. For full scale noise the bins are within
+ *  tens of LSBs of those of dsp_fft_forward() at all bins, as are those of
+ *  the sliding DFT.
+ *
+ *  \param  state     State array of length ``DSP_GOERTZEL_STATE_LENGTH(num_bins)``.
+ *  \param  bins      Array of num_bins bin numbers, each between 0 and N/2.
+ *  \param  num_bins  Number of bins.
+ *  \param  N         Number of samples in a frame, a power of two between
+ *                    4 and 16384.
+ *  \param  sine      Array of N/4+1 sine values, as for dsp_fft_forward();
+ *                    for example, for N = 1024 use dsp_sine_1024.
+ */
+void dsp_goertzel_init( int32_t state[], const uint32_t bins[], const uint32_t num_bins,
+                        const uint32_t N, const int32_t sine[] );
+
+/** This function adds input samples to the current frame of a bank of
+ *  Goertzel filters. Each sample costs one multiplication of the 64-bit
+ *  state by 2cos(w) per bin, done as two 32-bit multiply-accumulates.
+ *  Samples may be added in blocks of any size, but a frame ends after N
+ *  samples, when dsp_goertzel_result() must be called.
+ *
+ *  \param  state        State array initialized by dsp_goertzel_init().
+ *  \param  input        Array of num_samples input samples, one sign bit
+ *                       and 31 bit fraction.
+ *  \param  num_samples  Number of samples.
+ */
+void dsp_goertzel_update( int32_t state[], const int32_t input[], const uint32_t num_samples );
+
+/** This function computes the bins of the frame of N samples passed to
+ *  dsp_goertzel_update(), and starts the next frame.
+ *
+ *  \param  state   State array initialized by dsp_goertzel_init().
+ *  \param  result  Array of num_bins bins, scaled by 1/N, in the order
+ *                  given to dsp_goertzel_init().
+ */
+void dsp_goertzel_result( int32_t state[], dsp_complex_t result[] );
+
+/** This function initializes the state of a sliding DFT of N points, that
+ *  computes the given bins of the last N samples. The history starts out
+ *  as silence.
+ *
+ *  Each bin is kept as the exact sum of the products of each sample with
+ *  a twiddle factor of 31 - log2(N) bits, in a 64-bit accumulator. The
+ *  contribution of a sample is subtracted N samples later with the same
+ *  product, so rounding errors do not build up however long it runs.
+ *
+ *  \param  state     State array of length
+ *                    ``DSP_GOERTZEL_SLIDING_STATE_LENGTH(N, num_bins)``,
+ *                    which must be double word aligned.
+ *  \param  bins      Array of num_bins bin numbers, each less than N.
+ *  \param  num_bins  Number of bins.
+ *  \param  N         Number of points in the DFT, a power of two between
+ *                    4 and 16384.
+ */
+void dsp_goertzel_sliding_init( int32_t state[], const uint32_t bins[],
+                                const uint32_t num_bins, const uint32_t N );
+
+/** This function adds input samples to a sliding DFT. Each sample costs
+ *  four multiply accumulates per bin.
+ *
+ *  \param  state        State array initialized by dsp_goertzel_sliding_init().
+ *  \param  input        Array of num_samples input samples, one sign bit
+ *                       and 31 bit fraction.
+ *  \param  num_samples  Number of samples, at most N.
+ *  \param  sine         Array of N/4+1 sine values, as for dsp_fft_forward().
+ */
+void dsp_goertzel_sliding_update( int32_t state[], const int32_t input[],
+                                  const uint32_t num_samples, const int32_t sine[] );
+
+/** This function computes the bins of the last N samples passed to
+ *  dsp_goertzel_sliding_update(). It does not change the state, so it
+ *  may be called after every block, or only when the bins are needed.
+ *
+ *  \param  state   State array initialized by dsp_goertzel_sliding_init().
+ *  \param  result  Array of num_bins bins, scaled by 1/N, in the order
+ *                  given to dsp_goertzel_sliding_init().
+ *  \param  sine    Array of N/4+1 sine values, as for dsp_fft_forward().
+ */
+void dsp_goertzel_sliding_result( const int32_t state[], dsp_complex_t result[],
+                                  const int32_t sine[] );
+
+#endif
@@ -0,0 +1,148 @@
+// Copyright (c) 2017, XMOS Ltd, All rights reserved
+
+#ifndef DSP_INSTRUMENT_H_
+#define DSP_INSTRUMENT_H_
+
+#include <stdint.h>
+#include <dsp_adaptive.h>
+#include <dsp_filters.h>
+#include <dsp_fft.h>
+#include <dsp_matrix.h>
+
+/** Enables instrumentation of the library entry points listed in
+ * dsp_instrument_function_t. When 0 (the default) nothing is compiled in
+ * and there is no overhead.
+ *
+ * When 1, code that includes dsp.h calls those functions through wrappers
+ * that record the number of reference clock ticks taken by each call, and
+ * a saturation event for each output that is clamped to INT32_MAX or
+ * INT32_MIN. The records are kept in a ring buffer per logical core, and
+ * are read with dsp_instrument_read() or streamed over xSCOPE with
+ * dsp_instrument_flush(). Calls made inside the library, and calls from
+ * code that includes the individual headers instead of dsp.h, are not
+ * recorded.
+ */
+#ifndef DSP_INSTRUMENT
+#define DSP_INSTRUMENT 0
+#endif
+
+// Number of records kept per logical core; a power of two
+#ifndef DSP_INSTRUMENT_RING_LENGTH
+#define DSP_INSTRUMENT_RING_LENGTH 64
+#endif
+
+/** Identifies the instrumented function in a record. */
+typedef enum {
+    DSP_INSTRUMENT_FFT_FORWARD,
+    DSP_INSTRUMENT_FFT_INVERSE,
+    DSP_INSTRUMENT_FFT_FORWARD_REAL,
+    DSP_INSTRUMENT_FFT_INVERSE_REAL,
+    DSP_INSTRUMENT_FILTERS_FIR,
+    DSP_INSTRUMENT_FILTERS_FIR_BLOCK,
+    DSP_INSTRUMENT_FILTERS_BIQUAD,
+    DSP_INSTRUMENT_FILTERS_BIQUADS,
+    DSP_INSTRUMENT_ADAPTIVE_LMS,
+    DSP_INSTRUMENT_ADAPTIVE_NLMS,
+    DSP_INSTRUMENT_MATRIX_MULM,
+    DSP_INSTRUMENT_NUM_FUNCTIONS
+} dsp_instrument_function_t;
+
+// Kind of event in a record
+#define DSP_INSTRUMENT_EVENT_TICKS      0 // Value is the duration of a call
+#define DSP_INSTRUMENT_EVENT_SATURATION 1 // Value is the number of clamped outputs
+
+/* A record is a single word: the logical core in bits 31..29, the event in
+ * bit 28, the function in bits 27..22 and the value in bits 21..0. Values
+ * that do not fit are clamped to DSP_INSTRUMENT_VALUE_MAX.
+ */
+#define DSP_INSTRUMENT_VALUE_MAX 0x3fffff
+#define DSP_INSTRUMENT_RECORD_CORE(r)     ((r) >> 29)
+#define DSP_INSTRUMENT_RECORD_EVENT(r)    (((r) >> 28) & 1)
+#define DSP_INSTRUMENT_RECORD_FUNCTION(r) (((r) >> 22) & 0x3f)
+#define DSP_INSTRUMENT_RECORD_VALUE(r)    ((r) & DSP_INSTRUMENT_VALUE_MAX)
+
+#if DSP_INSTRUMENT
+
+#ifdef __XC__
+extern "C" {
+#endif
+
+/** This function takes the records of all logical cores, oldest first for
+ *  each core. Each ring buffer has a single writer, so this may be called
+ *  from any core while the others keep recording.
+ *
+ *  \param  records  Array receiving up to n records.
+ *  \param  n        Number of records requested.
+ *  \returns         Number of records written to ``records``.
+ */
+uint32_t dsp_instrument_read( uint32_t records[], const uint32_t n );
+
+/** This function returns the number of records that were discarded
+ *  because a ring buffer was full, and resets the count.
+ */
+uint32_t dsp_instrument_dropped( void );
+
+/** This function sends the records of all logical cores over xSCOPE, one
+ *  word per record, using the given probe. The probe must be declared in
+ *  the config.xscope of the application, for example as a ``DISCRETE``
+ *  probe of datatype ``UINT``, and the application built with -fxscope.
+ *
+ *  \param  probe  Index of the xSCOPE probe, as generated in xscope.h.
+ */
+void dsp_instrument_flush( const uint32_t probe );
+
+void dsp_instrument_fft_forward( dsp_complex_t pts[], const uint32_t N, const int32_t sine[] );
+void dsp_instrument_fft_inverse( dsp_complex_t pts[], const uint32_t N, const int32_t sine[] );
+void dsp_instrument_fft_bit_reverse_and_forward_real( int32_t pts[], const uint32_t N,
+                                                      const int32_t sine[], const int32_t sin2[] );
+void dsp_instrument_fft_bit_reverse_and_inverse_real( int32_t pts[], const uint32_t N,
+                                                      const int32_t sine[], const int32_t sin2[] );
+int32_t dsp_instrument_filters_fir( int32_t input_sample, const int32_t filter_coeffs[],
+                                    int32_t state_data[], const int32_t num_taps,
+                                    const int32_t q_format );
+void dsp_instrument_filters_fir_block( const int32_t input_samples[], int32_t output_samples[],
+                                       const int32_t num_samples, const int32_t filter_coeffs[],
+                                       int32_t state_data[], const int32_t num_taps,
+                                       const int32_t q_format );
+int32_t dsp_instrument_filters_biquad( int32_t input_sample,
+                                       const int32_t filter_coeffs[DSP_NUM_COEFFS_PER_BIQUAD],
+                                       int32_t state_data[DSP_NUM_STATES_PER_BIQUAD],
+                                       const int32_t q_format );
+int32_t dsp_instrument_filters_biquads( int32_t input_sample, const int32_t filter_coeffs[],
+                                        int32_t state_data[], const int32_t num_sections,
+                                        const int32_t q_format );
+int32_t dsp_instrument_adaptive_lms( int32_t input_sample, int32_t reference_sample,
+                                     int32_t *error_sample, const int32_t filter_coeffs[],
+                                     int32_t state_data[], const int32_t num_taps,
+                                     const int32_t mu, int32_t q_format );
+int32_t dsp_instrument_adaptive_nlms( int32_t input_sample, int32_t reference_sample,
+                                      int32_t *error_sample, const int32_t filter_coeffs[],
+                                      int32_t state_data[], const int32_t num_taps,
+                                      const int32_t mu, int32_t q_format );
+void dsp_instrument_matrix_mulm( const int32_t input_matrix_X[], const int32_t input_matrix_Y[],
+                                 int32_t result_matrix_R[], const int32_t rows_X,
+                                 const int32_t cols_Y, const int32_t cols_X_rows_Y,
+                                 const int32_t q_format );
+
+#ifdef __XC__
+}
+#endif
+
+// The library itself defines DSP_INSTRUMENT_NO_WRAP to call the originals
+#ifndef DSP_INSTRUMENT_NO_WRAP
+#define dsp_fft_forward                      dsp_instrument_fft_forward
+#define dsp_fft_inverse                      dsp_instrument_fft_inverse
+#define dsp_fft_bit_reverse_and_forward_real dsp_instrument_fft_bit_reverse_and_forward_real
+#define dsp_fft_bit_reverse_and_inverse_real dsp_instrument_fft_bit_reverse_and_inverse_real
+#define dsp_filters_fir                      dsp_instrument_filters_fir
+#define dsp_filters_fir_block                dsp_instrument_filters_fir_block
+#define dsp_filters_biquad                   dsp_instrument_filters_biquad
+#define dsp_filters_biquads                  dsp_instrument_filters_biquads
+#define dsp_adaptive_lms                     dsp_instrument_adaptive_lms
+#define dsp_adaptive_nlms                    dsp_instrument_adaptive_nlms
+#define dsp_matrix_mulm                      dsp_instrument_matrix_mulm
+#endif
+
+#endif
+
+#endif
@@ -5,6 +5,7 @@
 
 #include "xccompat.h"
 #include "stdint.h"
+#include "dsp_complex.h"
 
 
 /** Q1.31 fixed point format with 31 fractional bits
@@ -304,6 +305,62 @@ q8_24 dsp_math_exp(q8_24 x);
  **/
 q8_24 dsp_math_log(uq8_24 x);
 
+/** This function computes the square root of each element of a vector,
+ *  with the same results as dsp_math_sqrt().
+ *
+ *  The elements are computed in a single loop without a call per element,
+ *  which is faster than calling dsp_math_sqrt() on each element. The input
+ *  and result vectors may be the same array.
+ *
+ *  \param  input_vector_X    Pointer/reference to source data, unsigned Q8.24.
+ *  \param  result_vector_R   Pointer to the resulting data array, unsigned Q8.24.
+ *  \param  vector_length     Length of the input and output vectors.
+ */
+void dsp_vector_sqrt( const int32_t input_vector_X[], int32_t result_vector_R[], const int32_t vector_length );
+
+/** This function computes the natural exponent of each element of a
+ *  vector, with the same results as dsp_math_exp().
+ *
+ *  The elements are computed in a single loop without a call per element.
+ *  The input and result vectors may be the same array.
+ *
+ *  \param  input_vector_X    Pointer/reference to source data, Q8.24.
+ *  \param  result_vector_R   Pointer to the resulting data array, Q8.24.
+ *  \param  vector_length     Length of the input and output vectors.
+ */
+void dsp_vector_exp( const int32_t input_vector_X[], int32_t result_vector_R[], const int32_t vector_length );
+
+/** This function computes the natural logarithm of each element of a
+ *  vector, with the same results as dsp_math_log().
+ *
+ *  The elements are computed in a single loop without a call per element.
+ *  The input and result vectors may be the same array.
+ *
+ *  \param  input_vector_X    Pointer/reference to source data, unsigned Q8.24.
+ *  \param  result_vector_R   Pointer to the resulting data array, Q8.24.
+ *  \param  vector_length     Length of the input and output vectors.
+ */
+void dsp_vector_log( const int32_t input_vector_X[], int32_t result_vector_R[], const int32_t vector_length );
+
+#if defined(__XS2A__)
+/** This function computes the hypothenuse and angle of each point of a
+ *  complex vector in place, as dsp_math_atan2_hypot(): the real part of
+ *  each point is overwritten with the hypothenuse, and the imaginary part
+ *  with the angle. For example, applied to the output of an FFT this gives
+ *  the magnitude and phase of each bin.
+ *
+ *  The CORDIC is inlined in the loop over the points, which saves the
+ *  call, register saves and table lookup of dsp_math_atan2_hypot() on
+ *  every point.
+ *
+ *  \param  pts            Array of complex points, overwritten.
+ *  \param  vector_length  Number of points.
+ *  \param  precision      Precision, as for dsp_math_atan2_hypot();
+ *                         0 <= precision <= 23.
+ */
+void dsp_vector_atan2_hypot( dsp_complex_t pts[], const int32_t vector_length, unsigned int precision );
+#endif
+
 extern q8_24 dsp_math_sinh_(q8_24 x, int cosine);
 
 /** This function returns the hyperbolic sine (sinh) of a fixed point
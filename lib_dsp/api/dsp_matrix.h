@@ -169,8 +169,11 @@ void dsp_matrix_subm
  *  32bit multiply 64-bit accumulate function therefore fixed-point
  *  multiplication and q-format adjustment overflow behavior must be considered
  *  (see behavior for the function ``dsp_math_multiply``). 
- *  The algorithm is optimised for performance using double word load and store instructions.
- *  As a result the matrices must have an even number of rows and columns.
+ *  The result is computed in tiles of 2x2 elements, a row of the tile at a
+ *  time, so that each element loaded from X is used for two products, and
+ *  the last row of an odd sized R is computed once. When cols_X_rows_Y is even,
+ *  double word loads are used and X and Y must be double word aligned; any
+ *  other dimensions are supported with single word loads and tail tiles.
  * 
  *  Example:
  *  MxN * NxP = MxP
@@ -184,9 +187,9 @@ void dsp_matrix_subm
  *  \param  input_matrix_X   Pointer to source data array X.
  *  \param  input_matrix_Y   Pointer to source data array Y. 
  *  \param  result_matrix_R  Pointer to the resulting 2-dimensional data array.
- *  \param  rows_X           Number of rows in input matrix X. Must be even or will trap.
- *  \param  cols_Y           Number of columns input matrix Y. Must be even or will trap.
- *  \param  cols_X_rows_Y    Number of columns in input matrix X == rows in input matrix Y. Must be even or will trap.
+ *  \param  rows_X           Number of rows in input matrix X.
+ *  \param  cols_Y           Number of columns input matrix Y.
+ *  \param  cols_X_rows_Y    Number of columns in input matrix X == rows in input matrix Y.
  *  \param  q_format         Fixed point format (i.e. number of fractional bits).
  */
 // N == columns_X == rows_Y
@@ -201,6 +204,188 @@ void dsp_matrix_mulm
     const int32_t q_format
 );
 
+// Length of the packed matrix written by dsp_matrix_mulm_pack
+#define DSP_MATRIX_MULM_PACKED_LENGTH(cols_X_rows_Y, cols_Y) ((cols_X_rows_Y) * (((cols_Y) + 1) & ~1))
+
+/** Packing of matrix Y for dsp_matrix_mulm_packed()
+ * 
+ *  Y is given in its natural row major layout and rearranged so that the
+ *  elements of each pair of adjacent columns are interleaved, and can be
+ *  loaded for two products with one double word load. A matrix that is
+ *  multiplied repeatedly, such as a weight matrix, only needs to be packed
+ *  once. An odd last column is padded with zeros.
+ * 
+ *  Example:
+ *  \code
+ *  int32_t weights[64][8];
+ *  int32_t packed_weights[DSP_MATRIX_MULM_PACKED_LENGTH(64, 8)];
+ *  dsp_matrix_mulm_pack( weights, packed_weights, 64, 8 );
+ *  \endcode
+ * 
+ *  \param  input_matrix_Y   Pointer to source data array Y, of cols_X_rows_Y rows and cols_Y columns.
+ *  \param  packed_matrix_Y  Pointer to the packed array, of length
+ *                           ``DSP_MATRIX_MULM_PACKED_LENGTH(cols_X_rows_Y, cols_Y)``.
+ *  \param  cols_X_rows_Y    Number of rows in input matrix Y.
+ *  \param  cols_Y           Number of columns in input matrix Y.
+ */
+void dsp_matrix_mulm_pack
+(
+    const int32_t input_matrix_Y[],
+    int32_t       packed_matrix_Y[],
+    const int32_t cols_X_rows_Y,
+    const int32_t cols_Y
+);
+
+/** Matrix / matrix multiplication with a packed matrix Y: ``R = X * Y``
+ * 
+ *  As dsp_matrix_mulm(), with Y packed by dsp_matrix_mulm_pack() instead of
+ *  transposed. Each step of the 2x2 tiles loads one element of X and one
+ *  double word from the packed Y, for two products, which saves a load on
+ *  each step for an odd cols_X_rows_Y.
+ *  Any dimensions are supported; the packed matrix must be double word
+ *  aligned.
+ * 
+ *  Example:
+ *  \code
+ *  int32_t input_matrix_X[rows_X][N];
+ *  int32_t packed_matrix_Y[DSP_MATRIX_MULM_PACKED_LENGTH(N, cols_Y)];
+ *  int32_t result_matrix_R[rows_X][cols_Y];
+ *  dsp_matrix_mulm_packed( input_matrix_X, packed_matrix_Y, result_matrix_R, rows_X, cols_Y, N, 28 );
+ *  \endcode
+ * 
+ *  \param  input_matrix_X   Pointer to source data array X.
+ *  \param  packed_matrix_Y  Pointer to matrix Y packed by dsp_matrix_mulm_pack().
+ *  \param  result_matrix_R  Pointer to the resulting 2-dimensional data array.
+ *  \param  rows_X           Number of rows in input matrix X.
+ *  \param  cols_Y           Number of columns input matrix Y.
+ *  \param  cols_X_rows_Y    Number of columns in input matrix X == rows in input matrix Y.
+ *  \param  q_format         Fixed point format (i.e. number of fractional bits).
+ */
+void dsp_matrix_mulm_packed
+(
+    const int32_t input_matrix_X[],
+    const int32_t packed_matrix_Y[],
+    int32_t       result_matrix_R[],
+    const int32_t rows_X,
+    const int32_t cols_Y,
+    const int32_t cols_X_rows_Y,
+    const int32_t q_format
+);
+
+/** Matrix / vector multiplication: ``Y = A * X``
+ * 
+ *  Each element of Y is the dot product of a row of A with the vector X,
+ *  computed as for ``dsp_vector_dotprod``, with the result saturated. Two
+ *  rows are computed together, so that each element of X is loaded once
+ *  for both. When cols_A is even, double word loads are used and A and X
+ *  must be double word aligned; any other dimensions are supported with
+ *  single word loads.
+ * 
+ *  Example:
+ *  \code
+ *  int32_t input_matrix_A[8][64];
+ *  int32_t input_vector_X[64];
+ *  int32_t result_vector_Y[8];
+ *  dsp_matrix_mulv( input_matrix_A, input_vector_X, result_vector_Y, 8, 64, 28 );
+ *  \endcode
+ * 
+ *  \param  input_matrix_A   Pointer to source data array A, of rows_A rows and cols_A columns.
+ *  \param  input_vector_X   Pointer to source vector X, of cols_A elements.
+ *  \param  result_vector_Y  Pointer to the resulting vector, of rows_A elements.
+ *  \param  rows_A           Number of rows in input matrix A.
+ *  \param  cols_A           Number of columns in input matrix A.
+ *  \param  q_format         Fixed point format (i.e. number of fractional bits).
+ */
+void dsp_matrix_mulv
+(
+    const int32_t input_matrix_A[],
+    const int32_t input_vector_X[],
+    int32_t       result_vector_Y[],
+    const int32_t rows_A,
+    const int32_t cols_A,
+    const int32_t q_format
+);
+
+/** Activation functions applied by dsp_matrix_mulv_w16() and
+ *  dsp_matrix_mulv_w8(). The logistic and softplus activations use
+ *  ``dsp_math_logistics_fast`` and ``dsp_math_softplus``, and interpret the
+ *  requantized output as Q8.24.
+ */
+typedef enum {
+    DSP_ACTIVATION_NONE,     // Requantized output, unchanged
+    DSP_ACTIVATION_RELU,     // Negative outputs set to zero
+    DSP_ACTIVATION_LOGISTIC, // 1/(1+exp(-x)), Q8.24
+    DSP_ACTIVATION_SOFTPLUS  // ln(1+exp(x)), Q8.24
+} dsp_activation_t;
+
+/** Fully connected layer with 16-bit weights: ``Y = f(((W * X) >> shift) + B)``
+ * 
+ *  Each output is the dot product of a row of the weight matrix with the
+ *  input vector, accumulated in 64 bits starting from the bias of the row.
+ *  The sum is requantized by a rounding right shift, saturated to 32 bits
+ *  and passed through the activation function. The bias is in the format
+ *  of the output, and is shifted left by ``shift`` into the accumulator.
+ *  Two rows are computed together, so that each input is loaded once for
+ *  both.
+ * 
+ *  Example:
+ *  \code
+ *  int16_t weights[32][64];  // Q15
+ *  int32_t bias[32];         // Q24, as the output
+ *  int32_t input[64];        // Q24
+ *  int32_t output[32];       // Q24
+ *  dsp_matrix_mulv_w16( weights, input, bias, output, 32, 64, 15, DSP_ACTIVATION_RELU );
+ *  \endcode
+ * 
+ *  \param  weights          Pointer to the weight matrix, of rows rows and cols columns.
+ *  \param  input_vector_X   Pointer to the input vector, of cols elements.
+ *  \param  bias             Pointer to the bias vector, of rows elements, in
+ *                           the output format.
+ *  \param  result_vector_Y  Pointer to the output vector, of rows elements.
+ *  \param  rows             Number of rows in the weight matrix.
+ *  \param  cols             Number of columns in the weight matrix.
+ *  \param  shift            Number of bits the accumulator is shifted right by.
+ *  \param  activation       Activation function applied to each output.
+ */
+void dsp_matrix_mulv_w16
+(
+    const int16_t          weights[],
+    const int32_t          input_vector_X[],
+    const int32_t          bias[],
+    int32_t                result_vector_Y[],
+    const int32_t          rows,
+    const int32_t          cols,
+    const int32_t          shift,
+    const dsp_activation_t activation
+);
+
+/** Fully connected layer with 8-bit weights: ``Y = f(((W * X) >> shift) + B)``
+ * 
+ *  As dsp_matrix_mulv_w16(), with the weights stored in 8 bits, which
+ *  quarters the memory required for the weights compared to a 32-bit matrix.
+ * 
+ *  \param  weights          Pointer to the weight matrix, of rows rows and cols columns.
+ *  \param  input_vector_X   Pointer to the input vector, of cols elements.
+ *  \param  bias             Pointer to the bias vector, of rows elements, in
+ *                           the output format.
+ *  \param  result_vector_Y  Pointer to the output vector, of rows elements.
+ *  \param  rows             Number of rows in the weight matrix.
+ *  \param  cols             Number of columns in the weight matrix.
+ *  \param  shift            Number of bits the accumulator is shifted right by.
+ *  \param  activation       Activation function applied to each output.
+ */
+void dsp_matrix_mulv_w8
+(
+    const int8_t           weights[],
+    const int32_t          input_vector_X[],
+    const int32_t          bias[],
+    int32_t                result_vector_Y[],
+    const int32_t          rows,
+    const int32_t          cols,
+    const int32_t          shift,
+    const dsp_activation_t activation
+);
+
 /** Matrix transposition
  * 
  *  \param  input_matrix_X   Pointer/reference to source data.
@@ -137,6 +137,47 @@ int32_t dsp_vector_rms
     const int32_t q_format
 );
 
+/** Results of dsp_vector_stats(). */
+typedef struct {
+    int32_t minimum;       // First occurring minimum value
+    int32_t minimum_index; // Array index of the minimum value
+    int32_t maximum;       // First occurring maximum value
+    int32_t maximum_index; // Array index of the maximum value
+    int32_t abs_sum;       // As dsp_vector_abs_sum
+    int32_t mean;          // As dsp_vector_mean
+    int32_t power;         // As dsp_vector_power
+    int32_t rms;           // As dsp_vector_rms
+} dsp_vector_stats_t;
+
+/** Vector statistics: minimum, maximum, absolute sum, mean, power and RMS
+ *
+ *  This function computes the results of ``dsp_vector_minimum``,
+ *  ``dsp_vector_maximum``, ``dsp_vector_abs_sum``, ``dsp_vector_mean``,
+ *  ``dsp_vector_power`` and ``dsp_vector_rms`` in a single pass over the
+ *  input vector, with the same 64-bit accumulation and the same results.
+ *  The indices of the minimum and maximum are those of the first occurring
+ *  values. All of the results are 0 for an empty vector.
+ *
+ *  Example:
+ *
+ *  \code
+ *  dsp_vector_stats_t stats;
+ *  stats = dsp_vector_stats( input_vector, 1024, 28 );
+ *  \endcode
+ *
+ *  \param  input_vector_X  Pointer to source data array X, double word aligned.
+ *  \param  vector_length   Length (N) of the input vector.
+ *  \param  q_format        Fixed point format (i.e. number of fractional bits).
+ *  \returns                The statistics of the vector.
+ */
+
+dsp_vector_stats_t dsp_vector_stats
+(
+    const int32_t input_vector_X[],
+    const int32_t vector_length,
+    const int32_t q_format
+);
+
 /** Vector dot product: ``R = X[0] * Y[0] + X[1] * Y[1] + ... + X[N-1] * Y[N-1]``
  *
  *  This function computes the dot-product of two equal length vectors.
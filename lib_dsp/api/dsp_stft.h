@@ -0,0 +1,122 @@
+// Copyright (c) 2017, XMOS Ltd, All rights reserved
+
+#ifndef DSP_STFT_H_
+#define DSP_STFT_H_
+
+#include <stdint.h>
+
+/* Short-time Fourier transform analysis and synthesis of a real signal,
+ * in frames of N samples advancing by a hop of H samples. Samples are
+ * buffered in the state array, so any block size can be pushed in or
+ * pulled out; each frame is transformed in place with
+ * dsp_fft_bit_reverse_and_forward_real() and
+ * dsp_fft_bit_reverse_and_inverse_real().
+ */
+
+// State length for dsp_stft_analysis_init(), for N point frames
+#define DSP_STFT_ANALYSIS_STATE_LENGTH(N) (4 + (N))
+
+// State length for dsp_stft_synthesis_init(), for N point frames
+#define DSP_STFT_SYNTHESIS_STATE_LENGTH(N) (4 + (N))
+
+/** This function computes a square root periodic Hann window of N points,
+ *  for use as both the analysis and the synthesis window.
+ *
+ *  The window is scaled so that the product of the analysis and synthesis
+ *  windows overlap-adds to 1.0 at the given hop, which must divide N/2.
+ *  This uses double precision arithmetic and is intended to be called at
+ *  startup.
+ *
+ *  \param  window  Array of N values, each a sign bit and a 31 bit fraction.
+ *  \param  N       Number of points in a frame.
+ *  \param  hop     Number of samples between frames.
+ */
+void dsp_stft_window_sqrt_hann( int32_t window[], const uint32_t N, const uint32_t hop );
+
+/** This function initializes the state of an STFT analysis, with frames of
+ *  N samples every hop samples. The history starts out as silence.
+ *
+ *  \param  state   State array of length ``DSP_STFT_ANALYSIS_STATE_LENGTH(N)``.
+ *  \param  N       Number of points in a frame, a power of two.
+ *  \param  hop     Number of samples between frames, at most N.
+ */
+void dsp_stft_analysis_init( int32_t state[], const uint32_t N, const uint32_t hop );
+
+/** This function adds input samples to an STFT analysis.
+ *
+ *  Samples are taken until the next frame is complete, so fewer than n
+ *  samples may be consumed. When the return value is less than n, call
+ *  dsp_stft_analysis_frame() and then push the remaining samples.
+ *
+ *  \param  state   State array initialized by dsp_stft_analysis_init().
+ *  \param  input   Array of n samples.
+ *  \param  n       Number of samples offered.
+ *  \returns        Number of samples consumed.
+ */
+uint32_t dsp_stft_analysis_push( int32_t state[], const int32_t input[], const uint32_t n );
+
+/** This function computes the spectrum of the current STFT frame, once hop
+ *  samples have been pushed since the previous frame.
+ *
+ *  The last N samples are multiplied by the window and transformed with
+ *  dsp_fft_bit_reverse_and_forward_real(), so ``frame`` holds N/2
+ *  dsp_complex_t bins in the format of that function, scaled by 1/N.
+ *
+ *  \param  frame   Array of N integers, double word aligned, receiving
+ *                  the spectrum.
+ *  \param  state   State array initialized by dsp_stft_analysis_init().
+ *  \param  window  Analysis window of N values, each a sign bit and a 31
+ *                  bit fraction.
+ *  \param  sine    Sine table for an N/2 point FFT, for example
+ *                  dsp_sine_256 for N = 512.
+ *  \param  sin2    Sine table for an N point FFT, for example dsp_sine_512.
+ *  \returns        1 if a frame was computed, 0 if the frame is not
+ *                  complete yet.
+ */
+int32_t dsp_stft_analysis_frame( int32_t frame[], int32_t state[], const int32_t window[],
+                                 const int32_t sine[], const int32_t sin2[] );
+
+/** This function initializes the state of an STFT synthesis, with frames of
+ *  N samples every hop samples.
+ *
+ *  \param  state   State array of length ``DSP_STFT_SYNTHESIS_STATE_LENGTH(N)``.
+ *  \param  N       Number of points in a frame, a power of two.
+ *  \param  hop     Number of samples between frames, at most N.
+ */
+void dsp_stft_synthesis_init( int32_t state[], const uint32_t N, const uint32_t hop );
+
+/** This function adds a frame to an STFT synthesis.
+ *
+ *  The spectrum in ``frame`` is transformed in place with
+ *  dsp_fft_bit_reverse_and_inverse_real(), multiplied by the window and
+ *  overlap-added, after which the next hop samples of output can be pulled.
+ *  With the output of dsp_stft_analysis_frame() and windows from
+ *  dsp_stft_window_sqrt_hann(), the output reconstructs the input delayed
+ *  by N - hop samples.
+ *
+ *  \param  frame   Array of N integers, double word aligned, holding N/2
+ *                  bins in the format of dsp_fft_bit_reverse_and_forward_real();
+ *                  overwritten.
+ *  \param  state   State array initialized by dsp_stft_synthesis_init().
+ *  \param  window  Synthesis window of N values.
+ *  \param  sine    Sine table for an N/2 point FFT.
+ *  \param  sin2    Sine table for an N point FFT.
+ *  \returns        1 if the frame was added, 0 if samples of the previous
+ *                  frame have not been pulled yet.
+ */
+int32_t dsp_stft_synthesis_frame( int32_t frame[], int32_t state[], const int32_t window[],
+                                  const int32_t sine[], const int32_t sin2[] );
+
+/** This function takes output samples from an STFT synthesis.
+ *
+ *  Up to hop samples are available after each call to
+ *  dsp_stft_synthesis_frame().
+ *
+ *  \param  output  Array of n samples.
+ *  \param  state   State array initialized by dsp_stft_synthesis_init().
+ *  \param  n       Number of samples requested.
+ *  \returns        Number of samples written to output.
+ */
+uint32_t dsp_stft_synthesis_pull( int32_t output[], int32_t state[], const uint32_t n );
+
+#endif
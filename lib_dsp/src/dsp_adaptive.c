@@ -7,6 +7,9 @@
 #include "dsp_vector.h"
 #include "dsp_statistics.h"
 #include "dsp_adaptive.h"
+#include "dsp_complex.h"
+#include "dsp_fft.h"
+#include "dsp_bfp.h"
 
 
 
@@ -44,6 +47,39 @@ int32_t dsp_adaptive_lms
 
 
 
+// Shared by the NLMS filters once the error and the energy of the state are
+// known: adjustment = error * mu / energy, then b[k] += adjustment * x[n-k]
+
+static void _dsp_adaptive_nlms__adjust
+(
+    int32_t        error_sample,
+    int32_t        energy,
+    const int32_t* filter_coeffs,
+    int32_t*       state_data,
+    const int32_t  num_taps,
+    const int32_t  mu,
+    const int32_t  q_format
+) {
+    int32_t adjustment, ee, qq;
+
+    // Adjust energy q_format to account for range of reciprocal
+    for( qq = q_format, ee = energy; qq >= 0 && !(ee & 0x80000000); --qq ) ee <<= 1;
+    energy = energy >> (q_format - qq);
+    // Saturate the reciprocal value to max value for the given q_format
+    if( energy < (1 << (31-(31-qq)*2)) ) energy = (1 << (31-(31-qq)*2)) + 0;
+
+    energy = dsp_math_divide( (1 << qq), energy, qq );
+    adjustment = dsp_math_multiply( error_sample, mu, q_format );
+    adjustment = dsp_math_multiply( energy, adjustment, qq + q_format - q_format );
+    
+    // FIR filter coefficients b[k] are updated on a sample-by-sample basis:
+    // b[k] = b[k] + mu_err * x[n-k] --- where mu_err = e[n] * mu
+    
+    dsp_vector_muls_addv( state_data, adjustment, (int32_t*) filter_coeffs, (int32_t*) filter_coeffs, num_taps, q_format );
+}
+
+
+
 int32_t dsp_adaptive_nlms
 (
     int32_t  source_sample,
@@ -55,7 +91,7 @@ int32_t dsp_adaptive_nlms
     const int32_t mu,
     const int32_t q_format
 ) {
-    int32_t output_sample, energy, adjustment, ee, qq;
+    int32_t output_sample, energy;
     
     // Output signal y[n] is computed via standard FIR filter:
     // y[n] = b[0] * x[n] + b[1] * x[n-1] + b[2] * x[n-2] + ...+ b[N-1] * x[n-N+1]
@@ -71,22 +107,298 @@ int32_t dsp_adaptive_nlms
     energy = dsp_vector_power( state_data, num_taps, q_format );
     //printf( "E = %08x %f\n", energy, F31(energy) );
     
-    // adjustment = error * mu / energy
-    
-    // Adjust energy q_format to account for range of reciprocal
-    for( qq = q_format, ee = energy; qq >= 0 && !(ee & 0x80000000); --qq ) ee <<= 1;
-    energy = energy >> (q_format - qq);
-    // Saturate the reciprocal value to max value for the given q_format
-    if( energy < (1 << (31-(31-qq)*2)) ) energy = (1 << (31-(31-qq)*2)) + 0;
+    _dsp_adaptive_nlms__adjust( *error_sample, energy, filter_coeffs, state_data, num_taps, mu, q_format );
+        
+    return output_sample;
+}
 
-    energy = dsp_math_divide( (1 << qq), energy, qq );
-    adjustment = dsp_math_multiply( *error_sample, mu, q_format );
-    adjustment = dsp_math_multiply( energy, adjustment, qq + q_format - q_format );
-    
-    // FIR filter coefficients b[k] are updated on a sample-by-sample basis:
-    // b[k] = b[k] + mu_err * x[n-k] --- where mu_err = e[n] * mu
+
+
+// Sum of squares of the state, wrapping modulo 2^64 like the maccs
+// accumulation in dsp_vector_power()
+
+static int64_t _dsp_adaptive_nlms__energy( const int32_t* state_data, const int32_t num_taps )
+{
+    uint64_t energy = 0;
+    for( int32_t i = 0; i < num_taps; ++i ) {
+        energy += (uint64_t) ((int64_t) state_data[i] * state_data[i]);
+    }
+    return (int64_t) energy;
+}
+
+
+
+void dsp_adaptive_nlms_init
+(
+    dsp_adaptive_nlms_state_t* nlms_state,
+    const int32_t*             state_data,
+    const int32_t              num_taps
+) {
+    nlms_state->energy = _dsp_adaptive_nlms__energy( state_data, num_taps );
+    nlms_state->count = DSP_ADAPTIVE_NLMS_RESYNC_PERIOD;
+}
+
+
+
+int32_t dsp_adaptive_nlms_incremental
+(
+    int32_t                    source_sample,
+    int32_t                    reference_sample,
+    int32_t*                   error_sample,
+    const int32_t*             filter_coeffs,
+    int32_t*                   state_data,
+    dsp_adaptive_nlms_state_t* nlms_state,
+    const int32_t              num_taps,
+    const int32_t              mu,
+    const int32_t              q_format
+) {
+    int32_t output_sample, energy, oldest_sample = state_data[num_taps-1];
+    int32_t ah; uint32_t al;
     
-    dsp_vector_muls_addv( state_data, adjustment, (int32_t*) filter_coeffs, (int32_t*) filter_coeffs, num_taps, q_format );
+    output_sample = dsp_filters_fir( source_sample, filter_coeffs, state_data, num_taps, q_format );
+    *error_sample = reference_sample - output_sample;
+
+    // The energy changes by the sample that entered the state and the one
+    // that left it. This is exact, so the periodic recomputation only guards
+    // against the state array being changed behind the filter's back.
+
+    if( --nlms_state->count <= 0 ) {
+        nlms_state->energy = _dsp_adaptive_nlms__energy( state_data, num_taps );
+        nlms_state->count = DSP_ADAPTIVE_NLMS_RESYNC_PERIOD;
+    } else {
+        nlms_state->energy = (int64_t) ((uint64_t) nlms_state->energy
+                           + (uint64_t) ((int64_t) source_sample * source_sample)
+                           - (uint64_t) ((int64_t) oldest_sample * oldest_sample));
+    }
+
+    // Saturate and extract as dsp_vector_power() does
+
+    ah = (int32_t) (nlms_state->energy >> 32);
+    al = (uint32_t) nlms_state->energy;
+    asm("lsats %0,%1,%2":"=r"(ah),"=r"(al):"r"(q_format),"0"(ah),"1"(al));
+    asm("lextract %0,%1,%2,%3,32":"=r"(energy):"r"(ah),"r"(al),"r"(q_format));
+
+    _dsp_adaptive_nlms__adjust( *error_sample, energy, filter_coeffs, state_data, num_taps, mu, q_format );
         
     return output_sample;
 }
+
+
+
+#if defined(__XS2A__)
+
+// The state starts with a dsp_filters_fft_convolution() state (see
+// dsp_filters.c), whose filter spectra are the adaptive weights. It is
+// followed by:
+//   power                  B+1 smoothed input powers, DC to Nyquist, padded to even
+//   error spectrum         B complex bins
+//   gradient               B complex bins
+//
+// The weights are stored with a fixed exponent: the spectrum of the
+// coefficients as computed by the real FFT, shifted right so that the
+// products and their sum over all partitions cannot overflow.
+
+static int32_t _dsp_adaptive_fdaf__weight_shift( int32_t partitions, int32_t q_format )
+{
+    int32_t log2_partitions = 0;
+    while( (1 << log2_partitions) < partitions ) ++log2_partitions;
+    return q_format - 29 + log2_partitions;
+}
+
+
+
+// Returns a 31-bit mantissa r, and sets zeroes, such that 1/d = r * 2^(zeroes-62)
+
+static uint32_t _dsp_adaptive_fdaf__reciprocal( uint32_t d, int32_t* zeroes )
+{
+    uint32_t r, remainder;
+    asm("clz %0,%1":"=r"(*zeroes):"r"(d));
+    d = (d << *zeroes) >> 1;
+    asm("ldivu %0,%1,%2,%3,%4":"=r"(r),"=r"(remainder):"r"(1 << 29),"r"(0),"r"(d));
+    return (r > 0x7fffffff) ? 0x7fffffff : r;
+}
+
+
+
+void dsp_adaptive_fdaf_init
+(
+    const int32_t* filter_coeffs,
+    const int32_t  num_taps,
+    const int32_t  block_length,
+    int32_t*       state_data,
+    const int32_t  q_format,
+    const int32_t* sine,
+    const int32_t* sin2
+) {
+    int32_t partitions = DSP_FILTERS_FFT_CONVOLUTION_PARTITIONS( num_taps, block_length );
+    int32_t conv_length = DSP_FILTERS_FFT_CONVOLUTION_STATE_LENGTH( num_taps, block_length );
+    int32_t length = DSP_ADAPTIVE_FDAF_STATE_LENGTH( num_taps, block_length );
+    dsp_complex_t* weights = (dsp_complex_t*) (state_data + 2 + ((partitions + 1) & ~1));
+    int32_t shift = _dsp_adaptive_fdaf__weight_shift( partitions, q_format );
+
+    // Replace the normalization of the convolution by the fixed exponent.
+
+    dsp_filters_fft_convolution_init( filter_coeffs, num_taps, block_length, state_data, sine, sin2 );
+    dsp_bfp_shl( weights, partitions * block_length, -shift - state_data[1] );
+    state_data[1] = -shift;
+
+    for( int32_t i = conv_length; i < length; ++i ) state_data[i] = 0;
+}
+
+
+
+void dsp_adaptive_fdaf
+(
+    const int32_t* input_samples,
+    const int32_t* reference_samples,
+    int32_t*       output_samples,
+    int32_t*       error_samples,
+    int32_t*       state_data,
+    const int32_t  num_taps,
+    const int32_t  block_length,
+    const int32_t  mu,
+    const int32_t  constrained,
+    const int32_t  q_format,
+    const int32_t* sine,
+    const int32_t* sin2
+) {
+    int32_t partitions = DSP_FILTERS_FFT_CONVOLUTION_PARTITIONS( num_taps, block_length );
+    int32_t fft_length = 2 * block_length;
+    int32_t* shifts = state_data + 2;
+    dsp_complex_t* weights = (dsp_complex_t*) (shifts + ((partitions + 1) & ~1));
+    dsp_complex_t* delay_line = weights + partitions * block_length;
+    int32_t* power = state_data + DSP_FILTERS_FFT_CONVOLUTION_STATE_LENGTH( num_taps, block_length );
+    dsp_complex_t* error = (dsp_complex_t*) (power + block_length + 2);
+    dsp_complex_t* gradient = error + block_length;
+    int32_t log2_fft_length = 0, index, error_shift, headroom, shift, max_zeroes = 0, zeroes;
+    uint32_t regularization, r;
+    int64_t total = 0;
+    dsp_complex_t* x;
+
+    while( (1 << log2_fft_length) < fft_length ) ++log2_fft_length;
+
+    // Filter with the current weights; this also moves the spectrum of the
+    // input frame into the newest slot of the delay line.
+
+    dsp_filters_fft_convolution( input_samples, output_samples, state_data, num_taps,
+                                 block_length, q_format, sine, sin2 );
+    index = state_data[0];
+
+    // Error spectrum, of a frame whose first half is zero. Normalized before
+    // and after the FFT, as the input spectra are.
+
+    for( int32_t i = 0; i < block_length; ++i ) {
+        ((int32_t*) error)[i] = 0;
+        ((int32_t*) error)[block_length + i] = error_samples[i] = reference_samples[i] - output_samples[i];
+    }
+    error_shift = dsp_bfp_cls( error, block_length ) - 1;
+    dsp_bfp_shl( error, block_length, error_shift );
+    dsp_fft_bit_reverse_and_forward_real( (int32_t*) error, fft_length, sine, sin2 );
+    headroom = dsp_bfp_cls( error, block_length ) - 1;
+    dsp_bfp_shl( error, block_length, headroom );
+    error_shift += headroom;
+
+    // Smoothed power of the input per bin, in units of 2^31 squared samples.
+    // Element 0 of a spectrum packs DC and Nyquist; their powers are kept in
+    // power[0] and power[B].
+
+    x = delay_line + index * block_length;
+    shift = 30 + 2 * shifts[index];
+    for( int32_t k = 0; k <= block_length; ++k ) {
+        int64_t p;
+        if( k == 0 ) {
+            p = ((int64_t) x[0].re * x[0].re) >> 1;
+        } else if( k == block_length ) {
+            p = ((int64_t) x[0].im * x[0].im) >> 1;
+        } else {
+            p = (((int64_t) x[k].re * x[k].re) >> 1) + (((int64_t) x[k].im * x[k].im) >> 1);
+        }
+        p = (shift > 62) ? 0 : p >> shift;
+        if( p > 0x7fffffff ) p = 0x7fffffff;
+        if( p > power[k] ) power[k] = p;
+        else power[k] += ((int32_t) p - power[k]) >> 3;
+        total += power[k];
+    }
+    regularization = (total >> (log2_fft_length + 5)) + 1;
+
+    // Normalized error, mu * E[k] / (P[k] + regularization), in place. Each
+    // reciprocal is a mantissa r with exponent zeroes: 1/d = r * 2^(zeroes-62).
+    // All bins are aligned to the largest exponent, the bin with least power.
+
+    for( int32_t k = 0; k <= block_length; ++k ) {
+        r = power[k] + regularization;
+        asm("clz %0,%1":"=r"(zeroes):"r"(r));
+        if( zeroes > max_zeroes ) max_zeroes = zeroes;
+    }
+    for( int32_t k = 0; k < block_length; ++k ) {
+        int64_t re = ((int64_t) error[k].re * mu) >> 31;
+        int64_t im = ((int64_t) error[k].im * mu) >> 31;
+        r = _dsp_adaptive_fdaf__reciprocal( power[k] + regularization, &zeroes );
+        error[k].re = (re * r) >> (31 + max_zeroes - zeroes);
+        if( k == 0 ) {
+            r = _dsp_adaptive_fdaf__reciprocal( power[block_length] + regularization, &zeroes );
+        }
+        error[k].im = (im * r) >> (31 + max_zeroes - zeroes);
+    }
+    headroom = dsp_bfp_cls( error, block_length ) - 2;
+    dsp_bfp_shl( error, block_length, headroom );
+
+    // Exponent of a gradient relative to the weights, before the shift of
+    // the input spectrum it is computed from is taken into account.
+
+    error_shift = max_zeroes - headroom - error_shift + q_format - log2_fft_length - 31
+                - _dsp_adaptive_fdaf__weight_shift( partitions, q_format );
+
+    for( int32_t p = 0; p < partitions; ++p )
+    {
+        int32_t slot = index + p;
+        if( slot >= partitions ) slot -= partitions;
+        x = delay_line + slot * block_length;
+
+        // gradient = conj(X) * E, with DC and Nyquist multiplied separately
+
+        dsp_complex_mul_conjugate_vector3( gradient, error, x, block_length, 31 );
+        gradient[0].re = ((int64_t) error[0].re * x[0].re) >> 31;
+        gradient[0].im = ((int64_t) error[0].im * x[0].im) >> 31;
+        shift = error_shift - shifts[slot];
+
+        // Constrain the gradient to the first half of the frame, which holds
+        // the B taps of the partition.
+
+        if( constrained ) {
+            headroom = dsp_bfp_cls( gradient, block_length ) - (log2_fft_length + 3);
+            dsp_bfp_shl( gradient, block_length, headroom );
+            dsp_fft_bit_reverse_and_inverse_real( (int32_t*) gradient, fft_length, sine, sin2 );
+            for( int32_t i = block_length; i < fft_length; ++i ) ((int32_t*) gradient)[i] = 0;
+            shift -= headroom;
+            headroom = dsp_bfp_cls( gradient, block_length ) - 1;
+            dsp_bfp_shl( gradient, block_length, headroom );
+            dsp_fft_bit_reverse_and_forward_real( (int32_t*) gradient, fft_length, sine, sin2 );
+            shift -= headroom;
+        }
+        if( shift < -31 ) shift = -31;
+        dsp_complex_add_vector_shl( weights + p * block_length, gradient, block_length, shift );
+    }
+
+    // Rounding errors in the updates are not constrained, and would build up
+    // in the second half of the weights. Constrain the weights themselves,
+    // one partition per block.
+
+    if( constrained ) {
+        dsp_complex_t* w = weights + index * block_length;
+        for( int32_t k = 0; k < block_length; ++k ) gradient[k] = w[k];
+        shift = dsp_bfp_cls( gradient, block_length ) - (log2_fft_length + 3);
+        dsp_bfp_shl( gradient, block_length, shift );
+        dsp_fft_bit_reverse_and_inverse_real( (int32_t*) gradient, fft_length, sine, sin2 );
+        for( int32_t i = block_length; i < fft_length; ++i ) ((int32_t*) gradient)[i] = 0;
+        headroom = dsp_bfp_cls( gradient, block_length ) - 1;
+        dsp_bfp_shl( gradient, block_length, headroom );
+        dsp_fft_bit_reverse_and_forward_real( (int32_t*) gradient, fft_length, sine, sin2 );
+        shift += headroom;
+        if( shift > 31 ) shift = 31;
+        for( int32_t k = 0; k < block_length; ++k ) w[k].re = w[k].im = 0;
+        dsp_complex_add_vector_shl( w, gradient, block_length, -shift );
+    }
+}
+
+#endif
@@ -0,0 +1,204 @@
+// Copyright (c) 2017, XMOS Ltd, All rights reserved
+#include <stdint.h>
+#include "dsp_dct.h"
+#include "dsp_fft.h"
+
+/* DCTs of N points computed through an N/2 point complex FFT. The pre- and
+ * post-twiddles combine the packing of a real signal into a half length
+ * complex FFT with the rotations of the DCT, so that there is a single pass
+ * over the data either side of the FFT.
+ *
+ * All twiddle factors are read from the 8N point sine table, which holds
+ * sin(2*pi*t/(8N)) for t = 0..2N, or from the shared table with a stride
+ * when DSP_SINE_SHARED is set.
+ */
+
+static inline void _dsp_dct__twiddle( const int32_t sine[], uint32_t quarter,
+                                      uint32_t t, int32_t* c, int32_t* s )
+{
+#if DSP_SINE_SHARED
+    // Every (DSP_SINE_SHARED/8N)th value of the shared table
+    uint32_t stride = DSP_SINE_STRIDE(4*quarter);
+    quarter *= stride;
+    t *= stride;
+#endif
+    switch( t / quarter ) {
+        case 0: *c = sine[quarter - t]; *s = sine[t]; break;
+        case 1: *c = -sine[t - quarter]; *s = sine[2*quarter - t]; break;
+        case 2: *c = -sine[3*quarter - t]; *s = -sine[t - 2*quarter]; break;
+        default: *c = sine[t - 3*quarter]; *s = -sine[4*quarter - t]; break;
+    }
+}
+
+static inline int32_t _dsp_dct__round( int64_t x, const int32_t shift )
+{
+    return (int32_t) ((x + (1LL << (shift - 1))) >> shift);
+}
+
+
+
+// DCT-II: v[n] = x[2n], v[N-1-n] = x[2n+1] is packed as z[n] = v[2n] + j*v[2n+1]
+// so that V = DFT(v) follows from Z = DFT(z) by
+//   V[k] = ((Z[k] + Z*[M-k]) - j*W_N^k*(Z[k] - Z*[M-k])) / 2
+// and X[k] = Re(W_4N^k * V[k]), X[N-k] = -Im(W_4N^k * V[k]).
+
+void dsp_dct_forward
+(
+    int32_t         output[],
+    const int32_t   input[],
+    dsp_complex_t   scratch[],
+    const uint32_t  N,
+    const int32_t   sine[],
+    const int32_t   dct_sine[]
+) {
+    uint32_t M = N >> 1, quarter = N << 1;
+    int32_t* v = (int32_t*) scratch;
+
+    for( uint32_t n = 0; n < M; ++n ) {
+        v[n] = input[2*n];
+        v[N - 1 - n] = input[2*n + 1];
+    }
+    dsp_fft_bit_reverse( scratch, M );
+    dsp_fft_forward( scratch, M, sine );
+
+    for( uint32_t k = 0; k <= M; ++k )
+    {
+        dsp_complex_t z = scratch[k == M ? 0 : k], zc = scratch[k == 0 ? 0 : M - k];
+        int32_t a_re = (z.re + (int64_t) zc.re) >> 1, a_im = (z.im - (int64_t) zc.im) >> 1;
+        int32_t b_re = (z.re - (int64_t) zc.re) >> 1, b_im = (z.im + (int64_t) zc.im) >> 1;
+        int32_t c, s, v_re, v_im;
+
+        // -j*W_N^k = -(s + j*c), and a further 1/2 to scale the output by 1/N
+        _dsp_dct__twiddle( dct_sine, quarter, 8*k, &c, &s );
+        v_re = _dsp_dct__round( (int64_t) a_re * (1LL << 31) - (int64_t) s * b_re + (int64_t) c * b_im, 32 );
+        v_im = _dsp_dct__round( (int64_t) a_im * (1LL << 31) - (int64_t) s * b_im - (int64_t) c * b_re, 32 );
+
+        _dsp_dct__twiddle( dct_sine, quarter, 2*k, &c, &s );
+        output[k] = _dsp_dct__round( (int64_t) c * v_re + (int64_t) s * v_im, 31 );
+        if( k != 0 && k != M ) {
+            output[N - k] = _dsp_dct__round( (int64_t) s * v_re - (int64_t) c * v_im, 31 );
+        }
+    }
+}
+
+
+
+// DCT-III, the inverse of the above: V[k] = W_4N^-k * (X[k] - j*X[N-k]), then
+//   Z[k] = (V[k] + V*[M-k]) + j*W_N^-k*(V[k] - V*[M-k])
+// and an unscaled inverse FFT recovers z, which unpacks into x.
+
+static inline void _dsp_dct__unrotate( const int32_t input[], const uint32_t N, const uint32_t k,
+                                       const int32_t dct_sine[], int32_t* v_re, int32_t* v_im )
+{
+    int32_t c, s, xk = input[k], xnk = (k == 0) ? 0 : input[N - k];
+    _dsp_dct__twiddle( dct_sine, N << 1, 2*k, &c, &s );
+    *v_re = _dsp_dct__round( (int64_t) c * xk + (int64_t) s * xnk, 31 );
+    *v_im = _dsp_dct__round( (int64_t) s * xk - (int64_t) c * xnk, 31 );
+}
+
+void dsp_dct_inverse
+(
+    int32_t         output[],
+    const int32_t   input[],
+    dsp_complex_t   scratch[],
+    const uint32_t  N,
+    const int32_t   sine[],
+    const int32_t   dct_sine[]
+) {
+    uint32_t M = N >> 1, quarter = N << 1;
+    int32_t* v = (int32_t*) scratch;
+
+    for( uint32_t k = 0; k < M; ++k )
+    {
+        int32_t vk_re, vk_im, vc_re, vc_im, c, s;
+        int64_t b_re, b_im;
+        _dsp_dct__unrotate( input, N, k, dct_sine, &vk_re, &vk_im );
+        _dsp_dct__unrotate( input, N, M - k, dct_sine, &vc_re, &vc_im );
+        b_re = (int64_t) vk_re - vc_re;
+        b_im = (int64_t) vk_im + vc_im;
+
+        // j*W_N^-k = -s + j*c; b is kept at full precision, which is within
+        // 64 bits given the headroom the unscaled inverse FFT needs anyway
+        _dsp_dct__twiddle( dct_sine, quarter, 8*k, &c, &s );
+        scratch[k].re = vk_re + vc_re + _dsp_dct__round( - s * b_re - c * b_im, 31 );
+        scratch[k].im = vk_im - vc_im + _dsp_dct__round( - s * b_im + c * b_re, 31 );
+    }
+    dsp_fft_bit_reverse( scratch, M );
+    dsp_fft_inverse( scratch, M, sine );
+
+    for( uint32_t n = 0; n < M; ++n ) {
+        output[2*n] = v[n];
+        output[2*n + 1] = v[N - 1 - n];
+    }
+}
+
+
+
+// DCT-IV: z[n] = (x[2n] + j*x[N-1-2n]) * W_8N^(4n+1), Z = DFT(z), and with
+// Y[k] = Z[k] * W_8N^(4k), X[2k] = Re(Y[k]) and X[N-1-2k] = -Im(Y[k]).
+// The inverse uses the same rotations around a conjugated inverse FFT.
+
+static void _dsp_dct_iv
+(
+    int32_t         output[],
+    const int32_t   input[],
+    dsp_complex_t   scratch[],
+    const uint32_t  N,
+    const int32_t   sine[],
+    const int32_t   dct_sine[],
+    const int32_t   inverse
+) {
+    uint32_t M = N >> 1, quarter = N << 1;
+    int32_t conj = inverse ? -1 : 1;
+
+    // The forward rotation is halved, as x[2n] + j*x[N-1-2n] may exceed 1.0
+    int32_t shift = inverse ? 31 : 32;
+    for( uint32_t n = 0; n < M; ++n )
+    {
+        int32_t c, s, xa = input[2*n], xb = input[N - 1 - 2*n];
+        _dsp_dct__twiddle( dct_sine, quarter, 4*n + 1, &c, &s );
+        scratch[n].re = _dsp_dct__round( (int64_t) c * xa + (int64_t) s * xb, shift );
+        scratch[n].im = conj * _dsp_dct__round( (int64_t) c * xb - (int64_t) s * xa, shift );
+    }
+    dsp_fft_bit_reverse( scratch, M );
+    if( inverse ) {
+        dsp_fft_inverse( scratch, M, sine );
+    } else {
+        dsp_fft_forward( scratch, M, sine );
+    }
+
+    // The forward transform is scaled by 1/N overall; the inverse by 2, to
+    // undo it
+    shift = inverse ? 30 : 31;
+    for( uint32_t k = 0; k < M; ++k )
+    {
+        int32_t c, s, z_re = scratch[k].re, z_im = conj * scratch[k].im;
+        _dsp_dct__twiddle( dct_sine, quarter, 4*k, &c, &s );
+        output[2*k] = _dsp_dct__round( (int64_t) c * z_re + (int64_t) s * z_im, shift );
+        output[N - 1 - 2*k] = _dsp_dct__round( (int64_t) s * z_re - (int64_t) c * z_im, shift );
+    }
+}
+
+void dsp_dct_iv_forward
+(
+    int32_t         output[],
+    const int32_t   input[],
+    dsp_complex_t   scratch[],
+    const uint32_t  N,
+    const int32_t   sine[],
+    const int32_t   dct_sine[]
+) {
+    _dsp_dct_iv( output, input, scratch, N, sine, dct_sine, 0 );
+}
+
+void dsp_dct_iv_inverse
+(
+    int32_t         output[],
+    const int32_t   input[],
+    dsp_complex_t   scratch[],
+    const uint32_t  N,
+    const int32_t   sine[],
+    const int32_t   dct_sine[]
+) {
+    _dsp_dct_iv( output, input, scratch, N, sine, dct_sine, 1 );
+}
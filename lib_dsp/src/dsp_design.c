@@ -4,6 +4,7 @@
 #include <stdio.h>
 #include <dsp_design.h>
 #include <math.h>
+#include <dsp_math.h>
 
 static double pi = 3.14159265359;
 
@@ -252,3 +253,229 @@ void dsp_design_biquad_highshelf
 	coefficients[3] = _float2fixed( -a1/a0, q_format );
 	coefficients[4] = _float2fixed( -a2/a0, q_format );
 }
+
+
+
+/* Fixed-point design. The RBJ cookbook formulas are evaluated with Q28
+ * intermediates in 64-bit integers, using the Q8.24 functions of dsp_math
+ * for the transcendental parts, so a control task can redesign a filter
+ * without the floating-point emulation cost of the functions above. The
+ * half angle pi*F is used for sin and cos, and sin(w0) and cos(w0) are
+ * formed by the double angle formulas, which keeps 1 - cos(w0) accurate at
+ * low frequencies.
+ */
+
+#define _DSP_DESIGN_ONE  (1LL << 28)
+#define _DSP_DESIGN_LN10_OVER_40_Q31 (123619096)
+
+static inline int64_t _dsp_design__mul( int64_t a, int64_t b )
+{
+    return (a * b + (1 << 27)) >> 28;
+}
+
+static inline int32_t _dsp_design__div( int64_t x, int64_t d, int32_t q )
+{
+    int64_t n = x << q;
+    return (int32_t) ((n >= 0 ? n + d/2 : n - d/2) / d);
+}
+
+// sin(w0) and cos(w0) in Q28 for a frequency in Q31, relative to Fs
+static void _dsp_design__angle( int32_t frequency, int64_t* sin_w0, int64_t* cos_w0 )
+{
+    q8_24 h = (q8_24) (((int64_t) frequency * PI_Q8_24 + (1 << 30)) >> 31);
+    int64_t s = dsp_math_sin( h ), c = dsp_math_cos( h );
+    *sin_w0 = (s * c + (1 << 18)) >> 19;
+    *cos_w0 = _DSP_DESIGN_ONE - ((s * s + (1 << 18)) >> 19);
+}
+
+// 10^(gain_db/40) in Q8.24, the amplitude A of the cookbook formulas
+static q8_24 _dsp_design__exponent( q8_24 gain_db )
+{
+    return (q8_24) (((int64_t) gain_db * _DSP_DESIGN_LN10_OVER_40_Q31 + (1 << 30)) >> 31);
+}
+
+// Divides b0,b1,b2,a1,a2 by a0 and scales the numerator by gain (Q28).
+// All six values are first scaled by the same power of two to bring a0
+// below 2, so that shifting by q_format cannot overflow.
+static void _dsp_design__store( int64_t b0, int64_t b1, int64_t b2,
+                                int64_t a0, int64_t a1, int64_t a2, int64_t gain,
+                                int32_t coefficients[5], const int32_t q_format )
+{
+    while( a0 >= 2 * _DSP_DESIGN_ONE ) {
+        b0 = (b0 + 1) >> 1; b1 = (b1 + 1) >> 1; b2 = (b2 + 1) >> 1;
+        a0 = (a0 + 1) >> 1; a1 = (a1 + 1) >> 1; a2 = (a2 + 1) >> 1;
+    }
+    coefficients[0] = _dsp_design__mul( _dsp_design__div( b0, a0, q_format ), gain );
+    coefficients[1] = _dsp_design__mul( _dsp_design__div( b1, a0, q_format ), gain );
+    coefficients[2] = _dsp_design__mul( _dsp_design__div( b2, a0, q_format ), gain );
+    coefficients[3] = _dsp_design__div( -a1, a0, q_format );
+    coefficients[4] = _dsp_design__div( -a2, a0, q_format );
+}
+
+
+
+void dsp_design_biquad_notch_fixed
+(
+    int32_t frequency,
+    q8_24   filter_Q,
+    int32_t coefficients[5],
+    const int32_t q_format
+) {
+    int64_t sin_w0, cos_w0, alpha;
+    _dsp_design__angle( frequency, &sin_w0, &cos_w0 );
+    alpha = (sin_w0 << 23) / filter_Q;
+
+    _dsp_design__store( _DSP_DESIGN_ONE, -2 * cos_w0, _DSP_DESIGN_ONE,
+                        _DSP_DESIGN_ONE + alpha, -2 * cos_w0, _DSP_DESIGN_ONE - alpha,
+                        _DSP_DESIGN_ONE, coefficients, q_format );
+}
+
+
+
+void dsp_design_biquad_lowpass_fixed
+(
+    int32_t frequency,
+    q8_24   filter_Q,
+    int32_t coefficients[5],
+    const int32_t q_format
+) {
+    int64_t sin_w0, cos_w0, alpha;
+    _dsp_design__angle( frequency, &sin_w0, &cos_w0 );
+    alpha = (sin_w0 << 23) / filter_Q;
+
+    _dsp_design__store( (_DSP_DESIGN_ONE - cos_w0) / 2, _DSP_DESIGN_ONE - cos_w0,
+                        (_DSP_DESIGN_ONE - cos_w0) / 2,
+                        _DSP_DESIGN_ONE + alpha, -2 * cos_w0, _DSP_DESIGN_ONE - alpha,
+                        _DSP_DESIGN_ONE, coefficients, q_format );
+}
+
+
+
+void dsp_design_biquad_highpass_fixed
+(
+    int32_t frequency,
+    q8_24   filter_Q,
+    int32_t coefficients[5],
+    const int32_t q_format
+) {
+    int64_t sin_w0, cos_w0, alpha;
+    _dsp_design__angle( frequency, &sin_w0, &cos_w0 );
+    alpha = (sin_w0 << 23) / filter_Q;
+
+    _dsp_design__store( (_DSP_DESIGN_ONE + cos_w0) / 2, -(_DSP_DESIGN_ONE + cos_w0),
+                        (_DSP_DESIGN_ONE + cos_w0) / 2,
+                        _DSP_DESIGN_ONE + alpha, -2 * cos_w0, _DSP_DESIGN_ONE - alpha,
+                        _DSP_DESIGN_ONE, coefficients, q_format );
+}
+
+
+
+void dsp_design_biquad_allpass_fixed
+(
+    int32_t frequency,
+    q8_24   filter_Q,
+    int32_t coefficients[5],
+    const int32_t q_format
+) {
+    int64_t sin_w0, cos_w0, alpha;
+    _dsp_design__angle( frequency, &sin_w0, &cos_w0 );
+    alpha = (sin_w0 << 23) / filter_Q;
+
+    _dsp_design__store( _DSP_DESIGN_ONE - alpha, -2 * cos_w0, _DSP_DESIGN_ONE + alpha,
+                        _DSP_DESIGN_ONE + alpha, -2 * cos_w0, _DSP_DESIGN_ONE - alpha,
+                        _DSP_DESIGN_ONE, coefficients, q_format );
+}
+
+
+
+void dsp_design_biquad_peaking_fixed
+(
+    int32_t frequency,
+    q8_24   filter_Q,
+    q8_24   gain_db,
+    int32_t coefficients[5],
+    const int32_t q_format
+) {
+    int64_t sin_w0, cos_w0, alpha, alpha_A, alpha_over_A;
+    q8_24 x = _dsp_design__exponent( gain_db );
+    int64_t A = (int64_t) dsp_math_exp( x ) << 4;
+    int64_t inv_A = (int64_t) dsp_math_exp( -x ) << 4;
+
+    _dsp_design__angle( frequency, &sin_w0, &cos_w0 );
+    alpha = (sin_w0 << 23) / filter_Q;
+    alpha_A = _dsp_design__mul( alpha, A );
+    alpha_over_A = _dsp_design__mul( alpha, inv_A );
+
+    _dsp_design__store( _DSP_DESIGN_ONE + alpha_A, -2 * cos_w0, _DSP_DESIGN_ONE - alpha_A,
+                        _DSP_DESIGN_ONE + alpha_over_A, -2 * cos_w0, _DSP_DESIGN_ONE - alpha_over_A,
+                        _DSP_DESIGN_ONE, coefficients, q_format );
+}
+
+
+
+// Common factors of the shelving filters: A+1, A-1, 2*sqrt(A)*alpha, and A
+// itself, which is applied to the numerator after the division by a0
+
+static void _dsp_design__shelf( int32_t frequency, q8_24 filter_Q, q8_24 shelf_gain_db,
+                                int64_t* cos_w0, int64_t* Ap1, int64_t* Am1,
+                                int64_t* beta, int64_t* A )
+{
+    int64_t sin_w0, inv_Q, root;
+    q8_24 x = _dsp_design__exponent( shelf_gain_db );
+    int64_t A24 = dsp_math_exp( x );
+    int64_t inv_A24 = dsp_math_exp( -x );
+    int64_t sqrt_A = (int64_t) dsp_math_exp( x / 2 ) << 4;
+
+    _dsp_design__angle( frequency, &sin_w0, cos_w0 );
+
+    // alpha = sin(w0)/2 * sqrt( (A + 1/A)*(1/Q - 1) + 2 )
+    inv_Q = (1LL << 48) / filter_Q;
+    root = dsp_math_sqrt( (uq8_24) ((((A24 + inv_A24) * (inv_Q - (1 << 24))) >> 24) + (2 << 24)) );
+
+    *A = A24 << 4;
+    *Ap1 = *A + _DSP_DESIGN_ONE;
+    *Am1 = *A - _DSP_DESIGN_ONE;
+    *beta = _dsp_design__mul( sqrt_A, (sin_w0 * root + (1 << 23)) >> 24 );
+}
+
+
+
+void dsp_design_biquad_lowshelf_fixed
+(
+    int32_t frequency,
+    q8_24   filter_Q,
+    q8_24   shelf_gain_db,
+    int32_t coefficients[5],
+    const int32_t q_format
+) {
+    int64_t cos_w0, Ap1, Am1, beta, A;
+    _dsp_design__shelf( frequency, filter_Q, shelf_gain_db, &cos_w0, &Ap1, &Am1, &beta, &A );
+
+    int64_t Am1_cos = _dsp_design__mul( Am1, cos_w0 );
+    int64_t Ap1_cos = _dsp_design__mul( Ap1, cos_w0 );
+
+    _dsp_design__store( Ap1 - Am1_cos + beta, 2 * (Am1 - Ap1_cos), Ap1 - Am1_cos - beta,
+                        Ap1 + Am1_cos + beta, -2 * (Am1 + Ap1_cos), Ap1 + Am1_cos - beta,
+                        A, coefficients, q_format );
+}
+
+
+
+void dsp_design_biquad_highshelf_fixed
+(
+    int32_t frequency,
+    q8_24   filter_Q,
+    q8_24   shelf_gain_db,
+    int32_t coefficients[5],
+    const int32_t q_format
+) {
+    int64_t cos_w0, Ap1, Am1, beta, A;
+    _dsp_design__shelf( frequency, filter_Q, shelf_gain_db, &cos_w0, &Ap1, &Am1, &beta, &A );
+
+    int64_t Am1_cos = _dsp_design__mul( Am1, cos_w0 );
+    int64_t Ap1_cos = _dsp_design__mul( Ap1, cos_w0 );
+
+    _dsp_design__store( Ap1 + Am1_cos + beta, -2 * (Am1 + Ap1_cos), Ap1 + Am1_cos - beta,
+                        Ap1 - Am1_cos + beta, 2 * (Am1 - Ap1_cos), Ap1 - Am1_cos - beta,
+                        A, coefficients, q_format );
+}
@@ -0,0 +1,108 @@
+// Copyright (c) 2017, XMOS Ltd, All rights reserved
+#include <stdint.h>
+#include "dsp_fifo.h"
+
+// State layout: [0] write position, [1] read position, [2] block length,
+// [3] depth, then depth blocks. The positions count blocks modulo 2*depth,
+// so that a full FIFO (positions depth apart) differs from an empty one
+// (positions equal) without a division. Only the producer stores the write
+// position and only the consumer stores the read position; word stores are
+// atomic and memory is not cached, so each side only has to make sure the
+// compiler does not move its block accesses across the loads and stores
+// of the positions.
+
+#define _DSP_FIFO_WRITE  0
+#define _DSP_FIFO_READ   1
+#define _DSP_FIFO_LENGTH 2
+#define _DSP_FIFO_DEPTH  3
+#define _DSP_FIFO_BLOCKS 4
+
+static inline uint32_t _dsp_fifo__load( const int32_t fifo[], const int32_t i )
+{
+    uint32_t value = ((const volatile int32_t*) fifo)[i];
+    asm volatile("" ::: "memory");
+    return value;
+}
+
+static inline void _dsp_fifo__store( int32_t fifo[], const int32_t i, const uint32_t value )
+{
+    asm volatile("" ::: "memory");
+    ((volatile int32_t*) fifo)[i] = value;
+}
+
+// The block length and depth are stored as int32_t like the blocks, but
+// are unsigned
+
+static inline uint32_t _dsp_fifo__depth( const int32_t fifo[] )
+{
+    return (uint32_t) fifo[_DSP_FIFO_DEPTH];
+}
+
+static inline int32_t _dsp_fifo__offset( const int32_t fifo[], uint32_t position )
+{
+    uint32_t depth = _dsp_fifo__depth( fifo );
+    if( position >= depth ) position -= depth;
+    return _DSP_FIFO_BLOCKS + position * (uint32_t) fifo[_DSP_FIFO_LENGTH];
+}
+
+static inline uint32_t _dsp_fifo__next( const int32_t fifo[], const uint32_t position )
+{
+    return position + 1 == 2 * _dsp_fifo__depth( fifo ) ? 0 : position + 1;
+}
+
+void dsp_fifo_init( int32_t fifo[], const uint32_t block_length, const uint32_t depth )
+{
+    fifo[_DSP_FIFO_WRITE] = 0;
+    fifo[_DSP_FIFO_READ] = 0;
+    fifo[_DSP_FIFO_LENGTH] = block_length;
+    fifo[_DSP_FIFO_DEPTH] = depth;
+}
+
+uint32_t dsp_fifo_level( const int32_t fifo[] )
+{
+    uint32_t write = _dsp_fifo__load( fifo, _DSP_FIFO_WRITE );
+    uint32_t read = _dsp_fifo__load( fifo, _DSP_FIFO_READ );
+    return write >= read ? write - read : write + 2 * _dsp_fifo__depth( fifo ) - read;
+}
+
+int32_t dsp_fifo_write_reserve( const int32_t fifo[] )
+{
+    if( dsp_fifo_level( fifo ) == _dsp_fifo__depth( fifo ) ) return -1;
+    return _dsp_fifo__offset( fifo, _dsp_fifo__load( fifo, _DSP_FIFO_WRITE ) );
+}
+
+void dsp_fifo_write_commit( int32_t fifo[] )
+{
+    uint32_t write = _dsp_fifo__load( fifo, _DSP_FIFO_WRITE );
+    _dsp_fifo__store( fifo, _DSP_FIFO_WRITE, _dsp_fifo__next( fifo, write ) );
+}
+
+int32_t dsp_fifo_read_acquire( const int32_t fifo[] )
+{
+    if( dsp_fifo_level( fifo ) == 0 ) return -1;
+    return _dsp_fifo__offset( fifo, _dsp_fifo__load( fifo, _DSP_FIFO_READ ) );
+}
+
+void dsp_fifo_read_release( int32_t fifo[] )
+{
+    uint32_t read = _dsp_fifo__load( fifo, _DSP_FIFO_READ );
+    _dsp_fifo__store( fifo, _DSP_FIFO_READ, _dsp_fifo__next( fifo, read ) );
+}
+
+int32_t dsp_fifo_write( int32_t fifo[], const int32_t block[] )
+{
+    int32_t offset = dsp_fifo_write_reserve( fifo );
+    if( offset < 0 ) return 0;
+    for( int32_t i = 0; i < fifo[_DSP_FIFO_LENGTH]; ++i ) fifo[offset + i] = block[i];
+    dsp_fifo_write_commit( fifo );
+    return 1;
+}
+
+int32_t dsp_fifo_read( int32_t fifo[], int32_t block[] )
+{
+    int32_t offset = dsp_fifo_read_acquire( fifo );
+    if( offset < 0 ) return 0;
+    for( int32_t i = 0; i < fifo[_DSP_FIFO_LENGTH]; ++i ) block[i] = fifo[offset + i];
+    dsp_fifo_read_release( fifo );
+    return 1;
+}
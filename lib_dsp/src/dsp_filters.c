@@ -7,6 +7,9 @@
 #include "dsp_vector.h"
 #include "dsp_statistics.h"
 #include "dsp_filters.h"
+#include "dsp_complex.h"
+#include "dsp_fft.h"
+#include "dsp_bfp.h"
 
 
 
@@ -1108,6 +1111,200 @@ void dsp_filters_fir_add_sample
     }
 }
 
+// FIR filter over a contiguous history window (no state data shifting - for internal use only)
+// The coefficients must be double word aligned, the window may start on any word boundary.
+
+static int32_t _dsp_filters_fir_block__window
+(
+    const int32_t* coeff,
+    const int32_t* window,
+    int32_t        taps,
+    int32_t        format
+) {
+    int32_t ah = 0, b0, b1, s0, s1, c;
+    uint32_t al = 1 << (format-1);
+
+    if( ((uint32_t)window & 7) == 0 )
+    {
+        while( taps >= 4 )
+        {
+            asm("ldd %0,%1,%2[0]":"=r"(b1),"=r"(b0):"r"(coeff));
+            asm("ldd %0,%1,%2[0]":"=r"(s1),"=r"(s0):"r"(window));
+            asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(s0),"0"(ah),"1"(al));
+            asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(s1),"0"(ah),"1"(al));
+            asm("ldd %0,%1,%2[1]":"=r"(b1),"=r"(b0):"r"(coeff));
+            asm("ldd %0,%1,%2[1]":"=r"(s1),"=r"(s0):"r"(window));
+            asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(s0),"0"(ah),"1"(al));
+            asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(s1),"0"(ah),"1"(al));
+            taps -= 4; coeff += 4; window += 4;
+        }
+        switch( taps )
+        {
+            case 3:
+            asm("ldd %0,%1,%2[0]":"=r"(b1),"=r"(b0):"r"(coeff));
+            asm("ldd %0,%1,%2[0]":"=r"(s1),"=r"(s0):"r"(window));
+            asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(s0),"0"(ah),"1"(al));
+            asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(s1),"0"(ah),"1"(al));
+            asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(coeff[2]),"r"(window[2]),"0"(ah),"1"(al));
+            break;
+
+            case 2:
+            asm("ldd %0,%1,%2[0]":"=r"(b1),"=r"(b0):"r"(coeff));
+            asm("ldd %0,%1,%2[0]":"=r"(s1),"=r"(s0):"r"(window));
+            asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(s0),"0"(ah),"1"(al));
+            asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(s1),"0"(ah),"1"(al));
+            break;
+
+            case 1:
+            asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(coeff[0]),"r"(window[0]),"0"(ah),"1"(al));
+            break;
+        }
+    }
+    else
+    {
+        // Odd word boundary: load aligned state pairs and carry the upper word
+        // into the next pair of multiplies.
+        --window;
+        c = window[1];
+        while( taps >= 4 )
+        {
+            asm("ldd %0,%1,%2[0]":"=r"(b1),"=r"(b0):"r"(coeff));
+            asm("ldd %0,%1,%2[1]":"=r"(s1),"=r"(s0):"r"(window));
+            asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(c),"0"(ah),"1"(al));
+            asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(s0),"0"(ah),"1"(al));
+            asm("ldd %0,%1,%2[1]":"=r"(b1),"=r"(b0):"r"(coeff));
+            asm("ldd %0,%1,%2[2]":"=r"(c),"=r"(s0):"r"(window));
+            asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(s1),"0"(ah),"1"(al));
+            asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(s0),"0"(ah),"1"(al));
+            taps -= 4; coeff += 4; window += 4;
+        }
+        switch( taps )
+        {
+            case 3:
+            asm("ldd %0,%1,%2[0]":"=r"(b1),"=r"(b0):"r"(coeff));
+            asm("ldd %0,%1,%2[1]":"=r"(s1),"=r"(s0):"r"(window));
+            asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(c),"0"(ah),"1"(al));
+            asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(s0),"0"(ah),"1"(al));
+            asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(coeff[2]),"r"(s1),"0"(ah),"1"(al));
+            break;
+
+            case 2:
+            asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(coeff[0]),"r"(c),"0"(ah),"1"(al));
+            asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(coeff[1]),"r"(window[2]),"0"(ah),"1"(al));
+            break;
+
+            case 1:
+            asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(coeff[0]),"r"(c),"0"(ah),"1"(al));
+            break;
+        }
+    }
+    asm("lsats %0,%1,%2":"=r"(ah),"=r"(al):"r"(format),"0"(ah),"1"(al));
+    asm("lextract %0,%1,%2,%3,32":"=r"(ah):"r"(ah),"r"(al),"r"(format));
+    return ah;
+}
+
+
+
+void dsp_filters_fir_block
+(
+    const int32_t  input_samples[],
+    int32_t        output_samples[],
+    const int32_t  num_samples,
+    const int32_t* filter_coeffs,
+    int32_t*       state_data,
+    const int32_t  num_taps,
+    const int32_t  q_format
+) {
+    // state_data[0] holds the position of the newest sample, state_data[1] is
+    // padding to keep the history double word aligned. Every sample is written
+    // twice, num_taps apart, so that the last num_taps samples are always
+    // available as one contiguous window history[index..index+num_taps-1].
+
+    int32_t  index   = state_data[0];
+    int32_t* history = state_data + 2;
+
+    for( int32_t i = 0; i < num_samples; ++i )
+    {
+        if( --index < 0 ) index = num_taps - 1;
+        history[index] = history[index + num_taps] = input_samples[i];
+        output_samples[i] = _dsp_filters_fir_block__window( filter_coeffs, history + index, num_taps, q_format );
+    }
+    state_data[0] = index;
+}
+
+
+
+void dsp_filters_resampler_init
+(
+    const int32_t* filter_coeffs,
+    const int32_t  num_taps,
+    const int32_t  interp_factor,
+    int32_t*       polyphase_coeffs,
+    int32_t*       state_data
+) {
+    int32_t taps = DSP_FILTERS_RESAMPLER_TAPS_PER_PHASE( num_taps, interp_factor );
+
+    /*
+    L = 3, N = 7, taps per phase = 4 (rounded up to an even count)
+
+    phase 0 <-- b0 b3 b6  0
+    phase 1 <-- b1 b4  0  0
+    phase 2 <-- b2 b5  0  0
+    */
+
+    for( int32_t p = 0; p < interp_factor; ++p )
+    {
+        for( int32_t k = 0; k < taps; ++k )
+        {
+            int32_t n = k * interp_factor + p;
+            *polyphase_coeffs++ = (n < num_taps) ? filter_coeffs[n] : 0;
+        }
+    }
+    for( int32_t i = 0; i < DSP_FILTERS_RESAMPLER_STATE_LENGTH( num_taps, interp_factor ); ++i )
+        state_data[i] = 0;
+}
+
+
+
+int32_t dsp_filters_resampler
+(
+    const int32_t  input_samples[],
+    const int32_t  num_samples,
+    int32_t        output_samples[],
+    const int32_t* polyphase_coeffs,
+    int32_t*       state_data,
+    const int32_t  num_taps,
+    const int32_t  interp_factor,
+    const int32_t  decim_factor,
+    const int32_t  q_format
+) {
+    // state_data[0] holds the position of the newest sample and state_data[1]
+    // the phase of the next output sample, relative to the newest input sample
+    // on the up-sampled time axis. Only the phases that are actually output
+    // are computed; the history is kept as per dsp_filters_fir_block.
+
+    int32_t  taps    = DSP_FILTERS_RESAMPLER_TAPS_PER_PHASE( num_taps, interp_factor );
+    int32_t  index   = state_data[0];
+    int32_t  phase   = state_data[1];
+    int32_t* history = state_data + 2;
+    int32_t  count   = 0;
+
+    for( int32_t i = 0; i < num_samples; ++i )
+    {
+        if( --index < 0 ) index = taps - 1;
+        history[index] = history[index + taps] = input_samples[i];
+        while( phase < interp_factor )
+        {
+            output_samples[count++] = _dsp_filters_fir_block__window( polyphase_coeffs + phase * taps, history + index, taps, q_format );
+            phase += decim_factor;
+        }
+        phase -= interp_factor;
+    }
+    state_data[0] = index;
+    state_data[1] = phase;
+    return count;
+}
+
 // FIR filter (even coeff array boundary, no state data shifting - for internal use only)
 
 int32_t _dsp_filters_interpolate__fir_even
@@ -1168,6 +1365,7 @@ int32_t _dsp_filters_interpolate__fir_even
         asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(s0),"0"(ah),"1"(al));
         asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(s1),"0"(ah),"1"(al));
         asm("ldd %0,%1,%2[2]":"=r"(b1),"=r"(b0):"r"(coeff));
+        asm("ldd %0,%1,%2[2]":"=r"(s1),"=r"(s0):"r"(state));
         asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(s0),"0"(ah),"1"(al));
         asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(s1),"0"(ah),"1"(al));
         break;
@@ -1205,6 +1403,7 @@ int32_t _dsp_filters_interpolate__fir_even
 
         case 2:
         asm("ldd %0,%1,%2[0]":"=r"(b1),"=r"(b0):"r"(coeff));
+        asm("ldd %0,%1,%2[0]":"=r"(s1),"=r"(s0):"r"(state));
         asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(s0),"0"(ah),"1"(al));
         asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(s1),"0"(ah),"1"(al));
         break;
@@ -1219,6 +1418,8 @@ int32_t _dsp_filters_interpolate__fir_even
 }
 
 // FIR filter (odd coeff array boundary, no state data shifting - for internal use only)
+// After the first tap the coefficients are double word aligned but the state
+// is not, so only the coefficients are loaded in pairs.
 
 int32_t _dsp_filters_interpolate__fir_odd
 (
@@ -1227,104 +1428,38 @@ int32_t _dsp_filters_interpolate__fir_odd
     int32_t        taps,
     int32_t        format
 ) {
-    int32_t ah = 0, b0, b1, s0, s1;
+    int32_t ah = 0, b0, b1;
     uint32_t al = 1 << (format-1);
 
     asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(coeff[0]),"r"(state[0]),"0"(ah),"1"(al));
-    --taps;
+    --taps; ++coeff; ++state;
 
     while( taps >= 8 )
     {
         asm("ldd %0,%1,%2[0]":"=r"(b1),"=r"(b0):"r"(coeff));
-        asm("ldd %0,%1,%2[0]":"=r"(s1),"=r"(s0):"r"(state));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(s0),"0"(ah),"1"(al));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(s1),"0"(ah),"1"(al));
+        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(state[0]),"0"(ah),"1"(al));
+        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(state[1]),"0"(ah),"1"(al));
         asm("ldd %0,%1,%2[1]":"=r"(b1),"=r"(b0):"r"(coeff));
-        asm("ldd %0,%1,%2[1]":"=r"(s1),"=r"(s0):"r"(state));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(s0),"0"(ah),"1"(al));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(s1),"0"(ah),"1"(al));
+        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(state[2]),"0"(ah),"1"(al));
+        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(state[3]),"0"(ah),"1"(al));
         asm("ldd %0,%1,%2[2]":"=r"(b1),"=r"(b0):"r"(coeff));
-        asm("ldd %0,%1,%2[2]":"=r"(s1),"=r"(s0):"r"(state));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(s0),"0"(ah),"1"(al));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(s1),"0"(ah),"1"(al));
+        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(state[4]),"0"(ah),"1"(al));
+        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(state[5]),"0"(ah),"1"(al));
         asm("ldd %0,%1,%2[3]":"=r"(b1),"=r"(b0):"r"(coeff));
-        asm("ldd %0,%1,%2[3]":"=r"(s1),"=r"(s0):"r"(state));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(s0),"0"(ah),"1"(al));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(s1),"0"(ah),"1"(al));
+        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(state[6]),"0"(ah),"1"(al));
+        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(state[7]),"0"(ah),"1"(al));
         taps -= 8; coeff += 8; state += 8;
     }
-    switch( taps )
+    while( taps >= 2 )
     {
-        case 7:
-        asm("ldd %0,%1,%2[0]":"=r"(b1),"=r"(b0):"r"(coeff));
-        asm("ldd %0,%1,%2[0]":"=r"(s1),"=r"(s0):"r"(state));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(s0),"0"(ah),"1"(al));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(s1),"0"(ah),"1"(al));
-        asm("ldd %0,%1,%2[1]":"=r"(b1),"=r"(b0):"r"(coeff));
-        asm("ldd %0,%1,%2[1]":"=r"(s1),"=r"(s0):"r"(state));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(s0),"0"(ah),"1"(al));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(s1),"0"(ah),"1"(al));
-        asm("ldd %0,%1,%2[2]":"=r"(b1),"=r"(b0):"r"(coeff));
-        asm("ldd %0,%1,%2[2]":"=r"(s1),"=r"(s0):"r"(state));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(s0),"0"(ah),"1"(al));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(s1),"0"(ah),"1"(al));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(coeff[6]),"r"(state[6]),"0"(ah),"1"(al));
-        break;
-
-        case 6:
-        asm("ldd %0,%1,%2[0]":"=r"(b1),"=r"(b0):"r"(coeff));
-        asm("ldd %0,%1,%2[0]":"=r"(s1),"=r"(s0):"r"(state));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(s0),"0"(ah),"1"(al));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(s1),"0"(ah),"1"(al));
-        asm("ldd %0,%1,%2[1]":"=r"(b1),"=r"(b0):"r"(coeff));
-        asm("ldd %0,%1,%2[1]":"=r"(s1),"=r"(s0):"r"(state));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(s0),"0"(ah),"1"(al));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(s1),"0"(ah),"1"(al));
-        asm("ldd %0,%1,%2[2]":"=r"(b1),"=r"(b0):"r"(coeff));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(s0),"0"(ah),"1"(al));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(s1),"0"(ah),"1"(al));
-        break;
-
-        case 5:
         asm("ldd %0,%1,%2[0]":"=r"(b1),"=r"(b0):"r"(coeff));
-        asm("ldd %0,%1,%2[0]":"=r"(s1),"=r"(s0):"r"(state));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(s0),"0"(ah),"1"(al));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(s1),"0"(ah),"1"(al));
-        asm("ldd %0,%1,%2[1]":"=r"(b1),"=r"(b0):"r"(coeff));
-        asm("ldd %0,%1,%2[1]":"=r"(s1),"=r"(s0):"r"(state));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(s0),"0"(ah),"1"(al));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(s1),"0"(ah),"1"(al));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(coeff[4]),"r"(state[4]),"0"(ah),"1"(al));
-        break;
-
-        case 4:
-        asm("ldd %0,%1,%2[0]":"=r"(b1),"=r"(b0):"r"(coeff));
-        asm("ldd %0,%1,%2[0]":"=r"(s1),"=r"(s0):"r"(state));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(s0),"0"(ah),"1"(al));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(s1),"0"(ah),"1"(al));
-        asm("ldd %0,%1,%2[1]":"=r"(b1),"=r"(b0):"r"(coeff));
-        asm("ldd %0,%1,%2[1]":"=r"(s1),"=r"(s0):"r"(state));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(s0),"0"(ah),"1"(al));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(s1),"0"(ah),"1"(al));
-        break;
-
-        case 3:
-        asm("ldd %0,%1,%2[0]":"=r"(b1),"=r"(b0):"r"(coeff));
-        asm("ldd %0,%1,%2[0]":"=r"(s1),"=r"(s0):"r"(state));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(s0),"0"(ah),"1"(al));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(s1),"0"(ah),"1"(al));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(coeff[2]),"r"(state[2]),"0"(ah),"1"(al));
-        break;
-
-        case 2:
-        asm("ldd %0,%1,%2[0]":"=r"(b1),"=r"(b0):"r"(coeff));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(s0),"0"(ah),"1"(al));
-        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(s1),"0"(ah),"1"(al));
-        break;
-
-        case 1:
+        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(state[0]),"0"(ah),"1"(al));
+        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(state[1]),"0"(ah),"1"(al));
+        taps -= 2; coeff += 2; state += 2;
+    }
+    if( taps )
+    {
         asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(coeff[0]),"r"(state[0]),"0"(ah),"1"(al));
-        break;
     }
     asm("lsats %0,%1,%2":"=r"(ah),"=r"(al):"r"(format),"0"(ah),"1"(al));
     asm("lextract %0,%1,%2,%3,32":"=r"(ah):"r"(ah),"r"(al),"r"(format));
@@ -1451,7 +1586,7 @@ int32_t dsp_filters_decimate
     const int32_t q_format
 ) {
     int32_t  output;
-    int32_t* dst = state_data + num_taps - 1;
+    int32_t* dst = state_data + num_taps - 2;
     int32_t* src = dst - (decim_factor-1);
 
     /*
@@ -1462,13 +1597,392 @@ int32_t dsp_filters_decimate
     */
 
     output = dsp_filters_fir( input_samples[0], filter_coeffs, state_data, num_taps, q_format );
-    for( int32_t i = 0; i < num_taps - (decim_factor-1); ++i ) *dst-- = *src--;
+    for( int32_t i = 0; i < num_taps - decim_factor; ++i ) *dst-- = *src--;
     for( int32_t i = 0; i < decim_factor-1; ++i ) state_data[i] = input_samples[i+1];
     return output;
 }
 
 
 
+// Symmetric and sparse FIR filters. These keep the input history in the
+// double length buffer of dsp_filters_fir_block(): state_data[0] holds the
+// position of the newest sample, and the last num_taps samples are always
+// the contiguous window history[index..index+num_taps-1], newest first.
+
+static inline const int32_t* _dsp_filters_fir__push
+(
+    int32_t*      state_data,
+    const int32_t num_taps,
+    const int32_t sample
+) {
+    int32_t  index   = state_data[0];
+    int32_t* history = state_data + 2;
+
+    if( --index < 0 ) index = num_taps - 1;
+    history[index] = history[index + num_taps] = sample;
+    state_data[0] = index;
+    return history + index;
+}
+
+// Sum of coeff[k] * (window[k] + window[taps-1-k]) over the first half of
+// the window, plus the middle tap of an odd length filter. Each pair of
+// mirrored samples is added in 32 bits before the multiply; when the sum
+// overflows, the lost carry of coeff * 2^32 goes into the high word of the
+// accumulator, so the result is that of dsp_filters_fir().
+
+#define _DSP_FILTERS_FIR_PAIR(b, x, y) do { \
+    int32_t c = (b), u = (x), v = (y), s = (int32_t)((uint32_t)u + (uint32_t)v); \
+    asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(c),"r"(s),"0"(ah),"1"(al)); \
+    if( ((u ^ s) & (v ^ s)) < 0 ) ah += (s < 0) ? c : -c; \
+} while( 0 )
+
+static int32_t _dsp_filters_fir__symmetric_window
+(
+    const int32_t* coeff,
+    const int32_t* window,
+    int32_t        taps,
+    int32_t        format
+) {
+    int32_t ah = 0, b0, b1;
+    uint32_t al = 1 << (format-1);
+    const int32_t* mirror = window + taps - 1;
+    int32_t pairs = taps >> 1;
+
+    while( pairs >= 2 )
+    {
+        asm("ldd %0,%1,%2[0]":"=r"(b1),"=r"(b0):"r"(coeff));
+        _DSP_FILTERS_FIR_PAIR( b0, window[0], mirror[0] );
+        _DSP_FILTERS_FIR_PAIR( b1, window[1], mirror[-1] );
+        pairs -= 2; coeff += 2; window += 2; mirror -= 2;
+    }
+    if( pairs )
+    {
+        _DSP_FILTERS_FIR_PAIR( coeff[0], window[0], mirror[0] );
+        coeff += 1; window += 1;
+    }
+    if( taps & 1 )
+    {
+        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(coeff[0]),"r"(window[0]),"0"(ah),"1"(al));
+    }
+    asm("lsats %0,%1,%2":"=r"(ah),"=r"(al):"r"(format),"0"(ah),"1"(al));
+    asm("lextract %0,%1,%2,%3,32":"=r"(ah):"r"(ah),"r"(al),"r"(format));
+    return ah;
+}
+
+// Two phases of a symmetric interpolator, which use the same coefficients
+// in opposite orders: one pass computes both, loading each coefficient once.
+
+static void _dsp_filters_fir__mirrored_windows
+(
+    const int32_t* coeff,
+    const int32_t* window,
+    int32_t        taps,
+    int32_t        format,
+    int32_t*       forward,
+    int32_t*       reverse
+) {
+    int32_t fh = 0, rh = 0, b0, b1;
+    uint32_t fl = 1 << (format-1), rl = 1 << (format-1);
+    const int32_t* mirror = window + taps - 1;
+
+    while( taps >= 2 )
+    {
+        asm("ldd %0,%1,%2[0]":"=r"(b1),"=r"(b0):"r"(coeff));
+        asm("maccs %0,%1,%2,%3":"=r"(fh),"=r"(fl):"r"(b0),"r"(window[0]),"0"(fh),"1"(fl));
+        asm("maccs %0,%1,%2,%3":"=r"(rh),"=r"(rl):"r"(b0),"r"(mirror[0]),"0"(rh),"1"(rl));
+        asm("maccs %0,%1,%2,%3":"=r"(fh),"=r"(fl):"r"(b1),"r"(window[1]),"0"(fh),"1"(fl));
+        asm("maccs %0,%1,%2,%3":"=r"(rh),"=r"(rl):"r"(b1),"r"(mirror[-1]),"0"(rh),"1"(rl));
+        taps -= 2; coeff += 2; window += 2; mirror -= 2;
+    }
+    if( taps )
+    {
+        asm("maccs %0,%1,%2,%3":"=r"(fh),"=r"(fl):"r"(coeff[0]),"r"(window[0]),"0"(fh),"1"(fl));
+        asm("maccs %0,%1,%2,%3":"=r"(rh),"=r"(rl):"r"(coeff[0]),"r"(mirror[0]),"0"(rh),"1"(rl));
+    }
+    asm("lsats %0,%1,%2":"=r"(fh),"=r"(fl):"r"(format),"0"(fh),"1"(fl));
+    asm("lsats %0,%1,%2":"=r"(rh),"=r"(rl):"r"(format),"0"(rh),"1"(rl));
+    asm("lextract %0,%1,%2,%3,32":"=r"(fh):"r"(fh),"r"(fl),"r"(format));
+    asm("lextract %0,%1,%2,%3,32":"=r"(rh):"r"(rh),"r"(rl),"r"(format));
+    *forward = fh;
+    *reverse = rh;
+}
+
+// Sparse coefficients are a list of segments, each [start, length] followed
+// by length coefficients and a zero if length is odd, so that every segment
+// starts on a double word, and terminated by [0, 0]. The padding zero of a
+// segment is multiplied like the other coefficients; it may read one sample
+// past the end of the window, which is still inside the history buffer.
+
+static int32_t _dsp_filters_fir__sparse_window
+(
+    const int32_t*  sparse,
+    const int32_t*  window,
+    int32_t         format,
+    const int32_t** next
+) {
+    int32_t ah = 0, b0, b1, length;
+    uint32_t al = 1 << (format-1);
+
+    while( (length = sparse[1]) != 0 )
+    {
+        const int32_t* w = window + sparse[0];
+        sparse += 2;
+        for( int32_t n = (length + 1) >> 1; n > 0; --n )
+        {
+            asm("ldd %0,%1,%2[0]":"=r"(b1),"=r"(b0):"r"(sparse));
+            asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b0),"r"(w[0]),"0"(ah),"1"(al));
+            asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(b1),"r"(w[1]),"0"(ah),"1"(al));
+            sparse += 2; w += 2;
+        }
+    }
+    *next = sparse + 2;
+    asm("lsats %0,%1,%2":"=r"(ah),"=r"(al):"r"(format),"0"(ah),"1"(al));
+    asm("lextract %0,%1,%2,%3,32":"=r"(ah):"r"(ah),"r"(al),"r"(format));
+    return ah;
+}
+
+// Builds the segments of the taps coeff[first + k*stride], k < count, where
+// taps at or past num_taps are zero. A segment ends at the last non-zero tap
+// before a run of at least min_zero_run zeros.
+
+static inline int32_t _dsp_filters_fir__tap
+(
+    const int32_t* coeff,
+    const int32_t  n,
+    const int32_t  num_taps
+) {
+    return n < num_taps ? coeff[n] : 0;
+}
+
+static int32_t* _dsp_filters_fir__sparse_build
+(
+    const int32_t* coeff,
+    const int32_t  first,
+    const int32_t  stride,
+    const int32_t  count,
+    const int32_t  num_taps,
+    const int32_t  min_zero_run,
+    int32_t*       sparse
+) {
+    int32_t k = 0;
+
+    while( 1 )
+    {
+        int32_t start, end, zeros = 0;
+        while( k < count && _dsp_filters_fir__tap( coeff, first + k * stride, num_taps ) == 0 ) ++k;
+        if( k == count ) break;
+        start = end = k;
+        while( k < count )
+        {
+            if( _dsp_filters_fir__tap( coeff, first + k * stride, num_taps ) != 0 ) { end = k + 1; zeros = 0; }
+            else if( ++zeros >= min_zero_run ) break;
+            ++k;
+        }
+        *sparse++ = start;
+        *sparse++ = end - start;
+        for( k = start; k < end; ++k ) *sparse++ = _dsp_filters_fir__tap( coeff, first + k * stride, num_taps );
+        if( (end - start) & 1 ) *sparse++ = 0;
+    }
+    *sparse++ = 0;
+    *sparse++ = 0;
+    return sparse;
+}
+
+
+
+void dsp_filters_fir_symmetric_block
+(
+    const int32_t  input_samples[],
+    int32_t        output_samples[],
+    const int32_t  num_samples,
+    const int32_t* filter_coeffs,
+    int32_t*       state_data,
+    const int32_t  num_taps,
+    const int32_t  q_format
+) {
+    for( int32_t i = 0; i < num_samples; ++i )
+    {
+        const int32_t* window = _dsp_filters_fir__push( state_data, num_taps, input_samples[i] );
+        output_samples[i] = _dsp_filters_fir__symmetric_window( filter_coeffs, window, num_taps, q_format );
+    }
+}
+
+
+
+int32_t dsp_filters_decimate_symmetric
+(
+    const int32_t  input_samples[],
+    const int32_t* filter_coeffs,
+    int32_t*       state_data,
+    const int32_t  num_taps,
+    const int32_t  decim_factor,
+    const int32_t  q_format
+) {
+    // As dsp_filters_decimate(): input_samples[0] is filtered, and the others
+    // follow it in the history newest first
+    const int32_t* window = _dsp_filters_fir__push( state_data, num_taps, input_samples[0] );
+    int32_t output = _dsp_filters_fir__symmetric_window( filter_coeffs, window, num_taps, q_format );
+    for( int32_t i = decim_factor - 1; i > 0; --i )
+        _dsp_filters_fir__push( state_data, num_taps, input_samples[i] );
+    return output;
+}
+
+
+
+void dsp_filters_interpolate_symmetric_init
+(
+    const int32_t* filter_coeffs,
+    const int32_t  num_taps,
+    const int32_t  interp_factor,
+    int32_t*       polyphase_coeffs
+) {
+    int32_t taps = num_taps / interp_factor;
+    int32_t half = (num_taps + 1) / 2;
+
+    /*
+    L = 3, N = 12, phase p holds b(3k+p), and phase 2 is phase 0 reversed
+
+    phase 0 <-- b0 b3 b6 b9  =  b0 b3 b5 b2  (bn = b(N-1-n) for n >= N/2)
+    phase 1 <-- b1 b4 | b7 bA   only the first half, the phase is symmetric
+    phase 2 <-- b2 b5 b8 bB  =  phase 0 reversed, not stored
+    */
+
+    for( int32_t p = 0; p < (interp_factor + 1) / 2; ++p )
+    {
+        int32_t length = (2 * p + 1 == interp_factor) ? (taps + 1) / 2 : taps;
+        for( int32_t k = 0; k < length; ++k )
+        {
+            int32_t n = k * interp_factor + p;
+            *polyphase_coeffs++ = filter_coeffs[n < half ? n : num_taps - 1 - n];
+        }
+        if( length & 1 ) *polyphase_coeffs++ = 0;
+    }
+}
+
+
+
+void dsp_filters_interpolate_symmetric
+(
+    int32_t        input_sample,
+    const int32_t* polyphase_coeffs,
+    int32_t*       state_data,
+    const int32_t  num_taps,
+    const int32_t  interp_factor,
+    int32_t*       output_samples,
+    const int32_t  q_format
+) {
+    int32_t taps = num_taps / interp_factor;
+    const int32_t* window = _dsp_filters_fir__push( state_data, taps, input_sample );
+
+    for( int32_t p = 0; p < interp_factor / 2; ++p )
+    {
+        _dsp_filters_fir__mirrored_windows( polyphase_coeffs, window, taps, q_format,
+                                            &output_samples[p], &output_samples[interp_factor - 1 - p] );
+        polyphase_coeffs += (taps + 1) & ~1;
+    }
+    if( interp_factor & 1 )
+    {
+        output_samples[interp_factor / 2] =
+            _dsp_filters_fir__symmetric_window( polyphase_coeffs, window, taps, q_format );
+    }
+}
+
+
+
+int32_t dsp_filters_fir_sparse_init
+(
+    const int32_t* filter_coeffs,
+    const int32_t  num_taps,
+    const int32_t  min_zero_run,
+    int32_t*       sparse_coeffs
+) {
+    int32_t run = min_zero_run < 1 ? 1 : min_zero_run;
+    return _dsp_filters_fir__sparse_build( filter_coeffs, 0, 1, num_taps, num_taps, run,
+                                           sparse_coeffs ) - sparse_coeffs;
+}
+
+
+
+void dsp_filters_fir_sparse_block
+(
+    const int32_t  input_samples[],
+    int32_t        output_samples[],
+    const int32_t  num_samples,
+    const int32_t* sparse_coeffs,
+    int32_t*       state_data,
+    const int32_t  num_taps,
+    const int32_t  q_format
+) {
+    const int32_t* next;
+    for( int32_t i = 0; i < num_samples; ++i )
+    {
+        const int32_t* window = _dsp_filters_fir__push( state_data, num_taps, input_samples[i] );
+        output_samples[i] = _dsp_filters_fir__sparse_window( sparse_coeffs, window, q_format, &next );
+    }
+}
+
+
+
+int32_t dsp_filters_decimate_sparse
+(
+    const int32_t  input_samples[],
+    const int32_t* sparse_coeffs,
+    int32_t*       state_data,
+    const int32_t  num_taps,
+    const int32_t  decim_factor,
+    const int32_t  q_format
+) {
+    // As dsp_filters_decimate_symmetric()
+    const int32_t* next;
+    const int32_t* window = _dsp_filters_fir__push( state_data, num_taps, input_samples[0] );
+    int32_t output = _dsp_filters_fir__sparse_window( sparse_coeffs, window, q_format, &next );
+    for( int32_t i = decim_factor - 1; i > 0; --i )
+        _dsp_filters_fir__push( state_data, num_taps, input_samples[i] );
+    return output;
+}
+
+
+
+int32_t dsp_filters_interpolate_sparse_init
+(
+    const int32_t* filter_coeffs,
+    const int32_t  num_taps,
+    const int32_t  interp_factor,
+    const int32_t  min_zero_run,
+    int32_t*       sparse_coeffs
+) {
+    int32_t taps = (num_taps + interp_factor - 1) / interp_factor;
+    int32_t run = min_zero_run < 1 ? 1 : min_zero_run;
+    int32_t* sparse = sparse_coeffs;
+
+    // One list of segments per phase, phase p holding b(kL+p)
+    for( int32_t p = 0; p < interp_factor; ++p )
+        sparse = _dsp_filters_fir__sparse_build( filter_coeffs, p, interp_factor, taps, num_taps,
+                                                 run, sparse );
+    return sparse - sparse_coeffs;
+}
+
+
+
+void dsp_filters_interpolate_sparse
+(
+    int32_t        input_sample,
+    const int32_t* sparse_coeffs,
+    int32_t*       state_data,
+    const int32_t  num_taps,
+    const int32_t  interp_factor,
+    int32_t*       output_samples,
+    const int32_t  q_format
+) {
+    int32_t taps = (num_taps + interp_factor - 1) / interp_factor;
+    const int32_t* window = _dsp_filters_fir__push( state_data, taps, input_sample );
+
+    for( int32_t p = 0; p < interp_factor; ++p )
+        output_samples[p] = _dsp_filters_fir__sparse_window( sparse_coeffs, window, q_format, &sparse_coeffs );
+}
+
+
+
 int32_t dsp_filters_biquad
 (
     int32_t        input_sample,
@@ -1727,3 +2241,387 @@ int32_t dsp_filters_biquads
     }
     return 0;
 }
+
+
+
+void dsp_filters_biquads_interleaved
+(
+    const int32_t* input_samples,
+    int32_t*       output_samples,
+    const int32_t  num_channels,
+    const int32_t  num_samples,
+    const int32_t* filter_coeffs,
+    int32_t*       state_data,
+    const int32_t  num_sections,
+    const int32_t  q_format
+) {
+    uint32_t al; int32_t ah, x, s1,s2;
+    const int32_t* src = input_samples;
+
+    // Sections are processed one at a time across the whole frame so that the
+    // five coefficients of a section are loaded once per call, not once per
+    // sample. The state of a section is laid out channel after channel, in
+    // the same order as the interleaved samples are visited.
+
+    for( int32_t ns = 0; ns < num_sections; ++ns )
+    {
+        int32_t b0 = filter_coeffs[0], b1 = filter_coeffs[1], b2 = filter_coeffs[2];
+        int32_t a1 = filter_coeffs[3], a2 = filter_coeffs[4];
+        int32_t i = 0;
+
+        for( int32_t n = 0; n < num_samples; ++n )
+        {
+            int32_t* state = state_data;
+            for( int32_t ch = 0; ch < num_channels; ++ch )
+            {
+                x = src[i];
+                asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(x),"r"(b0),"0"(0),"1"(1<<(q_format-1)));
+                asm("ldd %0,%1,%2[0]":"=r"(s2),"=r"(s1):"r"(state));
+                asm("std %0,%1,%2[0]"::"r"(s1),"r"(x),"r"(state));
+                asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(s1),"r"(b1),"0"(ah),"1"(al));
+                asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(s2),"r"(b2),"0"(ah),"1"(al));
+                asm("ldd %0,%1,%2[1]":"=r"(s2),"=r"(s1):"r"(state));
+                asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(s1),"r"(a1),"0"(ah),"1"(al));
+                asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(s2),"r"(a2),"0"(ah),"1"(al));
+                asm("lsats %0,%1,%2":"=r"(ah),"=r"(al):"r"(q_format),"0"(ah),"1"(al));
+                asm("lextract %0,%1,%2,%3,32":"=r"(ah):"r"(ah),"r"(al),"r"(q_format));
+                asm("std %0,%1,%2[1]"::"r"(s1),"r"(ah),"r"(state));
+                output_samples[i++] = ah;
+                state += DSP_NUM_STATES_PER_BIQUAD;
+            }
+        }
+        src = output_samples;
+        filter_coeffs += DSP_NUM_COEFFS_PER_BIQUAD;
+        state_data += num_channels * DSP_NUM_STATES_PER_BIQUAD;
+    }
+}
+
+
+
+// One section for both channels of a stereo pair. The two channels use
+// separate accumulators and each coefficient is loaded once for both, just
+// before its two multiply-accumulates, so that the accumulators, the state
+// of one channel and the pointers stay in registers.
+
+static inline void _dsp_filters__biquad_stereo
+(
+    int32_t*       samples,
+    const int32_t* filter_coeffs,
+    int32_t*       state_data,
+    const int32_t  q_format
+) {
+    uint32_t all, alr; int32_t ahl, ahr, c, l1,l2, r1,r2;
+    int32_t xl = samples[0], xr = samples[1];
+
+    c = filter_coeffs[0];
+    asm("maccs %0,%1,%2,%3":"=r"(ahl),"=r"(all):"r"(xl),"r"(c),"0"(0),"1"(1<<(q_format-1)));
+    asm("maccs %0,%1,%2,%3":"=r"(ahr),"=r"(alr):"r"(xr),"r"(c),"0"(0),"1"(1<<(q_format-1)));
+    c = filter_coeffs[1];
+    asm("ldd %0,%1,%2[0]":"=r"(l2),"=r"(l1):"r"(state_data));
+    asm("std %0,%1,%2[0]"::"r"(l1),"r"(xl),"r"(state_data));
+    asm("maccs %0,%1,%2,%3":"=r"(ahl),"=r"(all):"r"(l1),"r"(c),"0"(ahl),"1"(all));
+    asm("ldd %0,%1,%2[2]":"=r"(r2),"=r"(r1):"r"(state_data));
+    asm("std %0,%1,%2[2]"::"r"(r1),"r"(xr),"r"(state_data));
+    asm("maccs %0,%1,%2,%3":"=r"(ahr),"=r"(alr):"r"(r1),"r"(c),"0"(ahr),"1"(alr));
+    c = filter_coeffs[2];
+    asm("maccs %0,%1,%2,%3":"=r"(ahl),"=r"(all):"r"(l2),"r"(c),"0"(ahl),"1"(all));
+    asm("maccs %0,%1,%2,%3":"=r"(ahr),"=r"(alr):"r"(r2),"r"(c),"0"(ahr),"1"(alr));
+    c = filter_coeffs[3];
+    asm("ldd %0,%1,%2[1]":"=r"(l2),"=r"(l1):"r"(state_data));
+    asm("maccs %0,%1,%2,%3":"=r"(ahl),"=r"(all):"r"(l1),"r"(c),"0"(ahl),"1"(all));
+    asm("ldd %0,%1,%2[3]":"=r"(r2),"=r"(r1):"r"(state_data));
+    asm("maccs %0,%1,%2,%3":"=r"(ahr),"=r"(alr):"r"(r1),"r"(c),"0"(ahr),"1"(alr));
+    c = filter_coeffs[4];
+    asm("maccs %0,%1,%2,%3":"=r"(ahl),"=r"(all):"r"(l2),"r"(c),"0"(ahl),"1"(all));
+    asm("maccs %0,%1,%2,%3":"=r"(ahr),"=r"(alr):"r"(r2),"r"(c),"0"(ahr),"1"(alr));
+    asm("lsats %0,%1,%2":"=r"(ahl),"=r"(all):"r"(q_format),"0"(ahl),"1"(all));
+    asm("lextract %0,%1,%2,%3,32":"=r"(ahl):"r"(ahl),"r"(all),"r"(q_format));
+    asm("std %0,%1,%2[1]"::"r"(l1),"r"(ahl),"r"(state_data));
+    asm("lsats %0,%1,%2":"=r"(ahr),"=r"(alr):"r"(q_format),"0"(ahr),"1"(alr));
+    asm("lextract %0,%1,%2,%3,32":"=r"(ahr):"r"(ahr),"r"(alr),"r"(q_format));
+    asm("std %0,%1,%2[3]"::"r"(r1),"r"(ahr),"r"(state_data));
+    samples[0] = ahl;
+    samples[1] = ahr;
+}
+
+
+
+void dsp_filters_biquad_stereo
+(
+    int32_t*       samples,
+    const int32_t* filter_coeffs,
+    int32_t*       state_data,
+    const int32_t  q_format
+) {
+    _dsp_filters__biquad_stereo( samples, filter_coeffs, state_data, q_format );
+}
+
+
+
+void dsp_filters_biquads_stereo
+(
+    int32_t*       samples,
+    const int32_t* filter_coeffs,
+    int32_t*       state_data,
+    const int32_t  num_sections,
+    const int32_t  q_format
+) {
+    for( int32_t ns = 0; ns < num_sections; ++ns )
+    {
+        _dsp_filters__biquad_stereo( samples, filter_coeffs, state_data, q_format );
+        filter_coeffs += DSP_NUM_COEFFS_PER_BIQUAD;
+        state_data += 2 * DSP_NUM_STATES_PER_BIQUAD;
+    }
+}
+
+
+
+// One sample of one section, as in dsp_filters_biquads_interleaved(), with
+// the coefficients passed in registers so that they can change per sample
+
+static inline int32_t _dsp_filters__biquad_step
+(
+    int32_t       x,
+    const int32_t b0, const int32_t b1, const int32_t b2,
+    const int32_t a1, const int32_t a2,
+    int32_t*      state,
+    const int32_t q_format
+) {
+    uint32_t al; int32_t ah, s1,s2;
+    asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(x),"r"(b0),"0"(0),"1"(1<<(q_format-1)));
+    asm("ldd %0,%1,%2[0]":"=r"(s2),"=r"(s1):"r"(state));
+    asm("std %0,%1,%2[0]"::"r"(s1),"r"(x),"r"(state));
+    asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(s1),"r"(b1),"0"(ah),"1"(al));
+    asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(s2),"r"(b2),"0"(ah),"1"(al));
+    asm("ldd %0,%1,%2[1]":"=r"(s2),"=r"(s1):"r"(state));
+    asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(s1),"r"(a1),"0"(ah),"1"(al));
+    asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(s2),"r"(a2),"0"(ah),"1"(al));
+    asm("lsats %0,%1,%2":"=r"(ah),"=r"(al):"r"(q_format),"0"(ah),"1"(al));
+    asm("lextract %0,%1,%2,%3,32":"=r"(ah):"r"(ah),"r"(al),"r"(q_format));
+    asm("std %0,%1,%2[1]"::"r"(s1),"r"(ah),"r"(state));
+    return ah;
+}
+
+
+
+void dsp_filters_biquads_smooth
+(
+    const int32_t* input_samples,
+    int32_t*       output_samples,
+    const int32_t  num_samples,
+    int32_t*       filter_coeffs,
+    const int32_t* target_coeffs,
+    int32_t*       state_data,
+    const int32_t  num_sections,
+    const int32_t  q_format
+) {
+    const int32_t* src = input_samples;
+    int32_t last = num_samples - 1;
+
+    // Each section sweeps the whole block, as in the interleaved filter, so
+    // the coefficients and their per-sample steps stay in registers. The
+    // steps are truncated, and the last sample uses the target coefficients
+    // exactly, so the filter always ends the block on the target.
+
+    for( int32_t ns = 0; ns < num_sections; ++ns )
+    {
+        int32_t b0 = filter_coeffs[0], b1 = filter_coeffs[1], b2 = filter_coeffs[2];
+        int32_t a1 = filter_coeffs[3], a2 = filter_coeffs[4];
+        int32_t d0 = 0, d1 = 0, d2 = 0, d3 = 0, d4 = 0;
+
+        if( last > 0 )
+        {
+            d0 = ((int64_t) target_coeffs[0] - b0) / num_samples;
+            d1 = ((int64_t) target_coeffs[1] - b1) / num_samples;
+            d2 = ((int64_t) target_coeffs[2] - b2) / num_samples;
+            d3 = ((int64_t) target_coeffs[3] - a1) / num_samples;
+            d4 = ((int64_t) target_coeffs[4] - a2) / num_samples;
+        }
+        for( int32_t n = 0; n < last; ++n )
+        {
+            b0 += d0; b1 += d1; b2 += d2; a1 += d3; a2 += d4;
+            output_samples[n] = _dsp_filters__biquad_step( src[n], b0, b1, b2, a1, a2,
+                                                           state_data, q_format );
+        }
+        for( int32_t i = 0; i < DSP_NUM_COEFFS_PER_BIQUAD; ++i ) filter_coeffs[i] = target_coeffs[i];
+        if( last >= 0 )
+        {
+            output_samples[last] = _dsp_filters__biquad_step( src[last],
+                                                              target_coeffs[0], target_coeffs[1],
+                                                              target_coeffs[2], target_coeffs[3],
+                                                              target_coeffs[4], state_data, q_format );
+        }
+        src = output_samples;
+        filter_coeffs += DSP_NUM_COEFFS_PER_BIQUAD;
+        target_coeffs += DSP_NUM_COEFFS_PER_BIQUAD;
+        state_data += DSP_NUM_STATES_PER_BIQUAD;
+    }
+}
+
+
+#if defined(__XS2A__)
+
+// State layout of the FFT convolution, for P partitions of B taps:
+//   [0]                    index of the newest spectrum in the delay line
+//   [1]                    shift applied to the filter spectra (BFP exponent)
+//   [2 ... 2+P)            shift applied to each input spectrum, padded to even
+//   filter spectra         P x B complex bins
+//   input spectra          P x B complex bins, frequency-domain delay line
+//   input history          B samples, the previous input block
+//   scratch                B complex bins
+//   accumulator            B complex bins
+
+void dsp_filters_fft_convolution_init
+(
+    const int32_t* filter_coeffs,
+    const int32_t  num_taps,
+    const int32_t  block_length,
+    int32_t*       state_data,
+    const int32_t* sine,
+    const int32_t* sin2
+) {
+    int32_t partitions = DSP_FILTERS_FFT_CONVOLUTION_PARTITIONS( num_taps, block_length );
+    int32_t fft_length = 2 * block_length;
+    int32_t* shifts = state_data + 2;
+    int32_t* spectra = shifts + ((partitions + 1) & ~1);
+    int32_t length = DSP_FILTERS_FFT_CONVOLUTION_STATE_LENGTH( num_taps, block_length );
+    int32_t headroom, log2_partitions = 0;
+
+    while( (1 << log2_partitions) < partitions ) ++log2_partitions;
+
+    // Each partition is zero padded to twice its length, so that the last
+    // half of the circular convolution of a 2B input frame is the linear one.
+
+    for( int32_t p = 0; p < partitions; ++p )
+    {
+        int32_t* h = spectra + p * fft_length;
+        for( int32_t i = 0; i < block_length; ++i ) {
+            int32_t k = p * block_length + i;
+            h[i] = (k < num_taps) ? filter_coeffs[k] : 0;
+            h[block_length + i] = 0;
+        }
+        dsp_fft_bit_reverse_and_forward_real( h, fft_length, sine, sin2 );
+    }
+
+    // All spectra share one exponent. Leave two bits of head room for the
+    // complex products, and log2(P) bits for accumulating P of them.
+
+    headroom = dsp_bfp_cls( (dsp_complex_t*) spectra, partitions * block_length );
+    headroom -= 3 + log2_partitions;
+    dsp_bfp_shl( (dsp_complex_t*) spectra, partitions * block_length, headroom );
+
+    state_data[0] = 0;
+    state_data[1] = headroom;
+    for( int32_t p = 0; p < partitions; ++p ) shifts[p] = 62;
+    for( int32_t i = spectra + partitions * fft_length - state_data; i < length; ++i ) {
+        state_data[i] = 0;
+    }
+}
+
+
+
+void dsp_filters_fft_convolution
+(
+    const int32_t* input_samples,
+    int32_t*       output_samples,
+    int32_t*       state_data,
+    const int32_t  num_taps,
+    const int32_t  block_length,
+    const int32_t  q_format,
+    const int32_t* sine,
+    const int32_t* sin2
+) {
+    int32_t partitions = DSP_FILTERS_FFT_CONVOLUTION_PARTITIONS( num_taps, block_length );
+    int32_t fft_length = 2 * block_length;
+    int32_t* shifts = state_data + 2;
+    dsp_complex_t* spectra = (dsp_complex_t*) (shifts + ((partitions + 1) & ~1));
+    dsp_complex_t* delay_line = spectra + partitions * block_length;
+    int32_t* history = (int32_t*) (delay_line + partitions * block_length);
+    dsp_complex_t* scratch = (dsp_complex_t*) (history + block_length);
+    dsp_complex_t* acc = scratch + block_length;
+    int32_t index = state_data[0];
+    int32_t log2_fft_length = 0, min_shift, shift, headroom, mul, round;
+    uint32_t al; int32_t ah;
+    dsp_complex_t* x;
+
+    while( (1 << log2_fft_length) < fft_length ) ++log2_fft_length;
+
+    // Transform the previous and the new block into the newest slot of the
+    // delay line. The frame is normalized before the FFT, and the spectrum
+    // again after it to recover the bits lost to the FFT's 1/N scaling.
+
+    if( --index < 0 ) index = partitions - 1;
+    state_data[0] = index;
+    x = delay_line + index * block_length;
+    for( int32_t i = 0; i < block_length; ++i ) {
+        ((int32_t*) x)[i] = history[i];
+        ((int32_t*) x)[block_length + i] = history[i] = input_samples[i];
+    }
+    shift = dsp_bfp_cls( x, block_length ) - 1;
+    dsp_bfp_shl( x, block_length, shift );
+    dsp_fft_bit_reverse_and_forward_real( (int32_t*) x, fft_length, sine, sin2 );
+    headroom = dsp_bfp_cls( x, block_length ) - 1;
+    dsp_bfp_shl( x, block_length, headroom );
+    shifts[index] = shift + headroom;
+
+    // The loudest spectrum in the delay line sets the exponent of the
+    // accumulator; quieter spectra are shifted down to match it. A silent
+    // frame has shift 62, as does every slot after initialization.
+
+    min_shift = shifts[0];
+    for( int32_t p = 1; p < partitions; ++p ) {
+        if( shifts[p] < min_shift ) min_shift = shifts[p];
+    }
+    for( int32_t i = 0; i < block_length; ++i ) acc[i].re = acc[i].im = 0;
+
+    for( int32_t p = 0; p < partitions; ++p )
+    {
+        int32_t slot = index + p;
+        dsp_complex_t* h = spectra + p * block_length;
+        dsp_complex_t dc_nyquist = acc[0];
+        if( slot >= partitions ) slot -= partitions;
+        x = delay_line + slot * block_length;
+        shift = shifts[slot] - min_shift;
+        if( shift > 31 ) shift = 31;
+        if( shift > 0 ) {
+            for( int32_t i = 0; i < block_length; ++i ) scratch[i] = x[i];
+            dsp_bfp_shl( scratch, block_length, -shift );
+            x = scratch;
+        }
+        dsp_complex_macc_vector( acc, x, h, block_length, 31 );
+
+        // Element 0 packs the real DC and Nyquist bins, which are multiplied
+        // separately rather than as one complex number.
+
+        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(x[0].re),"r"(h[0].re),"0"(0),"1"(0));
+        asm("lextract %0,%1,%2,%3,32":"=r"(ah):"r"(ah),"r"(al),"r"(31));
+        acc[0].re = dc_nyquist.re + ah;
+        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(x[0].im),"r"(h[0].im),"0"(0),"1"(0));
+        asm("lextract %0,%1,%2,%3,32":"=r"(ah):"r"(ah),"r"(al),"r"(31));
+        acc[0].im = dc_nyquist.im + ah;
+    }
+
+    // The unscaled inverse FFT can grow by up to 4N, so leave that head room.
+
+    shift = dsp_bfp_cls( acc, block_length ) - (log2_fft_length + 3);
+    dsp_bfp_shl( acc, block_length, shift );
+    dsp_fft_bit_reverse_and_inverse_real( (int32_t*) acc, fft_length, sine, sin2 );
+
+    // Undo all exponents: input frame, filter spectra, products, inverse FFT
+    // head room, and the coefficient format. The last half of the frame is
+    // the output block.
+
+    shift = 31 - min_shift + log2_fft_length - state_data[1] - q_format - shift;
+    mul = (shift > 0) ? 1 << (shift > 30 ? 30 : shift) : 1;
+    shift = (shift < 0) ? (shift < -31 ? 31 : -shift) : 0;
+    round = (shift > 0) ? 1 << (shift - 1) : 0;
+    for( int32_t i = 0; i < block_length; ++i ) {
+        int32_t y = ((int32_t*) acc)[block_length + i];
+        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(y),"r"(mul),"0"(0),"1"(round));
+        asm("lsats %0,%1,%2":"=r"(ah),"=r"(al):"r"(shift),"0"(ah),"1"(al));
+        asm("lextract %0,%1,%2,%3,32":"=r"(ah):"r"(ah),"r"(al),"r"(shift));
+        output_samples[i] = ah;
+    }
+}
+
+#endif
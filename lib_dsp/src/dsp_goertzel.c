@@ -0,0 +1,262 @@
+// Copyright (c) 2017, XMOS Ltd, All rights reserved
+#include <stdint.h>
+#include "dsp_goertzel.h"
+#include "dsp_fft.h"
+
+// State layout: [0] N, [1] number of bins, [2] samples in the current
+// frame (Goertzel) or position of the oldest sample in the history
+// (sliding DFT), [3] log2(N), then for the sliding DFT the history of N
+// samples, then the words of each bin.
+//
+// Goertzel bin: 2cos(w) is split into c0 + d, where c0 is 2, 0 or -2,
+// whichever is nearest, so that d is small near bins 0 and N/2, and d is
+// kept with 30 or more significant bits: [0] d * 2^shift, [1] shift,
+// [2] c0, [3] sin(w), [4..5] s[n-1] and [6..7] s[n-2], low word first,
+// each with frac fractional bits, and [8] frac.
+//
+// Sliding DFT bin: [0] bin number, [1] unused, [2..3] real and [4..5]
+// imaginary accumulators, low word first, so that each one can be loaded
+// with ldd.
+
+#define _DSP_GOERTZEL_N        0
+#define _DSP_GOERTZEL_BINS     1
+#define _DSP_GOERTZEL_POSITION 2
+#define _DSP_GOERTZEL_LOG2N    3
+#define _DSP_GOERTZEL_DATA     4
+
+#define _DSP_GOERTZEL_BIN_WORDS         9
+#define _DSP_GOERTZEL_SLIDING_BIN_WORDS 6
+
+static uint32_t _dsp_goertzel__init( int32_t state[], const uint32_t num_bins, const uint32_t N )
+{
+    uint32_t log2N = 0;
+    while( (1u << log2N) < N ) log2N++;
+    state[_DSP_GOERTZEL_N] = N;
+    state[_DSP_GOERTZEL_BINS] = num_bins;
+    state[_DSP_GOERTZEL_POSITION] = 0;
+    state[_DSP_GOERTZEL_LOG2N] = log2N;
+    return log2N;
+}
+
+// sin(2 pi p / N) from the N/4+1 values of the sine table, for p < N, or
+// from the shared table with a stride when DSP_SINE_SHARED is set
+static inline int32_t _dsp_goertzel__sin( const int32_t sine[], const uint32_t N, uint32_t p )
+{
+    uint32_t quarter = DSP_SINE_POINTS(N) >> 2;
+    p *= DSP_SINE_STRIDE(N);
+    if( p <= quarter )     return  sine[p];
+    if( p <= 2 * quarter ) return  sine[2 * quarter - p];
+    if( p <= 3 * quarter ) return -sine[p - 2 * quarter];
+    return -sine[4 * quarter - p];
+}
+
+static inline int32_t _dsp_goertzel__cos( const int32_t sine[], const uint32_t N, const uint32_t p )
+{
+    return _dsp_goertzel__sin( sine, N, (p + (N >> 2)) & (N - 1) );
+}
+
+// s * m / 2^shift, rounded, for 30 <= shift < 63 and a result that fits
+// in 64 bits. s is split into hi * 2^32 + lo with a signed lo, so that both
+// products are those of maccs; the rounding constant 2^(shift-1) starts
+// the lower product.
+static inline int64_t _dsp_goertzel__mul( int64_t s, int32_t m, int32_t shift )
+{
+    int32_t hi = (int32_t)((s + 0x80000000LL) >> 32), lo = (int32_t) s;
+    int32_t ph = 0, lh = 0;
+    uint32_t pl = 0, ll = 0;
+    int64_t p, l;
+    if( shift > 32 ) lh = 1 << (shift - 33); else ll = 1u << (shift - 1);
+    asm("maccs %0,%1,%2,%3":"=r"(ph),"=r"(pl):"r"(hi),"r"(m),"0"(ph),"1"(pl));
+    asm("maccs %0,%1,%2,%3":"=r"(lh),"=r"(ll):"r"(lo),"r"(m),"0"(lh),"1"(ll));
+    p = (int64_t)(((uint64_t) ph << 32) | pl);
+    l = (int64_t)(((uint64_t) lh << 32) | ll);
+    if( shift > 32 ) return (p + (l >> 32)) >> (shift - 32);
+    return (int64_t)((uint64_t) p << (32 - shift)) + (l >> shift);
+}
+
+static inline int64_t _dsp_goertzel__load( const int32_t* p )
+{
+    return (int64_t)(((uint64_t)(uint32_t) p[1] << 32) | (uint32_t) p[0]);
+}
+
+static inline void _dsp_goertzel__store( int32_t* p, const int64_t s )
+{
+    p[0] = (int32_t) s;
+    p[1] = (int32_t)(s >> 32);
+}
+
+void dsp_goertzel_init( int32_t state[], const uint32_t bins[], const uint32_t num_bins,
+                        const uint32_t N, const int32_t sine[] )
+{
+    int32_t* bin = &state[_DSP_GOERTZEL_DATA];
+    _dsp_goertzel__init( state, num_bins, N );
+
+    for( uint32_t b = 0; b < num_bins; ++b, bin += _DSP_GOERTZEL_BIN_WORDS ) {
+        uint32_t k = bins[b], g = 0, shift = 30;
+        int32_t s = _dsp_goertzel__sin( sine, N, k ), c = _dsp_goertzel__cos( sine, N, k );
+        int32_t c0 = 0, d = c;
+        // The state grows to at most N/sin(w) times the largest input, or
+        // N(N+1)/2 at DC and N/2
+        uint64_t bound = (uint64_t) N * (N + 1) / 2;
+        if( s > 0 && ((uint64_t) N << 31) / s < bound ) bound = ((uint64_t) N << 31) / s;
+        while( ((uint64_t) 1 << g) < bound ) g++;
+        // 2 - 2cos(w) = 2sin(w)^2 / (1 + cos(w)), and 2 + 2cos(w) =
+        // 2sin(w)^2 / (1 - cos(w)), which keep their relative precision
+        // near 0 and pi, unlike 2cos(w) - 2 from the sine table
+        if( c >= 0x40000000 || c <= -0x40000000 ) {
+            uint64_t num = (uint64_t)((int64_t) s * s);
+            uint64_t den = (uint64_t)(0x80000000LL + (c > 0 ? c : -c));
+            shift = 0;
+            if( num != 0 ) {
+                while( num < (den << 29) ) { num <<= 1; shift++; }
+            }
+            d = (int32_t)((num + (den >> 1)) / den);
+            c0 = c > 0 ? 2 : -2;
+            if( c > 0 ) d = -d;
+            shift += 30;
+        }
+        bin[0] = d;
+        bin[1] = shift;
+        bin[2] = c0;
+        bin[3] = s;
+        _dsp_goertzel__store( &bin[4], 0 );
+        _dsp_goertzel__store( &bin[6], 0 );
+        // Two bits of headroom for the terms of s[n]
+        bin[8] = 29 - g;
+    }
+}
+
+void dsp_goertzel_update( int32_t state[], const int32_t input[], const uint32_t num_samples )
+{
+    int32_t* bin = &state[_DSP_GOERTZEL_DATA];
+
+    for( int32_t b = 0; b < state[_DSP_GOERTZEL_BINS]; ++b, bin += _DSP_GOERTZEL_BIN_WORDS ) {
+        int32_t d = bin[0], shift = bin[1], c0 = bin[2], frac = bin[8];
+        int64_t s1 = _dsp_goertzel__load( &bin[4] ), s2 = _dsp_goertzel__load( &bin[6] );
+        // s[n] = x[n] + (c0 + d) s[n-1] - s[n-2]
+        for( uint32_t i = 0; i < num_samples; ++i ) {
+            int64_t s0 = ((int64_t) input[i] << frac) + _dsp_goertzel__mul( s1, d, shift ) - s2;
+            if( c0 > 0 ) s0 += s1 << 1;
+            if( c0 < 0 ) s0 -= s1 << 1;
+            s2 = s1;
+            s1 = s0;
+        }
+        _dsp_goertzel__store( &bin[4], s1 );
+        _dsp_goertzel__store( &bin[6], s2 );
+    }
+    state[_DSP_GOERTZEL_POSITION] += num_samples;
+}
+
+// x / 2^shift, rounded and saturated to 32 bits
+static inline int32_t _dsp_goertzel__round( int64_t x, int32_t shift )
+{
+    x = (x + ((int64_t) 1 << (shift - 1))) >> shift;
+    if( x > 0x7fffffff ) return 0x7fffffff;
+    if( x < -0x7fffffff - 1 ) return -0x7fffffff - 1;
+    return (int32_t) x;
+}
+
+void dsp_goertzel_result( int32_t state[], dsp_complex_t result[] )
+{
+    int32_t* bin = &state[_DSP_GOERTZEL_DATA];
+
+    for( int32_t b = 0; b < state[_DSP_GOERTZEL_BINS]; ++b, bin += _DSP_GOERTZEL_BIN_WORDS ) {
+        int64_t s1 = _dsp_goertzel__load( &bin[4] ), s2 = _dsp_goertzel__load( &bin[6] );
+        // Remove the fractional bits of the state and scale by 1/N
+        int32_t shift = bin[8] + state[_DSP_GOERTZEL_LOG2N];
+        // X = exp(jw) s[N-1] - s[N-2], where cos(w) = (c0 + d) / 2
+        int64_t re = _dsp_goertzel__mul( s1, bin[0], bin[1] + 1 ) - s2;
+        if( bin[2] > 0 ) re += s1;
+        if( bin[2] < 0 ) re -= s1;
+        result[b].re = _dsp_goertzel__round( re, shift );
+        result[b].im = _dsp_goertzel__round( _dsp_goertzel__mul( s1, bin[3], 31 ), shift );
+        _dsp_goertzel__store( &bin[4], 0 );
+        _dsp_goertzel__store( &bin[6], 0 );
+    }
+    state[_DSP_GOERTZEL_POSITION] = 0;
+}
+
+void dsp_goertzel_sliding_init( int32_t state[], const uint32_t bins[],
+                                const uint32_t num_bins, const uint32_t N )
+{
+    int32_t* bin = &state[_DSP_GOERTZEL_DATA + N];
+    _dsp_goertzel__init( state, num_bins, N );
+
+    for( uint32_t i = 0; i < N; ++i ) state[_DSP_GOERTZEL_DATA + i] = 0;
+    for( uint32_t b = 0; b < num_bins; ++b, bin += _DSP_GOERTZEL_SLIDING_BIN_WORDS ) {
+        bin[0] = bins[b];
+        for( int32_t i = 1; i < _DSP_GOERTZEL_SLIDING_BIN_WORDS; ++i ) bin[i] = 0;
+    }
+}
+
+void dsp_goertzel_sliding_update( int32_t state[], const int32_t input[],
+                                  const uint32_t num_samples, const int32_t sine[] )
+{
+    uint32_t N = state[_DSP_GOERTZEL_N], mask = N - 1;
+    uint32_t position = state[_DSP_GOERTZEL_POSITION];
+    int32_t log2N = state[_DSP_GOERTZEL_LOG2N];
+    int32_t* history = &state[_DSP_GOERTZEL_DATA];
+    int32_t* bin = &state[_DSP_GOERTZEL_DATA + N];
+
+    for( int32_t b = 0; b < state[_DSP_GOERTZEL_BINS]; ++b, bin += _DSP_GOERTZEL_SLIDING_BIN_WORDS ) {
+        uint32_t k = bin[0], p = (k * position) & mask;
+        int32_t re_h, im_h; uint32_t re_l, im_l;
+        asm("ldd %0,%1,%2[1]":"=r"(re_h),"=r"(re_l):"r"(bin));
+        asm("ldd %0,%1,%2[2]":"=r"(im_h),"=r"(im_l):"r"(bin));
+        // Y += (x[n] - x[n-N]) exp(-j 2 pi k n / N), where both products
+        // are exact and the twiddle factor is the same N samples apart
+        for( uint32_t i = 0; i < num_samples; ++i ) {
+            int32_t x = input[i], old = history[(position + i) & mask];
+            int32_t c = ((_dsp_goertzel__cos( sine, N, p ) >> (log2N - 1)) + 1) >> 1;
+            int32_t s = ((_dsp_goertzel__sin( sine, N, p ) >> (log2N - 1)) + 1) >> 1;
+            asm("maccs %0,%1,%2,%3":"=r"(re_h),"=r"(re_l):"r"(x),"r"(c),"0"(re_h),"1"(re_l));
+            asm("maccs %0,%1,%2,%3":"=r"(re_h),"=r"(re_l):"r"(old),"r"(-c),"0"(re_h),"1"(re_l));
+            asm("maccs %0,%1,%2,%3":"=r"(im_h),"=r"(im_l):"r"(x),"r"(-s),"0"(im_h),"1"(im_l));
+            asm("maccs %0,%1,%2,%3":"=r"(im_h),"=r"(im_l):"r"(old),"r"(s),"0"(im_h),"1"(im_l));
+            p = (p + k) & mask;
+        }
+        asm("std %0,%1,%2[1]"::"r"(re_h),"r"(re_l),"r"(bin));
+        asm("std %0,%1,%2[2]"::"r"(im_h),"r"(im_l),"r"(bin));
+    }
+    for( uint32_t i = 0; i < num_samples; ++i ) history[(position + i) & mask] = input[i];
+    state[_DSP_GOERTZEL_POSITION] = (position + num_samples) & mask;
+}
+
+// The accumulator in Q31, as the twiddle factors carry the 1/N
+static inline int32_t _dsp_goertzel__q31( int32_t ah, uint32_t al )
+{
+    asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(1<<30),"r"(1),"0"(ah),"1"(al));
+    asm("lsats %0,%1,%2":"=r"(ah),"=r"(al):"r"(31),"0"(ah),"1"(al));
+    asm("lextract %0,%1,%2,%3,32":"=r"(ah):"r"(ah),"r"(al),"r"(31));
+    return ah;
+}
+
+void dsp_goertzel_sliding_result( const int32_t state[], dsp_complex_t result[],
+                                  const int32_t sine[] )
+{
+    uint32_t N = state[_DSP_GOERTZEL_N], mask = N - 1;
+    uint32_t position = state[_DSP_GOERTZEL_POSITION];
+    const int32_t* bin = &state[_DSP_GOERTZEL_DATA + N];
+
+    for( int32_t b = 0; b < state[_DSP_GOERTZEL_BINS]; ++b, bin += _DSP_GOERTZEL_SLIDING_BIN_WORDS ) {
+        // Rotate Y by exp(j 2 pi k m / N), where m = position (mod N) is
+        // the time of the oldest sample in the history
+        uint32_t p = (bin[0] * position) & mask;
+        int32_t c = _dsp_goertzel__cos( sine, N, p ), s = _dsp_goertzel__sin( sine, N, p );
+        int32_t yr, yi, ah; uint32_t al;
+        asm("ldd %0,%1,%2[1]":"=r"(ah),"=r"(al):"r"(bin));
+        yr = _dsp_goertzel__q31( ah, al );
+        asm("ldd %0,%1,%2[2]":"=r"(ah),"=r"(al):"r"(bin));
+        yi = _dsp_goertzel__q31( ah, al );
+        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(yr),"r"(c),"0"(0),"1"(1<<30));
+        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(yi),"r"(-s),"0"(ah),"1"(al));
+        asm("lsats %0,%1,%2":"=r"(ah),"=r"(al):"r"(31),"0"(ah),"1"(al));
+        asm("lextract %0,%1,%2,%3,32":"=r"(ah):"r"(ah),"r"(al),"r"(31));
+        result[b].re = ah;
+        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(yr),"r"(s),"0"(0),"1"(1<<30));
+        asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(yi),"r"(c),"0"(ah),"1"(al));
+        asm("lsats %0,%1,%2":"=r"(ah),"=r"(al):"r"(31),"0"(ah),"1"(al));
+        asm("lextract %0,%1,%2,%3,32":"=r"(ah):"r"(ah),"r"(al),"r"(31));
+        result[b].im = ah;
+    }
+}
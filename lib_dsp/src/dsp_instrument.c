@@ -0,0 +1,224 @@
+// Copyright (c) 2017, XMOS Ltd, All rights reserved
+#define DSP_INSTRUMENT_NO_WRAP
+#include <stdint.h>
+#include "dsp_instrument.h"
+
+#if DSP_INSTRUMENT
+
+#include <xscope.h>
+
+#define _DSP_INSTRUMENT_CORES 8
+
+// Each ring is written only by its own logical core and read by
+// dsp_instrument_read(), so the write and read counts need no lock.
+typedef struct {
+    volatile uint32_t write;
+    volatile uint32_t read;
+    volatile uint32_t dropped;
+    uint32_t dropped_reported;
+    volatile uint32_t records[DSP_INSTRUMENT_RING_LENGTH];
+} _dsp_instrument_ring_t;
+
+static _dsp_instrument_ring_t _dsp_instrument_rings[_DSP_INSTRUMENT_CORES];
+
+static inline uint32_t _dsp_instrument__time( void )
+{
+    uint32_t t;
+    asm volatile("gettime %0":"=r"(t));
+    return t;
+}
+
+static inline uint32_t _dsp_instrument__core( void )
+{
+    uint32_t id;
+    asm volatile("get r11, id; mov %0, r11":"=r"(id)::"r11");
+    return id;
+}
+
+static void _dsp_instrument__record( const dsp_instrument_function_t function,
+                                     const uint32_t event, uint32_t value )
+{
+    uint32_t core = _dsp_instrument__core();
+    _dsp_instrument_ring_t* ring = &_dsp_instrument_rings[core];
+    uint32_t write = ring->write;
+
+    if( write - ring->read == DSP_INSTRUMENT_RING_LENGTH ) {
+        ring->dropped++;
+        return;
+    }
+    if( value > DSP_INSTRUMENT_VALUE_MAX ) value = DSP_INSTRUMENT_VALUE_MAX;
+    ring->records[write & (DSP_INSTRUMENT_RING_LENGTH - 1)] =
+        (core << 29) | (event << 28) | ((uint32_t) function << 22) | value;
+    ring->write = write + 1;
+}
+
+static inline uint32_t _dsp_instrument__saturated( const int32_t x )
+{
+    return x == INT32_MAX || x == INT32_MIN;
+}
+
+static void _dsp_instrument__end( const dsp_instrument_function_t function, const uint32_t start,
+                                  const uint32_t saturated )
+{
+    uint32_t ticks = _dsp_instrument__time() - start;
+    _dsp_instrument__record( function, DSP_INSTRUMENT_EVENT_TICKS, ticks );
+    if( saturated ) _dsp_instrument__record( function, DSP_INSTRUMENT_EVENT_SATURATION, saturated );
+}
+
+static uint32_t _dsp_instrument__count_saturated( const int32_t x[], const int32_t n )
+{
+    uint32_t saturated = 0;
+    for( int32_t i = 0; i < n; ++i ) saturated += _dsp_instrument__saturated( x[i] );
+    return saturated;
+}
+
+uint32_t dsp_instrument_read( uint32_t records[], const uint32_t n )
+{
+    uint32_t count = 0;
+    for( uint32_t core = 0; core < _DSP_INSTRUMENT_CORES; ++core ) {
+        _dsp_instrument_ring_t* ring = &_dsp_instrument_rings[core];
+        uint32_t read = ring->read, write = ring->write;
+        for( ; read != write && count < n; ++read ) {
+            records[count++] = ring->records[read & (DSP_INSTRUMENT_RING_LENGTH - 1)];
+        }
+        ring->read = read;
+    }
+    return count;
+}
+
+uint32_t dsp_instrument_dropped( void )
+{
+    uint32_t dropped = 0;
+    for( uint32_t core = 0; core < _DSP_INSTRUMENT_CORES; ++core ) {
+        _dsp_instrument_ring_t* ring = &_dsp_instrument_rings[core];
+        uint32_t d = ring->dropped;
+        dropped += d - ring->dropped_reported;
+        ring->dropped_reported = d;
+    }
+    return dropped;
+}
+
+void dsp_instrument_flush( const uint32_t probe )
+{
+    uint32_t records[16], n;
+    while( (n = dsp_instrument_read( records, 16 )) != 0 ) {
+        for( uint32_t i = 0; i < n; ++i ) xscope_int( probe, records[i] );
+    }
+}
+
+void dsp_instrument_fft_forward( dsp_complex_t pts[], const uint32_t N, const int32_t sine[] )
+{
+    uint32_t start = _dsp_instrument__time();
+    dsp_fft_forward( pts, N, sine );
+    _dsp_instrument__end( DSP_INSTRUMENT_FFT_FORWARD, start, 0 );
+}
+
+void dsp_instrument_fft_inverse( dsp_complex_t pts[], const uint32_t N, const int32_t sine[] )
+{
+    uint32_t start = _dsp_instrument__time();
+    dsp_fft_inverse( pts, N, sine );
+    _dsp_instrument__end( DSP_INSTRUMENT_FFT_INVERSE, start, 0 );
+}
+
+void dsp_instrument_fft_bit_reverse_and_forward_real( int32_t pts[], const uint32_t N,
+                                                      const int32_t sine[], const int32_t sin2[] )
+{
+    uint32_t start = _dsp_instrument__time();
+    dsp_fft_bit_reverse_and_forward_real( pts, N, sine, sin2 );
+    _dsp_instrument__end( DSP_INSTRUMENT_FFT_FORWARD_REAL, start, 0 );
+}
+
+void dsp_instrument_fft_bit_reverse_and_inverse_real( int32_t pts[], const uint32_t N,
+                                                      const int32_t sine[], const int32_t sin2[] )
+{
+    uint32_t start = _dsp_instrument__time();
+    dsp_fft_bit_reverse_and_inverse_real( pts, N, sine, sin2 );
+    _dsp_instrument__end( DSP_INSTRUMENT_FFT_INVERSE_REAL, start, 0 );
+}
+
+int32_t dsp_instrument_filters_fir( int32_t input_sample, const int32_t filter_coeffs[],
+                                    int32_t state_data[], const int32_t num_taps,
+                                    const int32_t q_format )
+{
+    uint32_t start = _dsp_instrument__time();
+    int32_t y = dsp_filters_fir( input_sample, filter_coeffs, state_data, num_taps, q_format );
+    _dsp_instrument__end( DSP_INSTRUMENT_FILTERS_FIR, start, _dsp_instrument__saturated( y ) );
+    return y;
+}
+
+void dsp_instrument_filters_fir_block( const int32_t input_samples[], int32_t output_samples[],
+                                       const int32_t num_samples, const int32_t filter_coeffs[],
+                                       int32_t state_data[], const int32_t num_taps,
+                                       const int32_t q_format )
+{
+    uint32_t start = _dsp_instrument__time();
+    dsp_filters_fir_block( input_samples, output_samples, num_samples, filter_coeffs, state_data,
+                           num_taps, q_format );
+    _dsp_instrument__end( DSP_INSTRUMENT_FILTERS_FIR_BLOCK, start,
+                          _dsp_instrument__count_saturated( output_samples, num_samples ) );
+}
+
+int32_t dsp_instrument_filters_biquad( int32_t input_sample,
+                                       const int32_t filter_coeffs[DSP_NUM_COEFFS_PER_BIQUAD],
+                                       int32_t state_data[DSP_NUM_STATES_PER_BIQUAD],
+                                       const int32_t q_format )
+{
+    uint32_t start = _dsp_instrument__time();
+    int32_t y = dsp_filters_biquad( input_sample, filter_coeffs, state_data, q_format );
+    _dsp_instrument__end( DSP_INSTRUMENT_FILTERS_BIQUAD, start, _dsp_instrument__saturated( y ) );
+    return y;
+}
+
+int32_t dsp_instrument_filters_biquads( int32_t input_sample, const int32_t filter_coeffs[],
+                                        int32_t state_data[], const int32_t num_sections,
+                                        const int32_t q_format )
+{
+    uint32_t start = _dsp_instrument__time();
+    int32_t y = dsp_filters_biquads( input_sample, filter_coeffs, state_data, num_sections,
+                                     q_format );
+    // Each section stores its output in the state; count the sections that clamped
+    uint32_t saturated = 0;
+    for( int32_t s = 0; s < num_sections; ++s ) {
+        saturated += _dsp_instrument__saturated( state_data[s * DSP_NUM_STATES_PER_BIQUAD + 2] );
+    }
+    _dsp_instrument__end( DSP_INSTRUMENT_FILTERS_BIQUADS, start, saturated );
+    return y;
+}
+
+int32_t dsp_instrument_adaptive_lms( int32_t input_sample, int32_t reference_sample,
+                                     int32_t *error_sample, const int32_t filter_coeffs[],
+                                     int32_t state_data[], const int32_t num_taps,
+                                     const int32_t mu, int32_t q_format )
+{
+    uint32_t start = _dsp_instrument__time();
+    int32_t y = dsp_adaptive_lms( input_sample, reference_sample, error_sample, filter_coeffs,
+                                  state_data, num_taps, mu, q_format );
+    _dsp_instrument__end( DSP_INSTRUMENT_ADAPTIVE_LMS, start, _dsp_instrument__saturated( y ) );
+    return y;
+}
+
+int32_t dsp_instrument_adaptive_nlms( int32_t input_sample, int32_t reference_sample,
+                                      int32_t *error_sample, const int32_t filter_coeffs[],
+                                      int32_t state_data[], const int32_t num_taps,
+                                      const int32_t mu, int32_t q_format )
+{
+    uint32_t start = _dsp_instrument__time();
+    int32_t y = dsp_adaptive_nlms( input_sample, reference_sample, error_sample, filter_coeffs,
+                                   state_data, num_taps, mu, q_format );
+    _dsp_instrument__end( DSP_INSTRUMENT_ADAPTIVE_NLMS, start, _dsp_instrument__saturated( y ) );
+    return y;
+}
+
+void dsp_instrument_matrix_mulm( const int32_t input_matrix_X[], const int32_t input_matrix_Y[],
+                                 int32_t result_matrix_R[], const int32_t rows_X,
+                                 const int32_t cols_Y, const int32_t cols_X_rows_Y,
+                                 const int32_t q_format )
+{
+    uint32_t start = _dsp_instrument__time();
+    dsp_matrix_mulm( input_matrix_X, input_matrix_Y, result_matrix_R, rows_X, cols_Y,
+                     cols_X_rows_Y, q_format );
+    _dsp_instrument__end( DSP_INSTRUMENT_MATRIX_MULM, start,
+                          _dsp_instrument__count_saturated( result_matrix_R, rows_X * cols_Y ) );
+}
+
+#endif
@@ -5,7 +5,11 @@
 #include "dsp_math.h"
 #include "stdio.h"
 
-int32_t dsp_math_multiply( int32_t input1_value, int32_t input2_value, int32_t q_format )
+// The functions used by the transcendental functions are defined inline
+// first, so that the vector versions of those functions inline all of
+// them into a single loop without any calls.
+
+static inline int32_t _dsp_math__multiply( int32_t input1_value, int32_t input2_value, int32_t q_format )
 {
     int32_t ah; uint32_t al;
     int32_t result;
@@ -15,6 +19,11 @@ int32_t dsp_math_multiply( int32_t input1_value, int32_t input2_value, int32_t q
     return result;
 }
 
+int32_t dsp_math_multiply( int32_t input1_value, int32_t input2_value, int32_t q_format )
+{
+    return _dsp_math__multiply( input1_value, input2_value, q_format );
+}
+
 int32_t dsp_math_multiply_sat( int32_t input1_value, int32_t input2_value, int32_t q_format )
 {
     int32_t ah; uint32_t al;
@@ -26,7 +35,7 @@ int32_t dsp_math_multiply_sat( int32_t input1_value, int32_t input2_value, int32
 
 #define  ldivu(a,b,c,d,e) asm("ldivu %0,%1,%2,%3,%4" : "=r" (a), "=r" (b): "r" (c), "r" (d), "r" (e))
 
-int32_t dsp_math_divide( int32_t dividend, int32_t divisor, uint32_t q_format )
+static inline int32_t _dsp_math__divide( int32_t dividend, int32_t divisor, uint32_t q_format )
 {
     int32_t sgn = 1;
     uint32_t d, d2, r;
@@ -50,7 +59,7 @@ int32_t dsp_math_divide( int32_t dividend, int32_t divisor, uint32_t q_format )
 }
 
 
-uint32_t dsp_math_divide_unsigned(uint32_t dividend, uint32_t divisor, uint32_t q_format )
+static inline uint32_t _dsp_math__divide_unsigned(uint32_t dividend, uint32_t divisor, uint32_t q_format )
 {
     //h and l hold a 64-bit value
     uint32_t h; uint32_t l;
@@ -66,10 +75,20 @@ uint32_t dsp_math_divide_unsigned(uint32_t dividend, uint32_t divisor, uint32_t
     return quotient;
 }
 
+int32_t dsp_math_divide( int32_t dividend, int32_t divisor, uint32_t q_format )
+{
+    return _dsp_math__divide( dividend, divisor, q_format );
+}
+
+uint32_t dsp_math_divide_unsigned(uint32_t dividend, uint32_t divisor, uint32_t q_format )
+{
+    return _dsp_math__divide_unsigned( dividend, divisor, q_format );
+}
+
 #define SQRT_COEFF_A ((12466528)/2) // 7143403
 #define SQRT_COEFF_B (10920575) // 9633812
 
-uq8_24 dsp_math_sqrt(uq8_24 x)
+static inline uq8_24 _dsp_math__sqrt(uq8_24 x)
 {
     int32_t zeroes;
     unsigned long long approx;
@@ -83,24 +102,29 @@ uq8_24 dsp_math_sqrt(uq8_24 x)
 
     // initial linear approximation of the result.
     if (zeroes >= 0) {
-        approx = (SQRT_COEFF_A >> zeroes) + dsp_math_multiply(x << zeroes, SQRT_COEFF_B, 24);
+        approx = (SQRT_COEFF_A >> zeroes) + _dsp_math__multiply(x << zeroes, SQRT_COEFF_B, 24);
     } else {
         // For Q8.24 values > 1 (0x01.000000)
         zeroes = -zeroes;
-        approx = (SQRT_COEFF_A << zeroes) + dsp_math_multiply(x >> zeroes, SQRT_COEFF_B, 24);
+        approx = (SQRT_COEFF_A << zeroes) + _dsp_math__multiply(x >> zeroes, SQRT_COEFF_B, 24);
     }
 
     // successive approximation
     for(int32_t i = 0; i < 3; i++) {
         // Linear approximation. Babylonian Method: Successive averaging
         // xn+1 = (xn + y/xn) / 2
-        approx = (approx + dsp_math_divide_unsigned(x, approx, 24)) >> 1;
+        approx = (approx + _dsp_math__divide_unsigned(x, approx, 24)) >> 1;
     }
 
     // Return format is Q8.24
     return approx;
 }
 
+uq8_24 dsp_math_sqrt(uq8_24 x)
+{
+    return _dsp_math__sqrt(x);
+}
+
 
 /******************************************************************
  * Derived from "Software Manual for the Elementary
@@ -350,7 +374,7 @@ q8_24 dsp_math_acos(q8_24 cos) {
 }
 
 
-int32_t dsp_math_round(int32_t x, int q_format) {
+static inline int32_t dsp_math_round(int32_t x, int q_format) {
     // x += 0.5, truncate franctional bits
     return (x + (1<<(q_format-1))) & ~((1<<q_format) - 1);
 }
@@ -385,7 +409,7 @@ int32_t dsp_math_round(int32_t x, int q_format) {
  * a modulo of a large number. However, this would require mulf3_29 functions adding code
  * size. I think it is better to stick to a slightly less accurate version for now.
  */
-q8_24 dsp_math_exp(q8_24 x) {
+static inline q8_24 _dsp_math__exp(q8_24 x) {
     //valid range for x is [MIN_INT32..ln(126.9999999)] 
     //log base conversion rule: log2(x) = ln(x) * 1/ln(2)
     //Max XN = ln(MAX_INT32)/ln(2) = log2(MAX_INT32) 
@@ -395,7 +419,7 @@ q8_24 dsp_math_exp(q8_24 x) {
        return 0;
     }
 
-    q8_24 XN = dsp_math_round(dsp_math_multiply(x,ONE_OVER_LN2,24), 24);
+    q8_24 XN = dsp_math_round(_dsp_math__multiply(x,ONE_OVER_LN2,24), 24);
 
     q8_24 N = XN >> 24; // truncate fractional bits
 
@@ -403,24 +427,24 @@ q8_24 dsp_math_exp(q8_24 x) {
     // q_format = 24 + 31 - 24 = 31
 #if MULT_FUNC
     q8_24 N_q8_24 = N<<24;
-    q8_24 g = x - dsp_math_multiply(N_q8_24, EXP_C1, 24) - dsp_math_multiply(N_q8_24, EXP_C2, 24);
+    q8_24 g = x - _dsp_math__multiply(N_q8_24, EXP_C1, 24) - _dsp_math__multiply(N_q8_24, EXP_C2, 24);
 #else
     q8_24 g = x - N*(EXP_C1 + EXP_C2);
 #endif
 
     // g is in the range [-0.346..0.346] (-ln(2)/2 .. ln(2)/2)
     // z is in the range [0..0.12] (0.. (ln(2)/2)^2)
-    q8_24 z4 = dsp_math_multiply(g << 2,g ,24);
+    q8_24 z4 = _dsp_math__multiply(g << 2,g ,24);
 
     // P1_EXP * z = [0..0.0665 * 0.12 = 0.008]
     // P0_EXP + P1_EXP * z = [4..4.008]
     // g * (P0_EXP + P1_EXP * z) = -1.389..1.389
-    q8_24 precise = dsp_math_multiply((dsp_math_multiply(P1_EXP, z4, 24) + (P0_EXP << 2)), g << 3, 24);
+    q8_24 precise = _dsp_math__multiply((_dsp_math__multiply(P1_EXP, z4, 24) + (P0_EXP << 2)), g << 3, 24);
     q8_24 gP = (precise + 4) >> 3;
-    q8_24 Q = dsp_math_multiply(Q1_EXP, z4, 24) + (Q0_EXP << 2);
+    q8_24 Q = _dsp_math__multiply(Q1_EXP, z4, 24) + (Q0_EXP << 2);
     // Q1_EXP = 0.8, Q1_EXP*z = [0..0.096], Q0_EXP = 8, Q [8..8.096]
     
-    q8_24 r = (ONE_Q8_24<<2) + (dsp_math_divide(precise, Q - gP, 24));
+    q8_24 r = (ONE_Q8_24<<2) + (_dsp_math__divide(precise, Q - gP, 24));
     N -= 2;
     return N > 0 ? (r<<N)+(1<<(N-1)) : (r+(1<<(-N-1))) >> -N;
 
@@ -439,10 +463,14 @@ q8_24 dsp_math_exp(q8_24 x) {
     
 }
 
+q8_24 dsp_math_exp(q8_24 x) {
+    return _dsp_math__exp(x);
+}
+
 
 
 // helper functions
-void log2_with_remainder(q8_24 x, int *log2_p2, q8_24 *rem, int q_format) {
+static inline void log2_with_remainder(q8_24 x, int *log2_p2, q8_24 *rem, int q_format) {
     q8_24 absVal;
     int zeroes; // approximated log2. log2 of the power of two value closest to x.
                  // I.e. x with 31-clz(x) lower bits truncated
@@ -477,7 +505,7 @@ void log2_with_remainder(q8_24 x, int *log2_p2, q8_24 *rem, int q_format) {
 #define LOG_C1  11632640
 #define LOG_C2     -3560
 
-q8_24 dsp_math_log(uq8_24 x) {
+static inline q8_24 _dsp_math__log(uq8_24 x) {
     q8_24 f, zden, y, Bw, Aw, rz2, v, qz, rz, z, w;
     int N;
     log2_with_remainder(x, &N, &f, 24);
@@ -490,17 +518,21 @@ q8_24 dsp_math_log(uq8_24 x) {
         y = f - ONE_Q8_24;
         zden = (y >> 1) + ONE_Q8_24;
     }
-    z = dsp_math_divide(y, zden, 24);
-    w = dsp_math_multiply(z, z, 24);
-    Bw = dsp_math_multiply(B1_LOG, w, 24) + B0_LOG;
+    z = _dsp_math__divide(y, zden, 24);
+    w = _dsp_math__multiply(z, z, 24);
+    Bw = _dsp_math__multiply(B1_LOG, w, 24) + B0_LOG;
     Aw = A0_LOG;
-    rz2 = dsp_math_multiply(w, C + dsp_math_divide(Aw, Bw, 24), 24);
-    v = dsp_math_divide(HALF_Q8_24>>1, zden, 24);
-    qz = v + dsp_math_multiply(rz2, v, 24);
-    rz = dsp_math_multiply(4*y, qz, 24);
+    rz2 = _dsp_math__multiply(w, C + _dsp_math__divide(Aw, Bw, 24), 24);
+    v = _dsp_math__divide(HALF_Q8_24>>1, zden, 24);
+    qz = v + _dsp_math__multiply(rz2, v, 24);
+    rz = _dsp_math__multiply(4*y, qz, 24);
     return (N*LOG_C2+rz)+N*LOG_C1;
 }
 
+q8_24 dsp_math_log(uq8_24 x) {
+    return _dsp_math__log(x);
+}
+
 /******************************************************************
  * Derived from "Software Manual for the Elementary
  * Functions" by Cody and Waite.
@@ -571,3 +603,27 @@ q8_24 dsp_math_softplus(q8_24 x) {
     }
 }
 
+
+// The vector functions inline the scalar functions above, so each element
+// is computed without a call and the constants stay in registers.
+
+void dsp_vector_sqrt( const int32_t input_vector_X[], int32_t result_vector_R[], const int32_t vector_length )
+{
+    for( int32_t i = 0; i < vector_length; ++i ) {
+        result_vector_R[i] = _dsp_math__sqrt( input_vector_X[i] );
+    }
+}
+
+void dsp_vector_exp( const int32_t input_vector_X[], int32_t result_vector_R[], const int32_t vector_length )
+{
+    for( int32_t i = 0; i < vector_length; ++i ) {
+        result_vector_R[i] = _dsp_math__exp( input_vector_X[i] );
+    }
+}
+
+void dsp_vector_log( const int32_t input_vector_X[], int32_t result_vector_R[], const int32_t vector_length )
+{
+    for( int32_t i = 0; i < vector_length; ++i ) {
+        result_vector_R[i] = _dsp_math__log( input_vector_X[i] );
+    }
+}
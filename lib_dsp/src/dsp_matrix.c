@@ -2,6 +2,7 @@
 
 #include <platform.h>
 #include "dsp_qformat.h"
+#include "dsp_math.h"
 #include "dsp_vector.h"
 #include "dsp_matrix.h"
 
@@ -99,6 +100,39 @@ void dsp_matrix_subm
 #define MATRIX_X_IN_EXTERNAL_RAM 0
 #define MATRIX_Y_IN_EXTERNAL_RAM 0
 
+// Dot products of rows x0 and x1 of X with rows y0 and y1 of the transposed
+// Y, as a 2x2 tile of R, computed by dsp_matrix_mulm_2x2_xs2() one row of
+// the tile at a time: each pair of loaded X elements is used twice, for
+// three double word loads per four multiply-accumulates. Rows with an odd
+// length are not double word aligned, and use single word loads. Tiles on
+// the last row or column of an odd sized R pass the same row twice, which
+// is computed once, and r01 or r10 as 0 to skip the store.
+
+extern void dsp_matrix_mulm_2x2_xs2( const int32_t* x0, const int32_t* x1,
+                                     const int32_t* y0, const int32_t* y1,
+                                     int32_t length, int32_t q_format, int32_t r[4] );
+
+static void _dsp_matrix_mulm_2x2
+(
+    const int32_t* x0,
+    const int32_t* x1,
+    const int32_t* y0,
+    const int32_t* y1,
+    const int32_t  length,
+    const int32_t  q_format,
+    int32_t*       r00,
+    int32_t*       r01,
+    int32_t*       r10,
+    int32_t*       r11
+) {
+    int32_t r[4];
+    dsp_matrix_mulm_2x2_xs2( x0, x1, y0, y1, length, q_format, r );
+    *r00 = r[0];
+    if( r01 ) *r01 = r[1];
+    if( r10 ) *r10 = r[2];
+    if( r01 && r10 ) *r11 = r[3];
+}
+
 void dsp_matrix_mulm
 (
     const int32_t* input_matrix_X,
@@ -109,42 +143,272 @@ void dsp_matrix_mulm
     const int32_t  cols_X_rows_Y,
     const int32_t q_format
 ) {
-    int32_t ah; uint32_t al;
-
-    for( int32_t rx = 0; rx < rows_X; ++rx )
+    for( int32_t rx = 0; rx < rows_X; rx += 2 )
     {
+        int32_t last_row = (rx + 1 == rows_X);
 #if MATRIX_X_IN_EXTERNAL_RAM
         const int32_t* X_row_ptr = interface.get_array_ptr(0, rx); // matrix index and row vector index
+        const int32_t* X_row_ptr1 = last_row ? X_row_ptr : interface.get_array_ptr(0, rx + 1);
 #else
         const int32_t* X_row_ptr = &input_matrix_X[rx * cols_X_rows_Y];
+        const int32_t* X_row_ptr1 = last_row ? X_row_ptr : X_row_ptr + cols_X_rows_Y;
 #endif
+        int32_t* R_row_ptr = &result_matrix_R[rx * cols_Y];
 
         // column in X
-        for( int32_t cy = 0; cy < cols_Y; cy++ )
+        for( int32_t cy = 0; cy < cols_Y; cy += 2 )
         {
             // TODO: for large matrixes. provide the following arrays through shared memory
-
+            int32_t last_column = (cy + 1 == cols_Y);
 #if MATRIX_Y_IN_EXTERNAL_RAM
             const int32_t* Y_column_ptr = interface.get_array_ptr(1, cy); // matrix index and column vector index
+            const int32_t* Y_column_ptr1 = last_column ? Y_column_ptr : interface.get_array_ptr(1, cy + 1);
 #else
             const int32_t* Y_column_ptr = &input_matrix_Y[cy * cols_X_rows_Y];
+            const int32_t* Y_column_ptr1 = last_column ? Y_column_ptr : Y_column_ptr + cols_X_rows_Y;
 #endif
-            //
-            int32_t x1, x0;
-            int32_t y1, y0;
-            ah = 0; al = 1 << (q_format-1);
-            for(int32_t i = 0; i < (cols_X_rows_Y>>1); i++)
-            {
-                // load two items from row rx in X and two from column cy in Y
-                asm("ldd %0,%1,%2[%3]":"=r"(x1),"=r"(x0):"r"(X_row_ptr),"r"(i));
-                asm("ldd %0,%1,%2[%3]":"=r"(y1),"=r"(y0):"r"(Y_column_ptr),"r"(i));
-                // mutliply two x and two y
-                asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(x0),"r"(y0),"0"(ah),"1"(al));
-                asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(x1),"r"(y1),"0"(ah),"1"(al));
-            }
-            asm("lextract %0,%1,%2,%3,32": "=r"(ah):"r"(ah),"r"(al),"r"(q_format));
-            result_matrix_R[rx * cols_Y + cy] = ah;
+            _dsp_matrix_mulm_2x2( X_row_ptr, X_row_ptr1, Y_column_ptr, Y_column_ptr1,
+                                  cols_X_rows_Y, q_format,
+                                  &R_row_ptr[cy],
+                                  last_column ? 0 : &R_row_ptr[cy + 1],
+                                  last_row ? 0 : &R_row_ptr[cy + cols_Y],
+                                  &R_row_ptr[cy + cols_Y + 1] );
+        }
+    }
+}
+
+
+
+void dsp_matrix_mulm_pack
+(
+    const int32_t* input_matrix_Y,
+    int32_t*       packed_matrix_Y,
+    const int32_t  cols_X_rows_Y,
+    const int32_t  cols_Y
+) {
+    // Column pairs of Y, each as cols_X_rows_Y double words with the
+    // element of the even column in the low word
+    for( int32_t cy = 0; cy < cols_Y; cy += 2 )
+    {
+        int32_t* pair = &packed_matrix_Y[cy * cols_X_rows_Y];
+        for( int32_t i = 0; i < cols_X_rows_Y; i++ )
+        {
+            pair[2*i] = input_matrix_Y[i * cols_Y + cy];
+            pair[2*i+1] = (cy + 1 < cols_Y) ? input_matrix_Y[i * cols_Y + cy + 1] : 0;
+        }
+    }
+}
+
+// As _dsp_matrix_mulm_2x2, with both columns of Y loaded by one double word
+// load from the packed matrix: two loads for two multiply-accumulates, for
+// any row length
+
+extern void dsp_matrix_mulm_packed_2x2_xs2( const int32_t* x0, const int32_t* x1,
+                                            const int32_t* y, int32_t length,
+                                            int32_t q_format, int32_t r[4] );
+
+static void _dsp_matrix_mulm_packed_2x2
+(
+    const int32_t* x0,
+    const int32_t* x1,
+    const int32_t* y,
+    const int32_t  length,
+    const int32_t  q_format,
+    int32_t*       r00,
+    int32_t*       r01,
+    int32_t*       r10,
+    int32_t*       r11
+) {
+    int32_t r[4];
+    dsp_matrix_mulm_packed_2x2_xs2( x0, x1, y, length, q_format, r );
+    *r00 = r[0];
+    if( r01 ) *r01 = r[1];
+    if( r10 ) *r10 = r[2];
+    if( r01 && r10 ) *r11 = r[3];
+}
+
+void dsp_matrix_mulm_packed
+(
+    const int32_t* input_matrix_X,
+    const int32_t* packed_matrix_Y,
+    int32_t*       result_matrix_R,
+    const int32_t  rows_X,
+    const int32_t  cols_Y,
+    const int32_t  cols_X_rows_Y,
+    const int32_t q_format
+) {
+    for( int32_t rx = 0; rx < rows_X; rx += 2 )
+    {
+        int32_t last_row = (rx + 1 == rows_X);
+        const int32_t* X_row_ptr = &input_matrix_X[rx * cols_X_rows_Y];
+        const int32_t* X_row_ptr1 = last_row ? X_row_ptr : X_row_ptr + cols_X_rows_Y;
+        int32_t* R_row_ptr = &result_matrix_R[rx * cols_Y];
+
+        for( int32_t cy = 0; cy < cols_Y; cy += 2 )
+        {
+            int32_t last_column = (cy + 1 == cols_Y);
+            _dsp_matrix_mulm_packed_2x2( X_row_ptr, X_row_ptr1, &packed_matrix_Y[cy * cols_X_rows_Y],
+                                         cols_X_rows_Y, q_format,
+                                         &R_row_ptr[cy],
+                                         last_column ? 0 : &R_row_ptr[cy + 1],
+                                         last_row ? 0 : &R_row_ptr[cy + cols_Y],
+                                         &R_row_ptr[cy + cols_Y + 1] );
+        }
+    }
+}
+
+
+
+// Matrix / vector products are computed two rows at a time, so that each
+// element of the vector is loaded once for two products. An odd last row
+// is computed twice, and y1 passed as 0 to skip the store.
+
+static void _dsp_matrix_mulv_2
+(
+    const int32_t* a0,
+    const int32_t* a1,
+    const int32_t* x,
+    const int32_t  length,
+    const int32_t  q_format,
+    int32_t*       y0,
+    int32_t*       y1
+) {
+    int32_t h0 = 0, h1 = 0;
+    uint32_t l0 = 1 << (q_format-1), l1 = 1 << (q_format-1);
+
+    if( (length & 1) == 0 )
+    {
+        for( int32_t i = 0; i < (length>>1); i++ )
+        {
+            int32_t x1, x0, w1, w0;
+            asm("ldd %0,%1,%2[%3]":"=r"(x1),"=r"(x0):"r"(x),"r"(i));
+            asm("ldd %0,%1,%2[%3]":"=r"(w1),"=r"(w0):"r"(a0),"r"(i));
+            asm("maccs %0,%1,%2,%3":"=r"(h0),"=r"(l0):"r"(x0),"r"(w0),"0"(h0),"1"(l0));
+            asm("maccs %0,%1,%2,%3":"=r"(h0),"=r"(l0):"r"(x1),"r"(w1),"0"(h0),"1"(l0));
+            asm("ldd %0,%1,%2[%3]":"=r"(w1),"=r"(w0):"r"(a1),"r"(i));
+            asm("maccs %0,%1,%2,%3":"=r"(h1),"=r"(l1):"r"(x0),"r"(w0),"0"(h1),"1"(l1));
+            asm("maccs %0,%1,%2,%3":"=r"(h1),"=r"(l1):"r"(x1),"r"(w1),"0"(h1),"1"(l1));
+        }
+    }
+    else
+    {
+        for( int32_t i = 0; i < length; i++ )
+        {
+            int32_t x0 = x[i], w0 = a0[i], w1 = a1[i];
+            asm("maccs %0,%1,%2,%3":"=r"(h0),"=r"(l0):"r"(x0),"r"(w0),"0"(h0),"1"(l0));
+            asm("maccs %0,%1,%2,%3":"=r"(h1),"=r"(l1):"r"(x0),"r"(w1),"0"(h1),"1"(l1));
+        }
+    }
+    asm("lsats %0,%1,%2":"=r"(h0),"=r"(l0):"r"(q_format),"0"(h0),"1"(l0));
+    asm("lextract %0,%1,%2,%3,32":"=r"(h0):"r"(h0),"r"(l0),"r"(q_format));
+    asm("lsats %0,%1,%2":"=r"(h1),"=r"(l1):"r"(q_format),"0"(h1),"1"(l1));
+    asm("lextract %0,%1,%2,%3,32":"=r"(h1):"r"(h1),"r"(l1),"r"(q_format));
+    *y0 = h0;
+    if( y1 ) *y1 = h1;
+}
+
+void dsp_matrix_mulv
+(
+    const int32_t* input_matrix_A,
+    const int32_t* input_vector_X,
+    int32_t*       result_vector_Y,
+    const int32_t  rows_A,
+    const int32_t  cols_A,
+    const int32_t  q_format
+) {
+    for( int32_t r = 0; r < rows_A; r += 2 )
+    {
+        const int32_t* row0 = &input_matrix_A[r * cols_A];
+        const int32_t* row1 = (r + 1 == rows_A) ? row0 : row0 + cols_A;
+        _dsp_matrix_mulv_2( row0, row1, input_vector_X, cols_A, q_format, &result_vector_Y[r],
+                            (r + 1 == rows_A) ? 0 : &result_vector_Y[r + 1] );
+    }
+}
+
+
+
+// Accumulator for a row of a layer, starting at the bias, in the output
+// format and so shifted up to the accumulator format, and the rounding
+// constant of the requantization
+
+static inline void _dsp_matrix_layer_init( const int32_t bias, const int32_t shift, int32_t* h, uint32_t* l )
+{
+    int64_t acc = (int64_t) bias * (1LL << shift) + (shift > 0 ? (1LL << (shift - 1)) : 0);
+    *h = (int32_t) (acc >> 32);
+    *l = (uint32_t) acc;
+}
+
+static inline int32_t _dsp_matrix_layer_output( int32_t h, uint32_t l, const int32_t shift,
+                                                const dsp_activation_t activation )
+{
+    asm("lsats %0,%1,%2":"=r"(h),"=r"(l):"r"(shift),"0"(h),"1"(l));
+    asm("lextract %0,%1,%2,%3,32":"=r"(h):"r"(h),"r"(l),"r"(shift));
+    switch( activation )
+    {
+        case DSP_ACTIVATION_RELU:     return h < 0 ? 0 : h;
+        case DSP_ACTIVATION_LOGISTIC: return dsp_math_logistics_fast( h );
+        case DSP_ACTIVATION_SOFTPLUS: return dsp_math_softplus( h );
+        default:                      return h;
+    }
+}
+
+void dsp_matrix_mulv_w16
+(
+    const int16_t*          weights,
+    const int32_t*          input_vector_X,
+    const int32_t*          bias,
+    int32_t*                result_vector_Y,
+    const int32_t           rows,
+    const int32_t           cols,
+    const int32_t           shift,
+    const dsp_activation_t  activation
+) {
+    for( int32_t r = 0; r < rows; r += 2 )
+    {
+        int32_t last_row = (r + 1 == rows);
+        const int16_t* w0 = &weights[r * cols];
+        const int16_t* w1 = last_row ? w0 : w0 + cols;
+        int32_t h0, h1; uint32_t l0, l1;
+        _dsp_matrix_layer_init( bias[r], shift, &h0, &l0 );
+        _dsp_matrix_layer_init( bias[last_row ? r : r + 1], shift, &h1, &l1 );
+        for( int32_t i = 0; i < cols; i++ )
+        {
+            int32_t x0 = input_vector_X[i], a0 = w0[i], a1 = w1[i];
+            asm("maccs %0,%1,%2,%3":"=r"(h0),"=r"(l0):"r"(x0),"r"(a0),"0"(h0),"1"(l0));
+            asm("maccs %0,%1,%2,%3":"=r"(h1),"=r"(l1):"r"(x0),"r"(a1),"0"(h1),"1"(l1));
+        }
+        result_vector_Y[r] = _dsp_matrix_layer_output( h0, l0, shift, activation );
+        if( !last_row ) result_vector_Y[r + 1] = _dsp_matrix_layer_output( h1, l1, shift, activation );
+    }
+}
+
+void dsp_matrix_mulv_w8
+(
+    const int8_t*           weights,
+    const int32_t*          input_vector_X,
+    const int32_t*          bias,
+    int32_t*                result_vector_Y,
+    const int32_t           rows,
+    const int32_t           cols,
+    const int32_t           shift,
+    const dsp_activation_t  activation
+) {
+    for( int32_t r = 0; r < rows; r += 2 )
+    {
+        int32_t last_row = (r + 1 == rows);
+        const int8_t* w0 = &weights[r * cols];
+        const int8_t* w1 = last_row ? w0 : w0 + cols;
+        int32_t h0, h1; uint32_t l0, l1;
+        _dsp_matrix_layer_init( bias[r], shift, &h0, &l0 );
+        _dsp_matrix_layer_init( bias[last_row ? r : r + 1], shift, &h1, &l1 );
+        for( int32_t i = 0; i < cols; i++ )
+        {
+            int32_t x0 = input_vector_X[i], a0 = w0[i], a1 = w1[i];
+            asm("maccs %0,%1,%2,%3":"=r"(h0),"=r"(l0):"r"(x0),"r"(a0),"0"(h0),"1"(l0));
+            asm("maccs %0,%1,%2,%3":"=r"(h1),"=r"(l1):"r"(x0),"r"(a1),"0"(h1),"1"(l1));
         }
+        result_vector_Y[r] = _dsp_matrix_layer_output( h0, l0, shift, activation );
+        if( !last_row ) result_vector_Y[r + 1] = _dsp_matrix_layer_output( h1, l1, shift, activation );
     }
 }
 
@@ -0,0 +1,190 @@
+// Copyright (c) 2017, XMOS Ltd, All rights reserved
+#include <stdint.h>
+#include <math.h>
+#include "dsp_dct.h"
+#include "dsp_fft.h"
+
+/* MDCT of M coefficients from frames of 2M windowed samples, hopping by M.
+ *
+ * The windowed frame z = [a, b, c, d] (four quarters of M/2 samples) is
+ * folded into u = [-c_r - d, a - b_r], where _r denotes reversal, and the
+ * MDCT is the M point DCT-IV of u. The folding and windowing are fused into
+ * the pre-rotation of the DCT-IV, which is computed with an M/2 point complex
+ * FFT as in dsp_dct_iv_forward(). The inverse unfolds the DCT-IV back into
+ * [a - b_r, b - a_r, c + d_r, d + c_r], windows it again and overlap-adds
+ * the first half onto the second half of the previous frame; with a window
+ * that satisfies w[n]^2 + w[M-1-n]^2 = 1 the time domain aliasing cancels.
+ */
+
+static const double pi = 3.14159265358979323846;
+
+static int32_t _dsp_mdct__q31( double x )
+{
+    double v = x * 2147483648.0;
+    if( v >= 2147483647.0 ) return 0x7fffffff;
+    return (int32_t) (v + 0.5);
+}
+
+void dsp_mdct_window_sine( int32_t window[], const uint32_t M )
+{
+    for( uint32_t n = 0; n < M; ++n ) {
+        window[n] = _dsp_mdct__q31( sin( pi * (n + 0.5) / (2.0 * M) ) );
+    }
+}
+
+static double _dsp_mdct__bessel_i0( double x )
+{
+    double sum = 1.0, term = 1.0;
+    for( int32_t k = 1; k < 50 && term > 1e-12 * sum; ++k ) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+void dsp_mdct_window_kbd( int32_t window[], const uint32_t M, const double alpha )
+{
+    double total = 0.0, sum = 0.0;
+    for( uint32_t n = 0; n <= M; ++n ) {
+        double r = 2.0 * n / M - 1.0;
+        total += _dsp_mdct__bessel_i0( pi * alpha * sqrt( 1.0 - r * r ) );
+    }
+    for( uint32_t n = 0; n < M; ++n ) {
+        double r = 2.0 * n / M - 1.0;
+        sum += _dsp_mdct__bessel_i0( pi * alpha * sqrt( 1.0 - r * r ) );
+        window[n] = _dsp_mdct__q31( sqrt( sum / total ) );
+    }
+}
+
+
+
+static inline void _dsp_mdct__twiddle( const int32_t sine[], const uint32_t quarter,
+                                       uint32_t t, int32_t* c, int32_t* s )
+{
+    // Only the first quadrant is used; the shared table is read with a stride
+    t *= DSP_SINE_STRIDE(4*quarter);
+    *c = sine[DSP_SINE_POINTS(4*quarter)/4 - t]; *s = sine[t];
+}
+
+static inline int32_t _dsp_mdct__round( int64_t x, const int32_t shift )
+{
+    return (int32_t) ((x + (1LL << (shift - 1))) >> shift);
+}
+
+// Half of u[i], folded from the frame [state, input] and windowed with the
+// rising half window[0..M-1] and its mirror image
+
+static inline int32_t _dsp_mdct__fold( const int32_t state[], const int32_t input[],
+                                       const int32_t window[], const uint32_t M, const uint32_t i )
+{
+    int64_t u;
+    if( i < (M >> 1) ) {
+        uint32_t c = (M >> 1) - 1 - i, d = (M >> 1) + i; // 3M/2-1-i and 3M/2+i
+        u = - (int64_t) input[c] * window[M - 1 - c] - (int64_t) input[d] * window[M - 1 - d];
+    } else {
+        uint32_t a = i - (M >> 1), b = M - 1 - a;
+        u = (int64_t) state[a] * window[a] - (int64_t) state[b] * window[b];
+    }
+    return _dsp_mdct__round( u, 32 );
+}
+
+void dsp_mdct_forward
+(
+    int32_t         coeffs[],
+    const int32_t   input[],
+    int32_t         state[],
+    dsp_complex_t   scratch[],
+    const uint32_t  M,
+    const int32_t   window[],
+    const int32_t   sine[],
+    const int32_t   dct_sine[]
+) {
+    uint32_t quarter = M << 1;
+
+    // Folded, windowed and rotated by W_8M^(4n+1); halved once more so that
+    // the complex pair stays within range
+    for( uint32_t n = 0; n < (M >> 1); ++n )
+    {
+        int32_t c, s;
+        int32_t ua = _dsp_mdct__fold( state, input, window, M, 2*n );
+        int32_t ub = _dsp_mdct__fold( state, input, window, M, M - 1 - 2*n );
+        _dsp_mdct__twiddle( dct_sine, quarter, 4*n + 1, &c, &s );
+        scratch[n].re = _dsp_mdct__round( (int64_t) c * ua + (int64_t) s * ub, 32 );
+        scratch[n].im = _dsp_mdct__round( (int64_t) c * ub - (int64_t) s * ua, 32 );
+    }
+    for( uint32_t n = 0; n < M; ++n ) state[n] = input[n];
+
+    dsp_fft_bit_reverse( scratch, M >> 1 );
+    dsp_fft_forward( scratch, M >> 1, sine );
+
+    for( uint32_t k = 0; k < (M >> 1); ++k )
+    {
+        int32_t c, s, z_re = scratch[k].re, z_im = scratch[k].im;
+        _dsp_mdct__twiddle( dct_sine, quarter, 4*k, &c, &s );
+        coeffs[2*k] = _dsp_mdct__round( (int64_t) c * z_re + (int64_t) s * z_im, 31 );
+        coeffs[M - 1 - 2*k] = _dsp_mdct__round( (int64_t) s * z_re - (int64_t) c * z_im, 31 );
+    }
+}
+
+
+
+void dsp_mdct_inverse
+(
+    int32_t         output[],
+    const int32_t   coeffs[],
+    int32_t         state[],
+    dsp_complex_t   scratch[],
+    const uint32_t  M,
+    const int32_t   window[],
+    const int32_t   sine[],
+    const int32_t   dct_sine[]
+) {
+    uint32_t quarter = M << 1, half = M >> 1;
+    int32_t* u = (int32_t*) scratch;
+
+    // DCT-IV through a conjugated inverse FFT, as dsp_dct_iv_inverse()
+    for( uint32_t n = 0; n < half; ++n )
+    {
+        int32_t c, s, xa = coeffs[2*n], xb = coeffs[M - 1 - 2*n];
+        _dsp_mdct__twiddle( dct_sine, quarter, 4*n + 1, &c, &s );
+        scratch[n].re = _dsp_mdct__round( (int64_t) c * xa + (int64_t) s * xb, 31 );
+        scratch[n].im = - _dsp_mdct__round( (int64_t) c * xb - (int64_t) s * xa, 31 );
+    }
+    dsp_fft_bit_reverse( scratch, half );
+    dsp_fft_inverse( scratch, half, sine );
+
+    // Post-rotation in place, to half of u; points k and M/2-1-k together
+    // occupy the four words that they write
+    for( uint32_t k = 0; k < (half + 1) >> 1; ++k )
+    {
+        uint32_t j = half - 1 - k;
+        int32_t c, s, zk_re = scratch[k].re, zk_im = -scratch[k].im;
+        int32_t zj_re = scratch[j].re, zj_im = -scratch[j].im;
+        _dsp_mdct__twiddle( dct_sine, quarter, 4*k, &c, &s );
+        u[2*k] = _dsp_mdct__round( (int64_t) c * zk_re + (int64_t) s * zk_im, 30 );
+        u[M - 1 - 2*k] = _dsp_mdct__round( (int64_t) s * zk_re - (int64_t) c * zk_im, 30 );
+        if( j != k ) {
+            _dsp_mdct__twiddle( dct_sine, quarter, 4*j, &c, &s );
+            u[2*j] = _dsp_mdct__round( (int64_t) c * zj_re + (int64_t) s * zj_im, 30 );
+            u[M - 1 - 2*j] = _dsp_mdct__round( (int64_t) s * zj_re - (int64_t) c * zj_im, 30 );
+        }
+    }
+
+    // First half of the unfolded frame is [a - b_r, b - a_r], windowed and
+    // added to the stored second half of the previous frame
+    for( uint32_t n = 0; n < half; ++n )
+    {
+        int32_t y = u[half + n];
+        output[n] = _dsp_mdct__round( (int64_t) y * window[n] + (int64_t) state[n] * (1LL << 31), 30 );
+        output[M - 1 - n] = _dsp_mdct__round( - (int64_t) y * window[M - 1 - n]
+                                              + (int64_t) state[M - 1 - n] * (1LL << 31), 30 );
+    }
+
+    // Second half is [c + d_r, d + c_r], windowed with the falling half
+    for( uint32_t n = 0; n < half; ++n )
+    {
+        int32_t y = -u[n];
+        state[half - 1 - n] = _dsp_mdct__round( (int64_t) y * window[half + n], 31 );
+        state[half + n] = _dsp_mdct__round( (int64_t) y * window[half - 1 - n], 31 );
+    }
+}
@@ -172,3 +172,63 @@ int32_t dsp_vector_dotprod
     asm("lextract %0,%1,%2,%3,32":"=r"(ah):"r"(ah),"r"(al),"r"(q_format));
     return ah;
 }
+
+
+// One pass over the vector for all of the above. Per element this is two
+// compares for the minimum and maximum, and two multiply-accumulates, for
+// the absolute sum (scaled by 2^q_format, as dsp_vector_abs_sum) and for
+// the power.
+
+#define _DSP_VECTOR_STATS_STEP(x, i) do { \
+    if( x < min_val ) { min_val = x; min_loc = i; } \
+    if( x > max_val ) { max_val = x; max_loc = i; } \
+    asm("maccs %0,%1,%2,%3":"=r"(ph),"=r"(pl):"r"(x),"r"(x),"0"(ph),"1"(pl)); \
+    if( x < 0 ) x = -x; \
+    asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(x),"r"(1<<q_format),"0"(ah),"1"(al)); \
+} while( 0 )
+
+dsp_vector_stats_t dsp_vector_stats
+(
+    const int32_t* input_vector_X,
+    int32_t        vector_length,
+    const int32_t  q_format
+) {
+    dsp_vector_stats_t stats;
+    int32_t ah=0, ph=0, x1, x0; uint32_t al=0, pl=0;
+    int32_t min_val = 2147483647, max_val = -2147483648;
+    int32_t min_loc = 0, max_loc = 0, i = 0, n = vector_length;
+
+    if( n <= 0 )
+    {
+        stats.minimum = stats.minimum_index = 0;
+        stats.maximum = stats.maximum_index = 0;
+        stats.abs_sum = stats.mean = stats.power = stats.rms = 0;
+        return stats;
+    }
+    while( n - i >= 2 )
+    {
+        asm("ldd %0,%1,%2[0]":"=r"(x1),"=r"(x0):"r"(input_vector_X + i));
+        _DSP_VECTOR_STATS_STEP( x0, i );
+        _DSP_VECTOR_STATS_STEP( x1, i + 1 );
+        i += 2;
+    }
+    if( i < n )
+    {
+        x0 = input_vector_X[i];
+        _DSP_VECTOR_STATS_STEP( x0, i );
+    }
+    asm("lsats %0,%1,%2":"=r"(ah),"=r"(al):"r"(q_format),"0"(ah),"1"(al));
+    asm("lextract %0,%1,%2,%3,32":"=r"(ah):"r"(ah),"r"(al),"r"(q_format));
+    asm("lsats %0,%1,%2":"=r"(ph),"=r"(pl):"r"(q_format),"0"(ph),"1"(pl));
+    asm("lextract %0,%1,%2,%3,32":"=r"(ph):"r"(ph),"r"(pl),"r"(q_format));
+
+    stats.minimum = min_val;
+    stats.minimum_index = min_loc;
+    stats.maximum = max_val;
+    stats.maximum_index = max_loc;
+    stats.abs_sum = ah;
+    stats.mean = dsp_math_divide( ah, (vector_length << q_format), q_format );
+    stats.power = ph;
+    stats.rms = dsp_math_sqrt( dsp_math_divide( ph, (vector_length << q_format), q_format ) );
+    return stats;
+}
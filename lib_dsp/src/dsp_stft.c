@@ -0,0 +1,122 @@
+// Copyright (c) 2017, XMOS Ltd, All rights reserved
+#include <stdint.h>
+#include <math.h>
+#include "dsp_stft.h"
+#include "dsp_fft.h"
+
+// State layout: [0] N, [1] hop, [2] ring buffer position, [3] samples
+// counted towards the hop, then N samples. The analysis ring buffer holds
+// the last N input samples, oldest at the position; the synthesis ring
+// buffer holds the overlap-add accumulator, next output at the position.
+
+#define _DSP_STFT_N        0
+#define _DSP_STFT_HOP      1
+#define _DSP_STFT_POSITION 2
+#define _DSP_STFT_COUNT    3
+#define _DSP_STFT_BUFFER   4
+
+static double pi = 3.14159265358979323846;
+
+void dsp_stft_window_sqrt_hann( int32_t window[], const uint32_t N, const uint32_t hop )
+{
+    // A periodic Hann window overlap-adds to N/(2*hop)
+    double scale = 2.0 * hop / N;
+    for( uint32_t n = 0; n < N; ++n ) {
+        double w = sqrt( scale * 0.5 * (1.0 - cos( 2.0 * pi * n / N )) ) * 2147483648.0;
+        window[n] = w >= 2147483647.0 ? 0x7fffffff : (int32_t) (w + 0.5);
+    }
+}
+
+static void _dsp_stft__init( int32_t state[], const uint32_t N, const uint32_t hop, const int32_t count )
+{
+    state[_DSP_STFT_N] = N;
+    state[_DSP_STFT_HOP] = hop;
+    state[_DSP_STFT_POSITION] = 0;
+    state[_DSP_STFT_COUNT] = count;
+    for( uint32_t i = 0; i < N; ++i ) state[_DSP_STFT_BUFFER + i] = 0;
+}
+
+
+
+void dsp_stft_analysis_init( int32_t state[], const uint32_t N, const uint32_t hop )
+{
+    _dsp_stft__init( state, N, hop, 0 );
+}
+
+uint32_t dsp_stft_analysis_push( int32_t state[], const int32_t input[], const uint32_t n )
+{
+    uint32_t N = state[_DSP_STFT_N], hop = state[_DSP_STFT_HOP];
+    uint32_t position = state[_DSP_STFT_POSITION], count = state[_DSP_STFT_COUNT];
+    int32_t* ring = state + _DSP_STFT_BUFFER;
+    uint32_t i;
+
+    for( i = 0; i < n && count < hop; ++i, ++count ) {
+        ring[position] = input[i];
+        if( ++position == N ) position = 0;
+    }
+    state[_DSP_STFT_POSITION] = position;
+    state[_DSP_STFT_COUNT] = count;
+    return i;
+}
+
+int32_t dsp_stft_analysis_frame( int32_t frame[], int32_t state[], const int32_t window[],
+                                 const int32_t sine[], const int32_t sin2[] )
+{
+    uint32_t N = state[_DSP_STFT_N], position = state[_DSP_STFT_POSITION];
+    const int32_t* ring = state + _DSP_STFT_BUFFER;
+
+    if( state[_DSP_STFT_COUNT] != state[_DSP_STFT_HOP] ) return 0;
+    state[_DSP_STFT_COUNT] = 0;
+
+    for( uint32_t j = 0; j < N; ++j ) {
+        int64_t x = (int64_t) ring[position] * window[j];
+        frame[j] = (int32_t) ((x + (1 << 30)) >> 31);
+        if( ++position == N ) position = 0;
+    }
+    dsp_fft_bit_reverse_and_forward_real( frame, N, sine, sin2 );
+    return 1;
+}
+
+
+
+void dsp_stft_synthesis_init( int32_t state[], const uint32_t N, const uint32_t hop )
+{
+    _dsp_stft__init( state, N, hop, 0 );
+}
+
+int32_t dsp_stft_synthesis_frame( int32_t frame[], int32_t state[], const int32_t window[],
+                                  const int32_t sine[], const int32_t sin2[] )
+{
+    uint32_t N = state[_DSP_STFT_N], hop = state[_DSP_STFT_HOP];
+    uint32_t position = state[_DSP_STFT_POSITION];
+    int32_t* acc = state + _DSP_STFT_BUFFER;
+
+    if( state[_DSP_STFT_COUNT] != 0 ) return 0;
+
+    dsp_fft_bit_reverse_and_inverse_real( frame, N, sine, sin2 );
+    for( uint32_t j = 0; j < N; ++j ) {
+        int64_t x = (int64_t) frame[j] * window[j];
+        acc[position] += (int32_t) ((x + (1 << 30)) >> 31);
+        if( ++position == N ) position = 0;
+    }
+    state[_DSP_STFT_COUNT] = hop;
+    return 1;
+}
+
+uint32_t dsp_stft_synthesis_pull( int32_t output[], int32_t state[], const uint32_t n )
+{
+    uint32_t N = state[_DSP_STFT_N];
+    uint32_t position = state[_DSP_STFT_POSITION], count = state[_DSP_STFT_COUNT];
+    int32_t* acc = state + _DSP_STFT_BUFFER;
+    uint32_t i;
+
+    // Completed samples are cleared for the frame that ends there next
+    for( i = 0; i < n && count > 0; ++i, --count ) {
+        output[i] = acc[position];
+        acc[position] = 0;
+        if( ++position == N ) position = 0;
+    }
+    state[_DSP_STFT_POSITION] = position;
+    state[_DSP_STFT_COUNT] = count;
+    return i;
+}
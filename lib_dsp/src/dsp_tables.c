@@ -1,25 +1,39 @@
 // Copyright (c) 2015-2017, XMOS Ltd, All rights reserved
 #include <stdint.h>
+#include "dsp_fft.h"
 
+// Only the table read by all FFTs is linked in when DSP_SINE_SHARED is set,
+// and none when DSP_SINE_GENERATED is set
+#define _DSP_SINE_LINKED(N) (!DSP_SINE_GENERATED && (!DSP_SINE_SHARED || DSP_SINE_SHARED == (N)))
+
+#if _DSP_SINE_LINKED(4)
 const int32_t dsp_sine_4[2] = {
            0, 2147483647,
 };
+#endif
 
+#if _DSP_SINE_LINKED(8)
 const int32_t dsp_sine_8[3] = {
            0, 1518500249, 2147483647,
 };
+#endif
 
+#if _DSP_SINE_LINKED(16)
 const int32_t dsp_sine_16[5] = {
            0,  821806413, 1518500249, 1984016188,
   2147483647,
 };
+#endif
 
+#if _DSP_SINE_LINKED(32)
 const int32_t dsp_sine_32[9] = {
            0,  418953276,  821806413, 1193077990,
   1518500249, 1785567396, 1984016188, 2106220351,
   2147483647,
 };
+#endif
 
+#if _DSP_SINE_LINKED(64)
 const int32_t dsp_sine_64[17] = {
            0,  210490206,  418953276,  623381597,
    821806413, 1012316784, 1193077990, 1362349204,
@@ -27,7 +41,9 @@ const int32_t dsp_sine_64[17] = {
   1984016188, 2055013723, 2106220351, 2137142927,
   2147483647,
 };
+#endif
 
+#if _DSP_SINE_LINKED(128)
 const int32_t dsp_sine_128[33] = {
            0,  105372028,  210490206,  315101294,
    418953276,  521795963,  623381597,  723465451,
@@ -39,7 +55,9 @@ const int32_t dsp_sine_128[33] = {
   2106220351, 2124240380, 2137142927, 2144896909,
   2147483647,
 };
+#endif
 
+#if _DSP_SINE_LINKED(256)
 const int32_t dsp_sine_256[65] = {
            0,   52701886,  105372028,  157978697,
    210490206,  262874923,  315101294,  367137860,
@@ -59,7 +77,9 @@ const int32_t dsp_sine_256[65] = {
   2137142927, 2141664948, 2144896909, 2146836866,
   2147483647,
 };
+#endif
 
+#if _DSP_SINE_LINKED(512)
 const int32_t dsp_sine_512[129] = {
            0,   26352927,   52701886,   79042909,
    105372028,  131685278,  157978697,  184248325,
@@ -95,7 +115,9 @@ const int32_t dsp_sine_512[129] = {
   2144896909, 2146028479, 2146836866, 2147321946,
   2147483647,
 };
+#endif
 
+#if _DSP_SINE_LINKED(1024)
 const int32_t dsp_sine_1024[257] = {
            0,   13176711,   26352927,   39528151,
     52701886,   65873638,   79042909,   92209204,
@@ -163,7 +185,9 @@ const int32_t dsp_sine_1024[257] = {
   2146836866, 2147119825, 2147321946, 2147443222,
   2147483647,
 };
+#endif
 
+#if _DSP_SINE_LINKED(2048)
 const int32_t dsp_sine_2048[513] = {
            0,    6588386,   13176711,   19764912,
     26352927,   32940694,   39528151,   46115236,
@@ -295,7 +319,9 @@ const int32_t dsp_sine_2048[513] = {
   2147321946, 2147392690, 2147443222, 2147473541,
   2147483647,
 };
+#endif
 
+#if _DSP_SINE_LINKED(4096)
 const int32_t dsp_sine_4096[1025] = {
            0,    3294197,    6588386,    9882561,
     13176711,   16470831,   19764912,   23058947,
@@ -555,7 +581,9 @@ const int32_t dsp_sine_4096[1025] = {
   2147443222, 2147460908, 2147473541, 2147481121,
   2147483647,
 };
+#endif
 
+#if _DSP_SINE_LINKED(8192)
 const int32_t dsp_sine_8192[2049] = {
            0,    1647099,    3294197,    4941293,
      6588386,    8235476,    9882561,   11529639,
@@ -1071,7 +1099,9 @@ const int32_t dsp_sine_8192[2049] = {
   2147473541, 2147477963, 2147481121, 2147483016,
   2147483647,
 };
+#endif
 
+#if _DSP_SINE_LINKED(16384)
 const int32_t dsp_sine_16384[4097] = {
            0,     823549,    1647099,    2470648,
      3294197,    4117745,    4941293,    5764840,
@@ -2099,3 +2129,4 @@ const int32_t dsp_sine_16384[4097] = {
   2147481121, 2147482226, 2147483016, 2147483490,
   2147483647,
 };
+#endif
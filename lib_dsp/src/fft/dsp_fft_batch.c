@@ -0,0 +1,126 @@
+// Copyright (c) 2017, XMOS Ltd, All rights reserved
+#include <stdint.h>
+#include "dsp_fft.h"
+
+#if defined(__XS2A__)
+
+// Interleaved radix-2 passes over n_signals arrays of N points. Each twiddle
+// factor is loaded once per pass and applied to the matching butterflies of
+// every signal. The butterflies are those of dsp_fft_forward_xs1() and
+// dsp_fft_inverse_xs1(); forward passes halve their outputs, inverse passes
+// do not.
+
+static void _dsp_fft_batch
+(
+    dsp_complex_t  pts[],
+    const uint32_t n_signals,
+    const uint32_t N,
+    const int32_t  sine[],
+    const int32_t  inverse
+) {
+    uint32_t quarter = DSP_SINE_POINTS(N) >> 2;
+
+    for( uint32_t s = 0; s < n_signals; ++s ) dsp_fft_bit_reverse( pts + s * N, N );
+
+    for( uint32_t step = 2; step <= N; step *= 2 )
+    {
+        uint32_t step2 = step >> 1;
+        for( uint32_t k = 0; k < step2; ++k )
+        {
+            uint32_t t = k * (N / step) * DSP_SINE_STRIDE(N);
+            int32_t rRe, rIm, nIm;
+            if( t <= quarter ) { rRe = sine[quarter - t]; rIm = sine[t]; }
+            else { rRe = -sine[t - quarter]; rIm = sine[2*quarter - t]; }
+            nIm = -rIm;
+
+            for( dsp_complex_t* p = pts + k; p < pts + n_signals * N; p += step )
+            {
+                int32_t tRe, tIm, tRe2, tIm2, sRe2, sIm2, ah; uint32_t al;
+                asm("ldd %0,%1,%2[0]":"=r"(tIm),"=r"(tRe):"r"(p));
+                asm("ldd %0,%1,%2[0]":"=r"(tIm2),"=r"(tRe2):"r"(p + step2));
+                if( inverse )
+                {
+                    ah = 0; al = 0x80000000;
+                    asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(tRe2),"r"(rRe),"0"(ah),"1"(al));
+                    asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(tIm2),"r"(nIm),"0"(ah),"1"(al));
+                    sRe2 = ah << 1;
+                    ah = 0; al = 0x80000000;
+                    asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(tRe2),"r"(rIm),"0"(ah),"1"(al));
+                    asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(tIm2),"r"(rRe),"0"(ah),"1"(al));
+                    sIm2 = ah << 1;
+                }
+                else
+                {
+                    ah = 0; al = 0x80000000;
+                    asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(tRe2),"r"(rRe),"0"(ah),"1"(al));
+                    asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(tIm2),"r"(rIm),"0"(ah),"1"(al));
+                    sRe2 = ah;
+                    ah = 0; al = 0x80000000;
+                    asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(tRe2),"r"(nIm),"0"(ah),"1"(al));
+                    asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(tIm2),"r"(rRe),"0"(ah),"1"(al));
+                    sIm2 = ah;
+                    tRe >>= 1;
+                    tIm >>= 1;
+                }
+                asm("std %0,%1,%2[0]"::"r"(tIm + sIm2),"r"(tRe + sRe2),"r"(p));
+                asm("std %0,%1,%2[0]"::"r"(tIm - sIm2),"r"(tRe - sRe2),"r"(p + step2));
+            }
+        }
+    }
+}
+
+
+
+void dsp_fft_forward_batch
+(
+    dsp_complex_t  pts[],
+    const uint32_t n_signals,
+    const uint32_t N,
+    const int32_t  sine[]
+) {
+    _dsp_fft_batch( pts, n_signals, N, sine, 0 );
+}
+
+
+
+void dsp_fft_inverse_batch
+(
+    dsp_complex_t  pts[],
+    const uint32_t n_signals,
+    const uint32_t N,
+    const int32_t  sine[]
+) {
+    _dsp_fft_batch( pts, n_signals, N, sine, 1 );
+}
+
+
+
+void dsp_fft_forward_tworeals_batch
+(
+    dsp_complex_t  pts[],
+    const uint32_t n_signals,
+    const uint32_t N,
+    const int32_t  sine[]
+) {
+    uint32_t n_arrays = (n_signals + 1) >> 1;
+
+    _dsp_fft_batch( pts, n_arrays, N, sine, 0 );
+    for( uint32_t a = 0; a < n_arrays; ++a ) dsp_fft_split_spectrum( pts + a * N, N );
+}
+
+
+
+void dsp_fft_inverse_tworeals_batch
+(
+    dsp_complex_t  pts[],
+    const uint32_t n_signals,
+    const uint32_t N,
+    const int32_t  sine[]
+) {
+    uint32_t n_arrays = (n_signals + 1) >> 1;
+
+    for( uint32_t a = 0; a < n_arrays; ++a ) dsp_fft_merge_spectra( pts + a * N, N );
+    _dsp_fft_batch( pts, n_arrays, N, sine, 1 );
+}
+
+#endif
@@ -0,0 +1,105 @@
+// Copyright (c) 2017, XMOS Ltd, All rights reserved
+#include <stdint.h>
+#include "dsp_fft.h"
+
+/* Block floating point radix 2 FFT. The points share one exponent, and each
+ * pass is computed unscaled unless the headroom left by the previous pass
+ * is too small for the growth of a butterfly, a + W*b, which is at most
+ * 1 + sqrt(2) per component. The headroom is found by OR-ing the magnitude
+ * bits of each output as it is stored, so no separate pass over the data is
+ * needed; only the input is scanned once before the first pass.
+ *
+ * Each pass shifts its output right by 2 - headroom, which keeps two bits
+ * of headroom before every pass: a pass is unscaled when there are exactly
+ * two, halved or quartered when there are fewer, and shifted left to regain
+ * precision when the data is quieter than that.
+ */
+
+static inline uint32_t _dsp_fft_bfp__magnitude( const int32_t x )
+{
+    return (uint32_t) (x ^ (x >> 31));
+}
+
+static int32_t _dsp_fft_bfp__shift( const uint32_t bits )
+{
+    int32_t headroom;
+    if( bits == 0 ) return 0; // All zero, leave the exponent as it is
+    for( headroom = -1; !(bits & (0x80000000u >> (headroom + 1))); ++headroom );
+    return 2 - headroom;
+}
+
+static int32_t _dsp_fft_bfp( dsp_complex_t pts[], const uint32_t N, const int32_t sine[],
+                             const int32_t inverse )
+{
+    uint32_t bits = 0, shift;
+    int32_t exponent = 0;
+
+    for( uint32_t i = 0; i < N; ++i ) {
+        bits |= _dsp_fft_bfp__magnitude( pts[i].re ) | _dsp_fft_bfp__magnitude( pts[i].im );
+    }
+    for( shift = 0; (2u << shift) < DSP_SINE_POINTS(N); ++shift );
+
+    // Twiddle W = rRe - j*rIm for the forward transform, as dsp_fft_forward()
+    for( uint32_t step = 2; step <= N; step = step * 2, shift-- )
+    {
+        uint32_t step2 = step >> 1, step4 = step2 >> 1;
+        int32_t s = _dsp_fft_bfp__shift( bits );
+        int64_t round = 1LL << (29 + s);
+        bits = 0;
+
+        for( uint32_t k = 0; k < step2; ++k )
+        {
+            int32_t rRe, rIm;
+            if( k <= step4 ) {
+                rRe = sine[(DSP_SINE_POINTS(N) >> 2) - (k << shift)];
+                rIm = sine[k << shift];
+            } else {
+                rRe = -sine[(k - step4) << shift];
+                rIm = sine[(DSP_SINE_POINTS(N) >> 2) - ((k - step4) << shift)];
+            }
+            if( inverse ) rIm = -rIm;
+
+            for( uint32_t block = k; block < N; block += step )
+            {
+                int32_t tRe = pts[block].re, tIm = pts[block].im;
+                int32_t tRe2 = pts[block + step2].re, tIm2 = pts[block + step2].im;
+                int64_t pRe, pIm, aRe, aIm;
+
+                // W*b with 62 fractional bits, halved with a alongside it so
+                // that a + W*b stays within 64 bits
+                if( k == 0 ) {
+                    pRe = (int64_t) tRe2 * (1LL << 30);
+                    pIm = (int64_t) tIm2 * (1LL << 30);
+                } else {
+                    pRe = ((int64_t) tRe2 * rRe + (int64_t) tIm2 * rIm) >> 1;
+                    pIm = ((int64_t) tIm2 * rRe - (int64_t) tRe2 * rIm) >> 1;
+                }
+                aRe = (int64_t) tRe * (1LL << 30) + round;
+                aIm = (int64_t) tIm * (1LL << 30) + round;
+
+                tRe = (int32_t) ((aRe + pRe) >> (30 + s));
+                tIm = (int32_t) ((aIm + pIm) >> (30 + s));
+                tRe2 = (int32_t) ((aRe - pRe) >> (30 + s));
+                tIm2 = (int32_t) ((aIm - pIm) >> (30 + s));
+                pts[block].re = tRe;
+                pts[block].im = tIm;
+                pts[block + step2].re = tRe2;
+                pts[block + step2].im = tIm2;
+                bits |= _dsp_fft_bfp__magnitude( tRe ) | _dsp_fft_bfp__magnitude( tIm )
+                      | _dsp_fft_bfp__magnitude( tRe2 ) | _dsp_fft_bfp__magnitude( tIm2 );
+            }
+        }
+        exponent += s;
+    }
+    return exponent;
+}
+
+int32_t dsp_fft_forward_bfp( dsp_complex_t pts[], const uint32_t N, const int32_t sine[] )
+{
+    return _dsp_fft_bfp( pts, N, sine, 0 );
+}
+
+int32_t dsp_fft_inverse_bfp( dsp_complex_t pts[], const uint32_t N, const int32_t sine[] )
+{
+    return _dsp_fft_bfp( pts, N, sine, 1 );
+}
@@ -0,0 +1,218 @@
+// Copyright (c) 2017, XMOS Ltd, All rights reserved
+#include <stdint.h>
+#include <math.h>
+#include "dsp_fft.h"
+
+// State layout: [0] N, [1] number of factors, [2..] factors, then the
+// twiddle table cos/sin(2*pi*t/N) for t = 0..N-1, then N points of scratch.
+
+#define _DSP_FFT_MIXED_N        0
+#define _DSP_FFT_MIXED_FACTORS  1
+#define _DSP_FFT_MIXED_TWIDDLES (2 + DSP_FFT_MIXED_MAX_FACTORS)
+
+// Q31 value of x, saturated to +/-0x7fffffff so that it can be negated
+
+static int32_t _dsp_fft_mixed__q31( double x )
+{
+    double v = x * 2147483648.0;
+    if( v >= 2147483647.0 ) return 0x7fffffff;
+    if( v <= -2147483647.0 ) return -0x7fffffff;
+    return (int32_t) (v < 0 ? v - 0.5 : v + 0.5);
+}
+
+
+
+int32_t dsp_fft_mixed_init( int32_t state[], const uint32_t N )
+{
+    static const uint32_t radices[4] = { 4, 2, 3, 5 };
+    int32_t* factors = state + _DSP_FFT_MIXED_FACTORS + 1;
+    int32_t* twiddles = state + _DSP_FFT_MIXED_TWIDDLES;
+    uint32_t n = N, count = 0;
+
+    for( uint32_t i = 0; i < 4; ++i ) {
+        while( n > 1 && n % radices[i] == 0 ) {
+            if( count == DSP_FFT_MIXED_MAX_FACTORS ) return 0;
+            factors[count++] = radices[i];
+            n /= radices[i];
+        }
+    }
+    if( n != 1 || N < 2 ) return 0;
+
+    state[_DSP_FFT_MIXED_N] = N;
+    state[_DSP_FFT_MIXED_FACTORS] = count;
+    for( uint32_t t = 0; t < N; ++t ) {
+        double w = 2.0 * 3.14159265358979323846 * t / N;
+        twiddles[2*t+0] = _dsp_fft_mixed__q31( cos( w ) );
+        twiddles[2*t+1] = _dsp_fft_mixed__q31( sin( w ) );
+    }
+    return count;
+}
+
+
+
+// a * (c + j*s), with c and s in Q31, rounded
+
+static inline dsp_complex_t _dsp_fft_mixed__rotate( const dsp_complex_t a, const int32_t c,
+                                                    const int32_t s )
+{
+    const int32_t q = 31, ns = -s;
+    int32_t ah = 0; uint32_t al = 1 << 30;
+    dsp_complex_t b;
+    asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(a.re),"r"(c),"0"(ah),"1"(al));
+    asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(a.im),"r"(ns),"0"(ah),"1"(al));
+    asm("lextract %0,%1,%2,%3,32":"=r"(b.re):"r"(ah),"r"(al),"r"(q));
+    ah = 0; al = 1 << 30;
+    asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(a.re),"r"(s),"0"(ah),"1"(al));
+    asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(a.im),"r"(c),"0"(ah),"1"(al));
+    asm("lextract %0,%1,%2,%3,32":"=r"(b.im):"r"(ah),"r"(al),"r"(q));
+    return b;
+}
+
+// 2 and 4 point DFTs, right shifted by log2(p) when shift is 1. The inverse
+// 4 point DFT is the forward one with outputs 1 and 3 swapped.
+
+static inline void _dsp_fft_mixed__dft2( dsp_complex_t y[], const dsp_complex_t a[],
+                                         const int32_t shift )
+{
+    int32_t r0 = a[0].re >> shift, i0 = a[0].im >> shift;
+    int32_t r1 = a[1].re >> shift, i1 = a[1].im >> shift;
+    y[0].re = r0 + r1; y[0].im = i0 + i1;
+    y[1].re = r0 - r1; y[1].im = i0 - i1;
+}
+
+static inline void _dsp_fft_mixed__dft4( dsp_complex_t y[], const dsp_complex_t a[],
+                                         const int32_t shift, const int32_t inverse )
+{
+    dsp_complex_t t[4];
+    int32_t r1, i1, r3, i3;
+    for( uint32_t j = 0; j < 2; ++j ) {
+        int32_t re = a[j].re >> shift, im = a[j].im >> shift;
+        int32_t re2 = a[j+2].re >> shift, im2 = a[j+2].im >> shift;
+        t[2*j].re = (re + re2) >> shift; t[2*j].im = (im + im2) >> shift;
+        t[2*j+1].re = (re - re2) >> shift; t[2*j+1].im = (im - im2) >> shift;
+    }
+    y[0].re = t[0].re + t[2].re; y[0].im = t[0].im + t[2].im;
+    y[2].re = t[0].re - t[2].re; y[2].im = t[0].im - t[2].im;
+    // t1 -/+ j*t3
+    r1 = t[1].re + t[3].im; i1 = t[1].im - t[3].re;
+    r3 = t[1].re - t[3].im; i3 = t[1].im + t[3].re;
+    y[1].re = inverse ? r3 : r1; y[1].im = inverse ? i3 : i1;
+    y[3].re = inverse ? r1 : r3; y[3].im = inverse ? i1 : i3;
+}
+
+// p point DFT for p = 3 or 5, y[r] = sum_j a[j] * (c[j][r] + j*s[j][r]), with
+// the constants in Q(q_format). The 64-bit sums are saturated to 32 bits.
+
+static inline void _dsp_fft_mixed__dft( dsp_complex_t y[], const dsp_complex_t a[],
+                                        const uint32_t p, int32_t c[5][5], int32_t s[5][5],
+                                        int32_t ns[5][5], const int32_t q_format )
+{
+    for( uint32_t r = 0; r < p; ++r )
+    {
+        int32_t ah = 0; uint32_t al = 1 << (q_format - 1);
+        int32_t bh = 0; uint32_t bl = 1 << (q_format - 1);
+        for( uint32_t j = 0; j < p; ++j ) {
+            asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(a[j].re),"r"(c[j][r]),"0"(ah),"1"(al));
+            asm("maccs %0,%1,%2,%3":"=r"(ah),"=r"(al):"r"(a[j].im),"r"(ns[j][r]),"0"(ah),"1"(al));
+            asm("maccs %0,%1,%2,%3":"=r"(bh),"=r"(bl):"r"(a[j].re),"r"(s[j][r]),"0"(bh),"1"(bl));
+            asm("maccs %0,%1,%2,%3":"=r"(bh),"=r"(bl):"r"(a[j].im),"r"(c[j][r]),"0"(bh),"1"(bl));
+        }
+        asm("lsats %0,%1,%2":"=r"(ah),"=r"(al):"r"(q_format),"0"(ah),"1"(al));
+        asm("lextract %0,%1,%2,%3,32":"=r"(y[r].re):"r"(ah),"r"(al),"r"(q_format));
+        asm("lsats %0,%1,%2":"=r"(bh),"=r"(bl):"r"(q_format),"0"(bh),"1"(bl));
+        asm("lextract %0,%1,%2,%3,32":"=r"(y[r].im):"r"(bh),"r"(bl),"r"(q_format));
+    }
+}
+
+// Self-sorting (Stockham) decimation in frequency. For each radix p, with
+// s the product of the radices already applied and n = N/s:
+//   y[s*(p*q + r) + k] = W_n^(q*r) * sum_j x[s*(q + j*n/p) + k] * W_p^(j*r)
+// Output ends up in natural order without a bit reversal.
+//
+// All arithmetic is on 32-bit points with 64-bit accumulation. The forward
+// transform scales each pass by 1/p: radix 2 and 4 passes shift, and the
+// radix 3 and 5 constants are Q31 values divided by p. The unscaled inverse
+// uses Q30 constants, so that W_p^0 = 1.0 is exact.
+
+static void _dsp_fft_mixed( dsp_complex_t pts[], int32_t state[], const int32_t inverse )
+{
+    uint32_t N = state[_DSP_FFT_MIXED_N];
+    uint32_t count = state[_DSP_FFT_MIXED_FACTORS];
+    const int32_t* factors = state + _DSP_FFT_MIXED_FACTORS + 1;
+    const int32_t* twiddles = state + _DSP_FFT_MIXED_TWIDDLES;
+    dsp_complex_t* scratch = (dsp_complex_t*) (state + _DSP_FFT_MIXED_TWIDDLES + 2*N);
+    dsp_complex_t *x = pts, *y = scratch, *t;
+    uint32_t s = 1, n = N;
+    const int32_t shift = inverse ? 0 : 1, q_format = inverse ? 30 : 31;
+
+    for( uint32_t f = 0; f < count; ++f )
+    {
+        uint32_t p = factors[f], m = n / p;
+        int32_t c[5][5], sn[5][5], ns[5][5];
+
+        if( p == 3 || p == 5 ) {
+            for( uint32_t j = 0; j < p; ++j ) {
+                for( uint32_t r = 0; r < p; ++r ) {
+                    uint32_t e = ((j * r) % p) * (N / p);
+                    int32_t re = e ? twiddles[2*e] : 0x7fffffff;
+                    int32_t im = e ? twiddles[2*e+1] : 0;
+                    if( inverse ) {
+                        re = e ? (re + 1) >> 1 : 0x40000000;
+                        im = (im + 1) >> 1;
+                    } else {
+                        re = e ? re / (int32_t) p : (int32_t) ((0x80000000u + p/2) / p);
+                        im = -im / (int32_t) p;
+                    }
+                    c[j][r] = re; sn[j][r] = im; ns[j][r] = -im;
+                }
+            }
+        }
+
+        for( uint32_t q = 0; q < m; ++q )
+        {
+            for( uint32_t k = 0; k < s; ++k )
+            {
+                dsp_complex_t a[5], b[5];
+                for( uint32_t j = 0; j < p; ++j ) a[j] = x[s * (q + j * m) + k];
+
+                switch( p ) {
+                    case 2: _dsp_fft_mixed__dft2( b, a, shift ); break;
+                    case 4: _dsp_fft_mixed__dft4( b, a, shift, inverse ); break;
+                    default: _dsp_fft_mixed__dft( b, a, p, c, sn, ns, q_format ); break;
+                }
+
+                y[s * p * q + k] = b[0];
+                for( uint32_t r = 1; r < p; ++r )
+                {
+                    if( q != 0 ) {
+                        uint32_t e = q * r * s;
+                        int32_t w_im = twiddles[2*e+1];
+                        b[r] = _dsp_fft_mixed__rotate( b[r], twiddles[2*e], inverse ? w_im : -w_im );
+                    }
+                    y[s * (p * q + r) + k] = b[r];
+                }
+            }
+        }
+        t = x; x = y; y = t;
+        s *= p;
+        n = m;
+    }
+
+    if( x != pts ) {
+        for( uint32_t i = 0; i < N; ++i ) pts[i] = x[i];
+    }
+}
+
+
+
+void dsp_fft_mixed_forward( dsp_complex_t pts[], int32_t state[] )
+{
+    _dsp_fft_mixed( pts, state, 0 );
+}
+
+
+
+void dsp_fft_mixed_inverse( dsp_complex_t pts[], int32_t state[] )
+{
+    _dsp_fft_mixed( pts, state, 1 );
+}
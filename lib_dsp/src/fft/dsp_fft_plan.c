@@ -0,0 +1,100 @@
+// Copyright (c) 2017, XMOS Ltd, All rights reserved
+#include <stdint.h>
+#include "dsp_fft.h"
+
+#if defined(__XS2A__)
+
+/* The twiddle factors of each pass are stored as (cos, sin) pairs in the
+ * order that the pass uses them: N/2 point transforms need 1 + 2 + ... +
+ * N/2 pairs, so N-1 in all. A real plan adds the N/4 pairs of the pass that
+ * separates the spectrum of the real signal. Each pass then reads its
+ * twiddles with a single double word load from consecutive addresses,
+ * instead of indexing the quarter wave sine table twice with a stride.
+ * The twiddles are the values that dsp_fft_forward() reads from the
+ * table, so the results of the plan are the same.
+ */
+
+static void _dsp_fft_plan__twiddles( dsp_complex_t twiddles[], const uint32_t N, const int32_t sine[] )
+{
+    uint32_t shift;
+    for( shift = 0; (2u << shift) < DSP_SINE_POINTS(N); ++shift );
+
+    for( uint32_t step2 = 1; step2 < N; step2 <<= 1, shift-- )
+    {
+        uint32_t step4 = step2 >> 1;
+        for( uint32_t k = 0; k < step2; ++k, ++twiddles )
+        {
+            if( k <= step4 ) {
+                twiddles->re = sine[(DSP_SINE_POINTS(N) >> 2) - (k << shift)];
+                twiddles->im = sine[k << shift];
+            } else {
+                twiddles->re = -sine[(k - step4) << shift];
+                twiddles->im = sine[(DSP_SINE_POINTS(N) >> 2) - ((k - step4) << shift)];
+            }
+        }
+    }
+}
+
+void dsp_fft_plan_init( REFERENCE_PARAM(dsp_fft_plan_t, plan), dsp_complex_t twiddles[],
+                        const uint32_t N, const int32_t sine[] )
+{
+    plan->N = N;
+    plan->twiddles = twiddles;
+    _dsp_fft_plan__twiddles( twiddles, N, sine );
+}
+
+void dsp_fft_plan_init_real( REFERENCE_PARAM(dsp_fft_plan_t, plan), dsp_complex_t twiddles[],
+                             const uint32_t N, const int32_t sine[], const int32_t sin2[] )
+{
+    uint32_t half = N >> 1;
+    dsp_complex_t* fix = twiddles + half - 1;
+
+    dsp_fft_plan_init( plan, twiddles, half, sine );
+    // (sin, cos) of 2*pi*k/N for k = 1 .. N/4, as used by dsp_fft_real_fix_forward()
+    for( uint32_t k = 1; k <= (half >> 1); ++k, ++fix ) {
+        fix->re = sin2[k * DSP_SINE_STRIDE(N)];
+        fix->im = sin2[(DSP_SINE_POINTS(N) >> 2) - k * DSP_SINE_STRIDE(N)];
+    }
+}
+
+// The passes of dsp_fft_forward_xs2() and dsp_fft_inverse_xs2(), and the
+// spectrum separation of dsp_fft_real_fix_forward_xs2() and
+// dsp_fft_real_fix_inverse_xs2(), loading each twiddle from the plan with
+// one double word load. The fix pairs are indexed from 1.
+
+extern void dsp_fft_plan_forward_xs2( dsp_complex_t pts[], const uint32_t N, const dsp_complex_t twiddles[] );
+extern void dsp_fft_plan_inverse_xs2( dsp_complex_t pts[], const uint32_t N, const dsp_complex_t twiddles[] );
+extern void dsp_fft_plan_real_fix_forward_xs2( dsp_complex_t pts[], const uint32_t N, const dsp_complex_t fix[] );
+extern void dsp_fft_plan_real_fix_inverse_xs2( dsp_complex_t pts[], const uint32_t N, const dsp_complex_t fix[] );
+
+void dsp_fft_plan_forward( dsp_complex_t pts[], REFERENCE_PARAM(const dsp_fft_plan_t, plan) )
+{
+    dsp_fft_plan_forward_xs2( pts, plan->N, plan->twiddles );
+}
+
+void dsp_fft_plan_inverse( dsp_complex_t pts[], REFERENCE_PARAM(const dsp_fft_plan_t, plan) )
+{
+    dsp_fft_plan_inverse_xs2( pts, plan->N, plan->twiddles );
+}
+
+void dsp_fft_plan_forward_real( int32_t pts[], REFERENCE_PARAM(const dsp_fft_plan_t, plan) )
+{
+    dsp_complex_t* p = (dsp_complex_t*) pts;
+    uint32_t N = plan->N;
+
+    dsp_fft_bit_reverse( p, N );
+    dsp_fft_plan_forward_xs2( p, N, plan->twiddles );
+    dsp_fft_plan_real_fix_forward_xs2( p, N, plan->twiddles + N - 2 );
+}
+
+void dsp_fft_plan_inverse_real( int32_t pts[], REFERENCE_PARAM(const dsp_fft_plan_t, plan) )
+{
+    dsp_complex_t* p = (dsp_complex_t*) pts;
+    uint32_t N = plan->N;
+
+    dsp_fft_plan_real_fix_inverse_xs2( p, N, plan->twiddles + N - 2 );
+    dsp_fft_bit_reverse( p, N );
+    dsp_fft_plan_inverse_xs2( p, N, plan->twiddles );
+}
+
+#endif
@@ -0,0 +1,120 @@
+// Copyright (c) 2017, XMOS Ltd, All rights reserved
+#include <stdint.h>
+#include "dsp_fft.h"
+
+#if defined(__XS2A__)
+
+// Radix-4 passes from blocks of h transformed points, with a radix-2 pass
+// for an odd number of remaining passes; in dsp_fft_forward_radix4.S and
+// dsp_fft_inverse_radix4.S
+
+extern void dsp_fft_forward_radix4_passes_xs2( dsp_complex_t pts[], uint32_t N,
+                                               const int32_t sine[], uint32_t h );
+
+extern void dsp_fft_inverse_radix4_passes_xs2( dsp_complex_t pts[], uint32_t N,
+                                               const int32_t sine[], uint32_t h );
+
+
+
+void dsp_fft_forward_radix4_xs2( dsp_complex_t pts[], const uint32_t N, const int32_t sine[] )
+{
+    dsp_fft_forward_radix4_passes_xs2( pts, N, sine, 1 );
+}
+
+
+
+void dsp_fft_inverse_radix4_xs2( dsp_complex_t pts[], const uint32_t N, const int32_t sine[] )
+{
+    dsp_fft_inverse_radix4_passes_xs2( pts, N, sine, 1 );
+}
+
+
+
+// Bit reversal fused with the first two radix-2 passes, which need no
+// multiplies. Writing an index as (hi, mid, lo), with 2-bit hi and lo, the
+// 4-point block (hi, mid, *) is the 4-point DFT of the points (*, rev(mid),
+// rev(hi)). The 16 points with a given mid and the 16 with rev(mid) are
+// therefore transformed together and written back in place.
+
+static void _dsp_fft_bit_reverse_and_radix4
+(
+    dsp_complex_t  pts[],
+    const uint32_t N,
+    const int32_t  inverse
+) {
+    static const uint8_t rev2[4] = { 0, 2, 1, 3 };
+    uint32_t quarter = N >> 2, mid_bits = 0;
+    dsp_complex_t tile[2][16];
+
+    while( (16u << mid_bits) < N ) ++mid_bits;
+
+    for( uint32_t mid = 0; mid < (1u << mid_bits); ++mid )
+    {
+        uint32_t rmid = 0, mids[2], n_mids;
+        for( uint32_t b = 0; b < mid_bits; ++b ) rmid |= ((mid >> b) & 1) << (mid_bits - 1 - b);
+        if( rmid < mid ) continue;
+        mids[0] = mid; mids[1] = rmid; n_mids = (rmid == mid) ? 1 : 2;
+
+        for( uint32_t m = 0; m < n_mids; ++m )
+            for( uint32_t k = 0; k < 16; ++k )
+                tile[m][k] = pts[(k >> 2) * quarter + mids[m] * 4 + (k & 3)];
+
+        for( uint32_t m = 0; m < n_mids; ++m )
+        {
+            // Blocks with mid take their inputs from the tile loaded for rev(mid)
+            dsp_complex_t* t = tile[n_mids - 1 - m];
+            for( uint32_t hi = 0; hi < 4; ++hi )
+            {
+                uint32_t l = rev2[hi];
+                int32_t r0 = t[l].re, i0 = t[l].im, r1 = t[4+l].re, i1 = t[4+l].im;
+                int32_t r2 = t[8+l].re, i2 = t[8+l].im, r3 = t[12+l].re, i3 = t[12+l].im;
+                int32_t ar, ai, br, bi, cr, ci, dr, di;
+                dsp_complex_t* p = pts + hi * quarter + mids[m] * 4;
+                if( inverse ) {
+                    ar = r0 + r2; ai = i0 + i2; br = r0 - r2; bi = i0 - i2;
+                    cr = r1 + r3; ci = i1 + i3; dr = i3 - i1; di = r1 - r3; // j*(x1-x3)
+                    p[0].re = ar + cr; p[0].im = ai + ci;
+                    p[1].re = br + dr; p[1].im = bi + di;
+                    p[2].re = ar - cr; p[2].im = ai - ci;
+                    p[3].re = br - dr; p[3].im = bi - di;
+                } else {
+                    r0 >>= 1; i0 >>= 1; r1 >>= 1; i1 >>= 1; r2 >>= 1; i2 >>= 1; r3 >>= 1; i3 >>= 1;
+                    ar = r0 + r2; ai = i0 + i2; br = r0 - r2; bi = i0 - i2;
+                    cr = r1 + r3; ci = i1 + i3; dr = i1 - i3; di = r3 - r1; // -j*(x1-x3)
+                    p[0].re = (ar >> 1) + (cr >> 1); p[0].im = (ai >> 1) + (ci >> 1);
+                    p[1].re = (br >> 1) + (dr >> 1); p[1].im = (bi >> 1) + (di >> 1);
+                    p[2].re = (ar >> 1) - (cr >> 1); p[2].im = (ai >> 1) - (ci >> 1);
+                    p[3].re = (br >> 1) - (dr >> 1); p[3].im = (bi >> 1) - (di >> 1);
+                }
+            }
+        }
+    }
+}
+
+
+
+void dsp_fft_bit_reverse_and_forward( dsp_complex_t pts[], const uint32_t N, const int32_t sine[] )
+{
+    if( N < 16 ) {
+        dsp_fft_bit_reverse( pts, N );
+        dsp_fft_forward_radix4_passes_xs2( pts, N, sine, 1 );
+    } else {
+        _dsp_fft_bit_reverse_and_radix4( pts, N, 0 );
+        dsp_fft_forward_radix4_passes_xs2( pts, N, sine, 4 );
+    }
+}
+
+
+
+void dsp_fft_bit_reverse_and_inverse( dsp_complex_t pts[], const uint32_t N, const int32_t sine[] )
+{
+    if( N < 16 ) {
+        dsp_fft_bit_reverse( pts, N );
+        dsp_fft_inverse_radix4_passes_xs2( pts, N, sine, 1 );
+    } else {
+        _dsp_fft_bit_reverse_and_radix4( pts, N, 1 );
+        dsp_fft_inverse_radix4_passes_xs2( pts, N, sine, 4 );
+    }
+}
+
+#endif
@@ -0,0 +1,96 @@
+// Copyright (c) 2017, XMOS Ltd, All rights reserved
+#include <stdint.h>
+#include "dsp_fft.h"
+
+/* Radix 2 FFT on 16-bit complex points, in place. Twiddle factors are read
+ * from the same 32-bit sine tables as dsp_fft_forward() and rounded to 16
+ * bits, with 1.0 represented exactly as 0x8000, so that each product and
+ * butterfly sum fits a 32-bit accumulator. The sum a + W*b is kept at 14
+ * fractional bits so that it can not overflow, and the result is rounded
+ * and saturated back to 16 bits.
+ */
+
+static inline int16_t _dsp_fft_short__sat( const int32_t x )
+{
+    if( x > 32767 ) return 32767;
+    if( x < -32768 ) return -32768;
+    return (int16_t) x;
+}
+
+static inline int32_t _dsp_fft_short__q15( const int32_t x )
+{
+    return (int32_t) (((int64_t) x + (1 << 15)) >> 16);
+}
+
+void dsp_fft_bit_reverse_short( dsp_complex_short_t pts[], const uint32_t N )
+{
+    uint32_t j = 0;
+    for( uint32_t i = 0; i < N - 1; ++i ) {
+        uint32_t bit;
+        if( i < j ) {
+            dsp_complex_short_t t = pts[i];
+            pts[i] = pts[j];
+            pts[j] = t;
+        }
+        // Increment j in bit reversed order
+        for( bit = N >> 1; j & bit; bit >>= 1 ) j ^= bit;
+        j |= bit;
+    }
+}
+
+static void _dsp_fft_short( dsp_complex_short_t pts[], const uint32_t N, const int32_t sine[],
+                            const int32_t inverse )
+{
+    // The forward transform halves each pass, the inverse does not
+    int32_t shift_out = inverse ? 14 : 15;
+    int32_t round = 1 << (shift_out - 1);
+    uint32_t shift;
+
+    for( shift = 0; (2u << shift) < DSP_SINE_POINTS(N); ++shift );
+
+    for( uint32_t step = 2; step <= N; step = step * 2, shift-- )
+    {
+        uint32_t step2 = step >> 1, step4 = step2 >> 1;
+
+        for( uint32_t k = 0; k < step2; ++k )
+        {
+            // W = rRe - j*rIm for the forward transform
+            int32_t rRe, rIm;
+            if( k <= step4 ) {
+                rRe = _dsp_fft_short__q15( sine[(DSP_SINE_POINTS(N) >> 2) - (k << shift)] );
+                rIm = _dsp_fft_short__q15( sine[k << shift] );
+            } else {
+                rRe = -_dsp_fft_short__q15( sine[(k - step4) << shift] );
+                rIm = _dsp_fft_short__q15( sine[(DSP_SINE_POINTS(N) >> 2) - ((k - step4) << shift)] );
+            }
+            if( inverse ) rIm = -rIm;
+
+            for( uint32_t block = k; block < N; block += step )
+            {
+                int32_t tRe = pts[block].re, tIm = pts[block].im;
+                int32_t tRe2 = pts[block + step2].re, tIm2 = pts[block + step2].im;
+
+                // W*b with 15 fractional bits, halved to line up with a
+                int32_t pRe = (tRe2 * rRe + tIm2 * rIm) >> 1;
+                int32_t pIm = (tIm2 * rRe - tRe2 * rIm) >> 1;
+                int32_t aRe = tRe * (1 << 14) + round;
+                int32_t aIm = tIm * (1 << 14) + round;
+
+                pts[block].re = _dsp_fft_short__sat( (aRe + pRe) >> shift_out );
+                pts[block].im = _dsp_fft_short__sat( (aIm + pIm) >> shift_out );
+                pts[block + step2].re = _dsp_fft_short__sat( (aRe - pRe) >> shift_out );
+                pts[block + step2].im = _dsp_fft_short__sat( (aIm - pIm) >> shift_out );
+            }
+        }
+    }
+}
+
+void dsp_fft_forward_short( dsp_complex_short_t pts[], const uint32_t N, const int32_t sine[] )
+{
+    _dsp_fft_short( pts, N, sine, 0 );
+}
+
+void dsp_fft_inverse_short( dsp_complex_short_t pts[], const uint32_t N, const int32_t sine[] )
+{
+    _dsp_fft_short( pts, N, sine, 1 );
+}
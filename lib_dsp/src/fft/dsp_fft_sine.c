@@ -0,0 +1,55 @@
+// Copyright (c) 2017, XMOS Ltd, All rights reserved
+#include <stdint.h>
+#include "dsp_fft.h"
+
+/* Sine tables generated at run time with a CORDIC in 64-bit integer
+ * arithmetic, so that no floating point code is linked in. The angle of
+ * entry i is i*pi/(2*quarter), with the value of pi of the constant tables
+ * of dsp_tables.c (see src/gen/generatesine.sh), and the rotation is
+ * computed with 56 fractional bits; the result is truncated to 31 bits as
+ * in the constant tables, and the last value is saturated. The tables are
+ * identical to the constant tables.
+ */
+
+// The angles are in radians with 56 fractional bits; x and y have 61
+#define _DSP_FFT_SINE_ITERATIONS 56
+
+// atan(2^-j) for j < 19. From j = 19 on, atan(2^-j) rounds to 2^-j
+static const int64_t _dsp_fft_sine__atan[19] = {
+    56593902016227522LL, 33409331186036030LL, 17652573055549883LL, 8960721713639278LL,
+    4497749271019253LL,  2251067235130761LL,  1125808294293075LL,  562938500594601LL,
+    281473545067998LL,   140737309398767LL,   70368721808055LL,    35184369292630LL,
+    17592185694891LL,    8796092978517LL,     4398046505643LL,     2199023254869LL,
+    1099511627691LL,     549755813877LL,      274877906943LL
+};
+
+// The product of cos(atan(2^-j)) over all iterations, which undoes the gain
+// of the CORDIC
+#define _DSP_FFT_SINE_GAIN    1400229935014726477LL
+
+// 3.1415926535 / 2 with 44 fractional bits
+#define _DSP_FFT_SINE_HALF_PI 27633741218071LL
+
+void dsp_fft_sine_generate( int32_t sine[], const uint32_t N )
+{
+    uint32_t quarter = N >> 2, log2_quarter = 0;
+    while( (1u << log2_quarter) < quarter ) log2_quarter++;
+
+    for( uint32_t i = 0; i < quarter; ++i ) {
+        // i*pi/(2*quarter), where i < quarter <= 4096
+        int64_t z = ((int64_t) i * _DSP_FFT_SINE_HALF_PI) << (12 - log2_quarter);
+        int64_t x = _DSP_FFT_SINE_GAIN, y = 0;
+        for( int32_t j = 0; j < _DSP_FFT_SINE_ITERATIONS; ++j ) {
+            int64_t a = j < 19 ? _dsp_fft_sine__atan[j] : (int64_t) 1 << (56 - j);
+            int64_t dx = y >> j, dy = x >> j;
+            if( z >= 0 ) {
+                x -= dx; y += dy; z -= a;
+            } else {
+                x += dx; y -= dy; z += a;
+            }
+        }
+        // sin(0) may come out a fraction below zero
+        sine[i] = y < 0 ? 0 : (int32_t) (y >> 30);
+    }
+    sine[quarter] = 0x7fffffff;
+}
@@ -0,0 +1,123 @@
+// Copyright (c) 2017, XMOS Ltd, All rights reserved
+#include <stdint.h>
+#include <math.h>
+#include "dsp_fft.h"
+#include "dsp_math_int.h"
+
+/* Magnitude or power spectrum of N windowed real samples, in three steps
+ * instead of five: the window is applied to each pair of samples as it is
+ * moved to its bit reversed position, the N/2 point complex FFT is computed
+ * in place, and dsp_fft_real_fix_spectrum_xs2(), the spectrum separation of
+ * dsp_fft_real_fix_forward_xs2(), computes the power of each pair of bins k
+ * and N/2-k instead of storing the bins back.
+ */
+
+static const double pi = 3.14159265358979323846;
+
+static int32_t _dsp_fft_spectrum__q31( double x )
+{
+    double v = x * 2147483648.0;
+    if( v >= 2147483647.0 ) return 0x7fffffff;
+    return (int32_t) (v + 0.5);
+}
+
+void dsp_fft_window_hann( int32_t window[], const uint32_t N )
+{
+    for( uint32_t n = 0; n < N/2; ++n ) {
+        window[n] = _dsp_fft_spectrum__q31( 0.5 - 0.5 * cos( 2.0 * pi * (n + 0.5) / N ) );
+    }
+}
+
+void dsp_fft_window_blackman( int32_t window[], const uint32_t N )
+{
+    for( uint32_t n = 0; n < N/2; ++n ) {
+        double a = 2.0 * pi * (n + 0.5) / N;
+        window[n] = _dsp_fft_spectrum__q31( 0.42 - 0.5 * cos( a ) + 0.08 * cos( 2.0 * a ) );
+    }
+}
+
+static inline int32_t _dsp_fft_spectrum__window( const int32_t x, const int32_t w )
+{
+    return (int32_t) ((x * (int64_t) w + (1 << 30)) >> 31);
+}
+
+// Point i of the N/2 point FFT holds samples 2i and 2i+1, windowed by the
+// rising half of the window for the first N/2 samples and its mirror image
+
+static inline void _dsp_fft_spectrum__load( dsp_complex_t* p, const uint32_t i,
+                                            const int32_t window[], const uint32_t N )
+{
+    uint32_t n = 2*i;
+    if( n < N/2 ) {
+        p->re = _dsp_fft_spectrum__window( p->re, window[n] );
+        p->im = _dsp_fft_spectrum__window( p->im, window[n + 1] );
+    } else {
+        p->re = _dsp_fft_spectrum__window( p->re, window[N - 1 - n] );
+        p->im = _dsp_fft_spectrum__window( p->im, window[N - 2 - n] );
+    }
+}
+
+static void _dsp_fft_spectrum__window_and_bit_reverse( dsp_complex_t pts[],
+                                                       const int32_t window[],
+                                                       const uint32_t N )
+{
+    uint32_t half = N >> 1, shift = 32;
+    for( uint32_t m = half; m > 1; m >>= 1 ) shift--;
+
+    for( uint32_t i = 0; i < half; ++i ) {
+        uint32_t j;
+        asm("bitrev %0, %1" : "=r" (j) : "r" (i));
+        j >>= shift;
+        if( j < i ) continue;
+        _dsp_fft_spectrum__load( &pts[i], i, window, N );
+        if( j != i ) {
+            dsp_complex_t t;
+            _dsp_fft_spectrum__load( &pts[j], j, window, N );
+            t = pts[i]; pts[i] = pts[j]; pts[j] = t;
+        }
+    }
+}
+
+static inline uint32_t _dsp_fft_spectrum__bin( const int32_t re, const int32_t im,
+                                               const dsp_fft_spectrum_t output )
+{
+    uint64_t p = (uint64_t) (re * (int64_t) re) + (uint64_t) (im * (int64_t) im);
+    if( output == DSP_FFT_SPECTRUM_MAGNITUDE ) {
+        return dsp_math_int_sqrt64( p );
+    }
+    p >>= 31;
+    return p > 0xffffffff ? 0xffffffff : (uint32_t) p;
+}
+
+extern void dsp_fft_real_fix_spectrum_xs2( dsp_complex_t pts[], const uint32_t N,
+                                           const int32_t sine[], uint32_t spectrum[] );
+
+void dsp_fft_real_spectrum( uint32_t spectrum[], int32_t pts[], const int32_t window[],
+                            const uint32_t N, const int32_t sine[], const int32_t sin2[],
+                            const dsp_fft_spectrum_t output )
+{
+    dsp_complex_t* p = (dsp_complex_t*) pts;
+    uint32_t half = N >> 1;
+
+    _dsp_fft_spectrum__window_and_bit_reverse( p, window, N );
+    dsp_fft_forward( p, half, sine );
+
+    // DC and Nyquist are both real, and packed into the first point
+    spectrum[0] = _dsp_fft_spectrum__bin( (p[0].re + p[0].im) >> 1, 0, output );
+    spectrum[half] = _dsp_fft_spectrum__bin( (p[0].re - p[0].im) >> 1, 0, output );
+
+    // The powers are written straight to the spectrum; for magnitudes the
+    // 64-bit powers are left in the points, and square rooted here
+    if( output == DSP_FFT_SPECTRUM_POWER ) {
+        dsp_fft_real_fix_spectrum_xs2( p, half, sin2, spectrum );
+    } else {
+        dsp_fft_real_fix_spectrum_xs2( p, half, sin2, 0 );
+        for( uint32_t k = 1; k < half; ++k ) {
+            if( k == half/2 ) continue;
+            spectrum[k] = dsp_math_int_sqrt64( (uint32_t) p[k].re | (uint64_t) (uint32_t) p[k].im << 32 );
+        }
+    }
+
+    // The middle bin is its own mirror image, and is halved and conjugated
+    spectrum[half/2] = _dsp_fft_spectrum__bin( p[half/2].re >> 1, p[half/2].im >> 1, output );
+}
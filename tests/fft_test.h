@@ -0,0 +1,54 @@
+// Copyright (c) 2017, XMOS Ltd, All rights reserved
+
+// Common code of the FFT tests. do_fft_test() in test_fft.py copies this
+// file next to generated.h, which must be included first.
+
+#ifndef FFT_TEST_H_
+#define FFT_TEST_H_
+
+// The generator of the test inputs, as in gen_test.py
+int random(unsigned &x){
+    crc32(x, -1, 0xEB31D82E);
+    return (int)x;
+}
+
+int check(int a, int b, int tolerance){
+    int e = a - b;
+    if (e<0) e=-e;
+    return e <= tolerance;
+}
+
+// Fills f with the next FFT_LENGTH points of the input
+void fft_test_input(dsp_complex_t f[], unsigned &x){
+    for(unsigned i=0;i<FFT_LENGTH;i++){
+        f[i].re = random(x)>>DATA_SHIFT;
+        f[i].im = random(x)>>DATA_SHIFT;
+    }
+}
+
+// Returns 1 if f matches the spectrum of input t within tolerance
+int fft_test_check_output(const dsp_complex_t f[], unsigned t, int tolerance){
+    for(unsigned i=0;i<FFT_LENGTH;i++){
+        if(!check(f[i].re, output[t][i].re, tolerance) ||
+           !check(f[i].im, output[t][i].im, tolerance)){
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Returns 1 if f matches the next FFT_LENGTH points of the input within
+// tolerance
+int fft_test_check_input(const dsp_complex_t f[], unsigned &x, int tolerance){
+    int pass = 1;
+    for(unsigned i=0;i<FFT_LENGTH;i++){
+        int re = random(x)>>DATA_SHIFT;
+        int im = random(x)>>DATA_SHIFT;
+        if(!check(f[i].re, re, tolerance) || !check(f[i].im, im, tolerance)){
+            pass = 0;
+        }
+    }
+    return pass;
+}
+
+#endif
@@ -0,0 +1,106 @@
+#!/usr/bin/env python
+# Copyright (c) 2017, XMOS Ltd, All rights reserved
+#
+# Runs the benchmark in test_benchmark on the simulator and collects the
+# BENCH lines it prints into a CSV or JSON file. Given the results of a
+# previous release as a baseline, configurations whose median time has
+# grown by more than the threshold are listed, and the exit status is 1.
+#
+#   ./measure_benchmark.py --output results.csv
+#   ./measure_benchmark.py --output results.json --baseline previous.csv
+#   ./measure_benchmark.py --input captured.txt --baseline previous.csv
+
+from __future__ import print_function
+import argparse
+import csv
+import json
+import os.path
+import subprocess
+import sys
+
+FIELDS = ['kernel', 'size', 'q_format', 'unit', 'min', 'median', 'max']
+KEY = ['kernel', 'size', 'q_format']
+
+def run_benchmark(test_dir):
+    subprocess.check_call(['xmake'], cwd=test_dir)
+    binary = os.path.join(test_dir, 'bin', 'test.xe')
+    return subprocess.check_output(['xsim', binary]).decode().splitlines()
+
+def parse(lines):
+    results = []
+    for line in lines:
+        fields = line.strip().split(',')
+        if fields[0] != 'BENCH' or fields[1] == 'kernel':
+            continue
+        r = dict(zip(FIELDS, fields[1:]))
+        for f in ['size', 'q_format']:
+            r[f] = int(r[f])
+        for f in ['min', 'median', 'max']:
+            r[f] = float(r[f])
+        results.append(r)
+    return results
+
+def read(filename):
+    if filename.endswith('.json'):
+        with open(filename) as f:
+            return json.load(f)
+    with open(filename) as f:
+        return parse('BENCH,' + line for line in f)
+
+def write_csv(f, results):
+    w = csv.writer(f, lineterminator='\n')
+    w.writerow(FIELDS)
+    for r in results:
+        w.writerow([r[field] for field in FIELDS])
+
+def write(filename, results):
+    with open(filename, 'w') as f:
+        if filename.endswith('.json'):
+            json.dump(results, f, indent=1, sort_keys=True)
+        else:
+            write_csv(f, results)
+
+def compare(results, baseline, threshold):
+    previous = dict((tuple(r[k] for k in KEY), r) for r in baseline)
+    regressions = 0
+    for r in results:
+        p = previous.get(tuple(r[k] for k in KEY))
+        if p is None or p['median'] <= 0:
+            continue
+        change = 100.0 * (r['median'] - p['median']) / p['median']
+        if change > threshold:
+            regressions += 1
+            print('%s size %d q%d: %.2f -> %.2f cycles per %s (+%.1f%%)' %
+                  (r['kernel'], r['size'], r['q_format'], p['median'],
+                   r['median'], r['unit'], change))
+    return regressions
+
+def main():
+    parser = argparse.ArgumentParser(description='lib_dsp benchmark')
+    parser.add_argument('--input', help='captured output of the benchmark, instead of running it')
+    parser.add_argument('--output', help='CSV or JSON file to write the results to')
+    parser.add_argument('--baseline', help='CSV or JSON results to compare against')
+    parser.add_argument('--threshold', type=float, default=5.0,
+                        help='percentage increase of the median reported as a regression')
+    args = parser.parse_args()
+
+    if args.input:
+        with open(args.input) as f:
+            results = parse(f)
+    else:
+        test_dir = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'test_benchmark')
+        results = parse(run_benchmark(test_dir))
+
+    if args.output:
+        write(args.output, results)
+    else:
+        write_csv(sys.stdout, results)
+
+    if args.baseline:
+        regressions = compare(results, read(args.baseline), args.threshold)
+        print('%d regressions in %d configurations' % (regressions, len(results)))
+        return 1 if regressions else 0
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,717 @@
+// Copyright (c) 2017, XMOS Ltd, All rights reserved
+// XMOS DSP Library - Benchmark of the library kernels
+//
+// Each kernel is timed over a sweep of sizes, tap counts and q_formats.
+// Every configuration is run REPS times, and the minimum, median and
+// maximum time per sample (or per point, element, or coefficient) are
+// printed as one comma separated line starting with "BENCH,":
+//
+//   BENCH,<kernel>,<size>,<q_format>,<unit>,<min>,<median>,<max>
+//
+// Times are in ticks of the 100 MHz reference clock. On a 500 MHz tile
+// with at most five active threads one tick is one thread cycle. The
+// lines are collected by measure_benchmark.py.
+//
+// Every function that processes data is timed. Not timed are the functions
+// that set up state or tables once (the _init functions, the window and
+// sine table generators and dsp_matrix_mulm_pack), the FIFO and the
+// instrumentation.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <dsp.h>
+
+#define REPS 9
+
+#define MAX_POINTS 4096
+#define MAX_TAPS   512
+#define MAX_DIM    32
+#define MAX_BINS   32
+#define DFT_POINTS 1024
+#define BLOCK_TAPS 1024
+#define MAX_BLOCK  256
+
+// Global, to enforce 64 bit alignment
+dsp_complex_t data[MAX_POINTS];
+dsp_complex_t scratch[MAX_POINTS / 2];
+int32_t input[MAX_POINTS];
+int32_t output[MAX_POINTS];
+int32_t coeffs[MAX_TAPS * 2];
+int32_t state[DSP_FILTERS_FIR_BLOCK_STATE_LENGTH(MAX_TAPS)];
+// Sparse and polyphase coefficients; the sparse interpolator by 4 is the largest
+int32_t sparse[DSP_FILTERS_INTERPOLATE_SPARSE_COEFFS_LENGTH(MAX_TAPS, 4)];
+int32_t matrix_x[MAX_DIM * MAX_DIM];
+int32_t matrix_y[MAX_DIM * MAX_DIM];
+int32_t matrix_r[MAX_DIM * MAX_DIM];
+int32_t matrix_p[DSP_MATRIX_MULM_PACKED_LENGTH(MAX_DIM, MAX_DIM)];
+int8_t  weights[MAX_DIM * MAX_DIM];
+int16_t weights16[MAX_DIM * MAX_DIM];
+// Twiddles of the FFT plans, up to the real plan of MAX_POINTS samples
+dsp_complex_t twiddles[DSP_FFT_PLAN_REAL_TWIDDLES_LENGTH(MAX_POINTS)];
+int32_t goertzel[DSP_GOERTZEL_SLIDING_STATE_LENGTH(DFT_POINTS, MAX_BINS)];
+// State of the FFT convolution, FDAF, mixed radix FFT and STFT; the FDAF of
+// BLOCK_TAPS taps in blocks of MAX_BLOCK samples is the largest
+int32_t block_state[DSP_ADAPTIVE_FDAF_STATE_LENGTH(BLOCK_TAPS, MAX_BLOCK)];
+
+static unsigned random_state = 0x12345678;
+
+static int32_t random_number(void)
+{
+    random_state = random_state * 1664525 + 1013904223;
+    return (int32_t) random_state;
+}
+
+static unsigned get_time(void)
+{
+    unsigned t;
+    asm volatile("gettime %0":"=r"(t));
+    return t;
+}
+
+static const int32_t* sine_table(const uint32_t N)
+{
+    switch( N ) {
+    case 4:     return dsp_sine_4;
+    case 8:     return dsp_sine_8;
+    case 16:    return dsp_sine_16;
+    case 32:    return dsp_sine_32;
+    case 64:    return dsp_sine_64;
+    case 128:   return dsp_sine_128;
+    case 256:   return dsp_sine_256;
+    case 512:   return dsp_sine_512;
+    case 1024:  return dsp_sine_1024;
+    case 2048:  return dsp_sine_2048;
+    case 4096:  return dsp_sine_4096;
+    case 8192:  return dsp_sine_8192;
+    default:    return dsp_sine_16384;
+    }
+}
+
+static void fill(int32_t x[], const uint32_t n, const int32_t shift)
+{
+    for( uint32_t i = 0; i < n; ++i ) x[i] = random_number() >> shift;
+}
+
+static void fill_complex(const uint32_t N, const int32_t shift)
+{
+    for( uint32_t i = 0; i < N; ++i ) {
+        data[i].re = random_number() >> shift;
+        data[i].im = random_number() >> shift;
+    }
+}
+
+static void report(const char* kernel, const int32_t size, const int32_t q_format,
+                   const char* unit, const int32_t units, unsigned ticks[REPS])
+{
+    // Insertion sort; REPS is small
+    for( int32_t i = 1; i < REPS; ++i ) {
+        unsigned t = ticks[i];
+        int32_t j;
+        for( j = i; j > 0 && ticks[j - 1] > t; --j ) ticks[j] = ticks[j - 1];
+        ticks[j] = t;
+    }
+    printf("BENCH,%s,%d,%d,%s,%.2f,%.2f,%.2f\n", kernel, size, q_format, unit,
+           ticks[0] / (float) units, ticks[REPS / 2] / (float) units,
+           ticks[REPS - 1] / (float) units);
+}
+
+static unsigned overhead;
+
+// Times REPS calls of call, running setup before each outside the timing
+#define BENCH(kernel, size, q_format, unit, units, setup, call) \
+    do {                                                        \
+        unsigned ticks[REPS];                                   \
+        for( int32_t rep = 0; rep < REPS; ++rep ) {             \
+            setup;                                              \
+            unsigned t0 = get_time();                           \
+            call;                                               \
+            ticks[rep] = get_time() - t0 - overhead;            \
+        }                                                       \
+        report(kernel, size, q_format, unit, units, ticks);     \
+    } while(0)
+
+// The radix-4 kernels behind dsp_fft_forward/inverse with DSP_FFT_RADIX4=1
+extern void dsp_fft_forward_radix4_xs2(dsp_complex_t pts[], uint32_t N, const int32_t sine[]);
+extern void dsp_fft_inverse_radix4_xs2(dsp_complex_t pts[], uint32_t N, const int32_t sine[]);
+
+static void bench_fft(void)
+{
+    for( uint32_t N = 16; N <= MAX_POINTS; N *= 2 ) {
+        const int32_t* sine = sine_table(N);
+        BENCH("fft_bit_reverse", N, 31, "point", N, fill_complex(N, 1),
+              dsp_fft_bit_reverse(data, N));
+        BENCH("fft_forward", N, 31, "point", N, fill_complex(N, 1),
+              dsp_fft_forward(data, N, sine));
+        BENCH("fft_inverse", N, 31, "point", N, fill_complex(N, 1 + 13),
+              dsp_fft_inverse(data, N, sine));
+        BENCH("fft_forward_radix4", N, 31, "point", N, fill_complex(N, 1),
+              dsp_fft_forward_radix4_xs2(data, N, sine));
+        BENCH("fft_inverse_radix4", N, 31, "point", N, fill_complex(N, 1 + 13),
+              dsp_fft_inverse_radix4_xs2(data, N, sine));
+        BENCH("fft_bit_reverse_and_forward", N, 31, "point", N, fill_complex(N, 1),
+              dsp_fft_bit_reverse_and_forward(data, N, sine));
+        BENCH("fft_bit_reverse_and_inverse", N, 31, "point", N, fill_complex(N, 1 + 13),
+              dsp_fft_bit_reverse_and_inverse(data, N, sine));
+        if( N <= MAX_POINTS / 2 ) {
+            // The same passes as fft_forward, with the twiddles read from the plan
+            dsp_fft_plan_t plan;
+            dsp_fft_plan_init(&plan, twiddles, N, sine);
+            BENCH("fft_plan_forward", N, 31, "point", N, fill_complex(N, 1),
+                  dsp_fft_plan_forward(data, &plan));
+            BENCH("fft_plan_inverse", N, 31, "point", N, fill_complex(N, 1 + 13),
+                  dsp_fft_plan_inverse(data, &plan));
+            dsp_fft_plan_init_real(&plan, twiddles, 2 * N, sine, sine_table(2 * N));
+            BENCH("fft_plan_forward_real", 2 * N, 31, "sample", 2 * N, fill_complex(N, 1),
+                  dsp_fft_plan_forward_real((int32_t*) data, &plan));
+            BENCH("fft_plan_inverse_real", 2 * N, 31, "sample", 2 * N, fill_complex(N, 1 + 14),
+                  dsp_fft_plan_inverse_real((int32_t*) data, &plan));
+        }
+        // Wall clock time on four logical cores
+        BENCH("fft_forward_parallel", N, 31, "point", N, fill_complex(N, 1),
+              dsp_fft_forward_parallel(data, N, sine, sine_table(N / 4), 4));
+        BENCH("fft_inverse_parallel", N, 31, "point", N, fill_complex(N, 1 + 13),
+              dsp_fft_inverse_parallel(data, N, sine, sine_table(N / 4), 4));
+        if( N <= MAX_POINTS / 4 ) {
+            BENCH("fft_forward_batch", N, 31, "point", 4 * N, fill_complex(4 * N, 1),
+                  dsp_fft_forward_batch(data, 4, N, sine));
+            BENCH("fft_inverse_batch", N, 31, "point", 4 * N, fill_complex(4 * N, 1 + 13),
+                  dsp_fft_inverse_batch(data, 4, N, sine));
+            BENCH("fft_forward_tworeals_batch", N, 31, "sample", 8 * N, fill_complex(4 * N, 1),
+                  dsp_fft_forward_tworeals_batch(data, 8, N, sine));
+            BENCH("fft_inverse_tworeals_batch", N, 31, "sample", 8 * N, fill_complex(4 * N, 1 + 13),
+                  dsp_fft_inverse_tworeals_batch(data, 8, N, sine));
+        }
+        BENCH("fft_split_spectrum", N, 31, "point", N, fill_complex(N, 1),
+              dsp_fft_split_spectrum(data, N));
+        BENCH("fft_merge_spectra", N, 31, "point", N, fill_complex(N, 1),
+              dsp_fft_merge_spectra(data, N));
+        BENCH("fft_forward_bfp", N, 31, "point", N, fill_complex(N, 1),
+              dsp_fft_forward_bfp(data, N, sine));
+        BENCH("fft_inverse_bfp", N, 31, "point", N, fill_complex(N, 1),
+              dsp_fft_inverse_bfp(data, N, sine));
+        BENCH("fft_bit_reverse_short", N, 15, "point", N, fill_complex(N / 2, 1),
+              dsp_fft_bit_reverse_short((dsp_complex_short_t*) data, N));
+        BENCH("fft_forward_short", N, 15, "point", N, fill_complex(N / 2, 1),
+              dsp_fft_forward_short((dsp_complex_short_t*) data, N, sine));
+        BENCH("fft_inverse_short", N, 15, "point", N, fill_complex(N / 2, 1 + 13),
+              dsp_fft_inverse_short((dsp_complex_short_t*) data, N, sine));
+        if( N <= MAX_POINTS / 2 ) {
+            BENCH("fft_long_to_short", N, 15, "point", N, fill_complex(N, 1),
+                  dsp_fft_long_to_short(data, (dsp_complex_short_t*) &data[N], N));
+            BENCH("fft_short_to_long", N, 15, "point", N, fill_complex(N / 2, 1),
+                  dsp_fft_short_to_long((dsp_complex_short_t*) data, &data[N], N));
+        }
+        BENCH("fft_forward_real", 2 * N, 31, "sample", 2 * N, fill_complex(N, 1),
+              dsp_fft_bit_reverse_and_forward_real((int32_t*) data, 2 * N, sine,
+                                                   sine_table(2 * N)));
+        BENCH("fft_inverse_real", 2 * N, 31, "sample", 2 * N, fill_complex(N, 1 + 14),
+              dsp_fft_bit_reverse_and_inverse_real((int32_t*) data, 2 * N, sine,
+                                                   sine_table(2 * N)));
+        if( N < MAX_POINTS ) {
+            dsp_fft_window_hann(input, 2 * N);
+            BENCH("fft_real_spectrum", 2 * N, 31, "sample", 2 * N, fill_complex(N, 1),
+                  dsp_fft_real_spectrum((uint32_t*) output, (int32_t*) data, input, 2 * N, sine,
+                                        sine_table(2 * N), DSP_FFT_SPECTRUM_POWER));
+        }
+    }
+}
+
+static void bench_fft_mixed(void)
+{
+    for( uint32_t N = 30; N <= 960; N *= 2 ) {
+        dsp_fft_mixed_init(block_state, N);
+        BENCH("fft_mixed_forward", N, 31, "point", N, fill_complex(N, 1),
+              dsp_fft_mixed_forward(data, block_state));
+        BENCH("fft_mixed_inverse", N, 31, "point", N, fill_complex(N, 1 + 10),
+              dsp_fft_mixed_inverse(data, block_state));
+    }
+}
+
+static void bench_dct(void)
+{
+    BENCH("dct_forward48", 48, 31, "point", 48, fill(input, 48, 8), dsp_dct_forward48(output, input));
+    BENCH("dct_forward32", 32, 31, "point", 32, fill(input, 32, 8), dsp_dct_forward32(output, input));
+    BENCH("dct_forward24", 24, 31, "point", 24, fill(input, 24, 8), dsp_dct_forward24(output, input));
+    BENCH("dct_forward16", 16, 31, "point", 16, fill(input, 16, 8), dsp_dct_forward16(output, input));
+    BENCH("dct_forward12", 12, 31, "point", 12, fill(input, 12, 8), dsp_dct_forward12(output, input));
+    BENCH("dct_forward8", 8, 31, "point", 8, fill(input, 8, 8), dsp_dct_forward8(output, input));
+    BENCH("dct_forward6", 6, 31, "point", 6, fill(input, 6, 8), dsp_dct_forward6(output, input));
+    BENCH("dct_forward4", 4, 31, "point", 4, fill(input, 4, 8), dsp_dct_forward4(output, input));
+    BENCH("dct_forward3", 3, 31, "point", 3, fill(input, 3, 8), dsp_dct_forward3(output, input));
+    BENCH("dct_forward2", 2, 31, "point", 2, fill(input, 2, 8), dsp_dct_forward2(output, input));
+    BENCH("dct_forward1", 1, 31, "point", 1, fill(input, 1, 8), dsp_dct_forward1(output, input));
+    BENCH("dct_inverse4", 4, 31, "point", 4, fill(input, 4, 8), dsp_dct_inverse4(output, input));
+    BENCH("dct_inverse3", 3, 31, "point", 3, fill(input, 3, 8), dsp_dct_inverse3(output, input));
+    BENCH("dct_inverse2", 2, 31, "point", 2, fill(input, 2, 8), dsp_dct_inverse2(output, input));
+    BENCH("dct_inverse1", 1, 31, "point", 1, fill(input, 1, 8), dsp_dct_inverse1(output, input));
+    for( uint32_t N = 8; N <= 2048; N *= 2 ) {
+        const int32_t* sine = sine_table(N / 2);
+        const int32_t* dct_sine = sine_table(8 * N);
+        BENCH("dct_forward", N, 31, "point", N, fill(input, N, 0),
+              dsp_dct_forward(output, input, scratch, N, sine, dct_sine));
+        BENCH("dct_inverse", N, 31, "point", N, fill(input, N, 14),
+              dsp_dct_inverse(output, input, scratch, N, sine, dct_sine));
+        BENCH("dct_iv_forward", N, 31, "point", N, fill(input, N, 0),
+              dsp_dct_iv_forward(output, input, scratch, N, sine, dct_sine));
+        BENCH("dct_iv_inverse", N, 31, "point", N, fill(input, N, 14),
+              dsp_dct_iv_inverse(output, input, scratch, N, sine, dct_sine));
+        if( N <= 1024 ) {
+            dsp_mdct_window_sine(coeffs, N);
+            for( uint32_t i = 0; i < N; ++i ) state[i] = 0;
+            BENCH("mdct_forward", N, 31, "coefficient", N, fill(input, N, 1),
+                  dsp_mdct_forward(output, input, state, scratch, N, coeffs, sine, dct_sine));
+            for( uint32_t i = 0; i < N; ++i ) state[i] = 0;
+            BENCH("mdct_inverse", N, 31, "sample", N, fill(input, N, 8),
+                  dsp_mdct_inverse(output, input, state, scratch, N, coeffs, sine, dct_sine));
+        }
+    }
+}
+
+static void bench_stft(void)
+{
+    int32_t* frame = (int32_t*) data;
+    for( uint32_t N = 256; N <= 1024; N *= 2 ) {
+        const uint32_t hop = N / 2;
+        dsp_stft_window_sqrt_hann(coeffs, N, hop);
+        dsp_stft_analysis_init(block_state, N, hop);
+        BENCH("stft_analysis_frame", N, 31, "sample", hop,
+              fill(input, hop, 1); dsp_stft_analysis_push(block_state, input, hop),
+              dsp_stft_analysis_frame(frame, block_state, coeffs, sine_table(N / 2), sine_table(N)));
+        dsp_stft_synthesis_init(block_state, N, hop);
+        BENCH("stft_synthesis_frame", N, 31, "sample", hop,
+              fill(frame, N, 12); dsp_stft_synthesis_pull(output, block_state, hop),
+              dsp_stft_synthesis_frame(frame, block_state, coeffs, sine_table(N / 2), sine_table(N)));
+    }
+}
+
+static void bench_bfp(void)
+{
+    for( uint32_t N = 16; N <= MAX_POINTS; N *= 4 ) {
+        BENCH("bfp_cls", N, 31, "point", N, fill_complex(N, 4),
+              dsp_bfp_cls(data, N));
+        BENCH("bfp_shl", N, 31, "point", N, fill_complex(N, 4),
+              dsp_bfp_shl(data, N, 3));
+        BENCH("bfp_shl2", N, 31, "point", N, fill_complex(N, 4),
+              dsp_bfp_shl2(data, N, 3, 2));
+        BENCH("bfp_bit_reverse_shl", N, 31, "point", N, fill_complex(N, 4),
+              dsp_bfp_bit_reverse_shl(data, N, 3));
+    }
+}
+
+static void bench_filters(void)
+{
+    for( int32_t q = 28; q <= 31; q += 3 ) {
+        for( int32_t taps = 8; taps <= MAX_TAPS; taps *= 4 ) {
+            fill(coeffs, taps, 6);
+            fill(state, taps, 2);
+            BENCH("filters_fir", taps, q, "sample", 1, ,
+                  dsp_filters_fir(random_state, coeffs, state, taps, q));
+            BENCH("filters_fir_add_sample", taps, q, "sample", 1, ,
+                  dsp_filters_fir_add_sample(random_state, state, taps));
+            BENCH("filters_decimate", taps, q, "sample", 4, fill(input, 4, 2),
+                  dsp_filters_decimate(input, coeffs, state, taps, 4, q));
+            BENCH("filters_interpolate", taps, q, "sample", 4, ,
+                  dsp_filters_interpolate(random_state >> 2, coeffs, state, taps, 4, output, q));
+            for( int32_t i = 0; i < DSP_FILTERS_FIR_BLOCK_STATE_LENGTH(taps); ++i ) state[i] = 0;
+            BENCH("filters_fir_block", taps, q, "sample", 64, fill(input, 64, 2),
+                  dsp_filters_fir_block(input, output, 64, coeffs, state, taps, q));
+            for( int32_t i = 0; i < DSP_FILTERS_FIR_BLOCK_STATE_LENGTH(taps); ++i ) state[i] = 0;
+            BENCH("filters_fir_symmetric_block", taps, q, "sample", 64, fill(input, 64, 3),
+                  dsp_filters_fir_symmetric_block(input, output, 64, coeffs, state, taps, q));
+            for( int32_t i = 0; i < DSP_FILTERS_FIR_BLOCK_STATE_LENGTH(taps); ++i ) state[i] = 0;
+            BENCH("filters_decimate_symmetric", taps, q, "sample", 4, fill(input, 4, 3),
+                  dsp_filters_decimate_symmetric(input, coeffs, state, taps, 4, q));
+            dsp_filters_interpolate_symmetric_init(coeffs, taps, 4, sparse);
+            for( int32_t i = 0; i < DSP_FILTERS_INTERPOLATE_STATE_LENGTH(taps, 4); ++i ) state[i] = 0;
+            BENCH("filters_interpolate_symmetric", taps, q, "sample", 4, ,
+                  dsp_filters_interpolate_symmetric(random_state >> 3, sparse, state, taps, 4,
+                                                    output, q));
+            // A copy of the taps with the middle half zero, so the
+            // coefficients of the other kernels are left as they are
+            int32_t* sparse_taps = &coeffs[MAX_TAPS];
+            for( int32_t i = 0; i < taps; ++i ) {
+                sparse_taps[i] = (i >= taps / 4 && i < taps - taps / 4) ? 0 : coeffs[i];
+            }
+            dsp_filters_fir_sparse_init(sparse_taps, taps, 4, sparse);
+            for( int32_t i = 0; i < DSP_FILTERS_FIR_BLOCK_STATE_LENGTH(taps); ++i ) state[i] = 0;
+            BENCH("filters_fir_sparse_block", taps, q, "sample", 64, fill(input, 64, 2),
+                  dsp_filters_fir_sparse_block(input, output, 64, sparse, state, taps, q));
+            for( int32_t i = 0; i < DSP_FILTERS_FIR_BLOCK_STATE_LENGTH(taps); ++i ) state[i] = 0;
+            BENCH("filters_decimate_sparse", taps, q, "sample", 4, fill(input, 4, 2),
+                  dsp_filters_decimate_sparse(input, sparse, state, taps, 4, q));
+            dsp_filters_interpolate_sparse_init(sparse_taps, taps, 4, 4, sparse);
+            for( int32_t i = 0; i < DSP_FILTERS_INTERPOLATE_STATE_LENGTH(taps, 4); ++i ) state[i] = 0;
+            BENCH("filters_interpolate_sparse", taps, q, "sample", 4, ,
+                  dsp_filters_interpolate_sparse(random_state >> 2, sparse, state, taps, 4,
+                                                 output, q));
+        }
+        for( int32_t sections = 1; sections <= 8; sections *= 2 ) {
+            // Pass through sections keep the state bounded
+            for( int32_t s = 0; s < sections; ++s ) {
+                int32_t* c = coeffs + s * DSP_NUM_COEFFS_PER_BIQUAD;
+                c[0] = 1 << (q - 1);
+                c[1] = c[2] = c[3] = c[4] = 0;
+            }
+            if( sections == 1 ) {
+                fill(state, 2 * DSP_NUM_STATES_PER_BIQUAD, 2);
+                BENCH("filters_biquad", 1, q - 1, "sample", 1, ,
+                      dsp_filters_biquad(random_state >> 2, coeffs, state, q - 1));
+                BENCH("filters_biquad_stereo", 1, q - 1, "sample", 2,
+                      output[0] = random_state >> 2; output[1] = random_state >> 3,
+                      dsp_filters_biquad_stereo(output, coeffs, state, q - 1));
+            }
+            fill(state, sections * DSP_NUM_STATES_PER_BIQUAD, 2);
+            BENCH("filters_biquads", sections, q - 1, "sample", 1, ,
+                  dsp_filters_biquads(random_state >> 2, coeffs, state, sections, q - 1));
+            fill(state, sections * 2 * DSP_NUM_STATES_PER_BIQUAD, 2);
+            BENCH("filters_biquads_stereo", sections, q - 1, "sample", 2,
+                  output[0] = random_state >> 2; output[1] = random_state >> 3,
+                  dsp_filters_biquads_stereo(output, coeffs, state, sections, q - 1));
+            // The same pair of channels as two mono calls, for comparison
+            fill(state, sections * 2 * DSP_NUM_STATES_PER_BIQUAD, 2);
+            BENCH("filters_biquads_mono_pair", sections, q - 1, "sample", 2, ,
+                  output[0] = dsp_filters_biquads(random_state >> 2, coeffs, state, sections, q - 1);
+                  output[1] = dsp_filters_biquads(random_state >> 3, coeffs,
+                                                  &state[sections * DSP_NUM_STATES_PER_BIQUAD],
+                                                  sections, q - 1));
+            // 16 channels of 32 samples
+            fill(state, sections * 16 * DSP_NUM_STATES_PER_BIQUAD, 2);
+            BENCH("filters_biquads_interleaved", sections, q - 1, "sample", 16 * 32,
+                  fill(input, 16 * 32, 2),
+                  dsp_filters_biquads_interleaved(input, output, 16, 32, coeffs, state,
+                                                  sections, q - 1));
+            // Smoothing towards the same pass through coefficients, which
+            // takes as long as towards any other target
+            for( int32_t i = 0; i < sections * DSP_NUM_COEFFS_PER_BIQUAD; ++i ) coeffs[MAX_TAPS + i] = coeffs[i];
+            fill(state, sections * DSP_NUM_STATES_PER_BIQUAD, 2);
+            BENCH("filters_biquads_smooth", sections, q - 1, "sample", 64, fill(input, 64, 2),
+                  dsp_filters_biquads_smooth(input, output, 64, coeffs, &coeffs[MAX_TAPS],
+                                             state, sections, q - 1));
+        }
+    }
+}
+
+static void bench_filters_block(void)
+{
+    // 44.1 kHz to 48 kHz conversion with a 480 tap prototype
+    fill(input, 480, 8);
+    dsp_filters_resampler_init(input, 480, 160, coeffs, state);
+    BENCH("filters_resampler", 480, 31, "sample", 147, fill(input, 147, 2),
+          dsp_filters_resampler(input, 147, output, coeffs, state, 480, 160, 147, 31));
+    fill(coeffs, BLOCK_TAPS, 8);
+    for( int32_t B = 64; B <= MAX_BLOCK; B *= 4 ) {
+        dsp_filters_fft_convolution_init(coeffs, BLOCK_TAPS, B, block_state,
+                                         sine_table(B), sine_table(2 * B));
+        BENCH("filters_fft_convolution", B, 31, "sample", B, fill(input, B, 2),
+              dsp_filters_fft_convolution(input, output, block_state, BLOCK_TAPS, B, 31,
+                                          sine_table(B), sine_table(2 * B)));
+    }
+}
+
+static void bench_adaptive(void)
+{
+    dsp_adaptive_nlms_state_t nlms_state;
+    for( int32_t taps = 16; taps <= 256; taps *= 4 ) {
+        int32_t error;
+        fill(coeffs, taps, 6);
+        fill(state, taps, 2);
+        BENCH("adaptive_lms", taps, 28, "sample", 1, fill(input, 2, 4),
+              dsp_adaptive_lms(input[0], input[1], &error,
+                               coeffs, state, taps, 1 << 20, 28));
+        BENCH("adaptive_nlms", taps, 28, "sample", 1, fill(input, 2, 4),
+              dsp_adaptive_nlms(input[0], input[1], &error,
+                                coeffs, state, taps, 1 << 20, 28));
+        dsp_adaptive_nlms_init(&nlms_state, state, taps);
+        BENCH("adaptive_nlms_incremental", taps, 28, "sample", 1, fill(input, 2, 4),
+              dsp_adaptive_nlms_incremental(input[0], input[1], &error, coeffs, state,
+                                            &nlms_state, taps, 1 << 20, 28));
+    }
+    for( int32_t B = 64; B <= MAX_BLOCK; B *= 4 ) {
+        for( int32_t constrained = 0; constrained <= 1; ++constrained ) {
+            for( int32_t i = 0; i < BLOCK_TAPS; ++i ) coeffs[i] = 0;
+            dsp_adaptive_fdaf_init(coeffs, BLOCK_TAPS, B, block_state, 31,
+                                   sine_table(B), sine_table(2 * B));
+            BENCH(constrained ? "adaptive_fdaf_constrained" : "adaptive_fdaf", B, 31, "sample", B,
+                  fill(input, B, 2); fill(input + MAX_BLOCK, B, 2),
+                  dsp_adaptive_fdaf(input, input + MAX_BLOCK, output, output + MAX_BLOCK,
+                                    block_state, BLOCK_TAPS, B, Q31(0.5), constrained, 31,
+                                    sine_table(B), sine_table(2 * B)));
+        }
+    }
+}
+
+static void bench_matrix(void)
+{
+    for( int32_t dim = 4; dim <= MAX_DIM; dim *= 2 ) {
+        fill(matrix_x, dim * dim, 4);
+        fill(matrix_y, dim * dim, 4);
+        for( int32_t i = 0; i < dim * dim; ++i ) weights[i] = random_number() >> 24;
+        for( int32_t i = 0; i < dim * dim; ++i ) weights16[i] = random_number() >> 16;
+        BENCH("matrix_mulm", dim, 28, "element", dim * dim, ,
+              dsp_matrix_mulm(matrix_x, matrix_y, matrix_r, dim, dim, dim, 28));
+        dsp_matrix_mulm_pack(matrix_y, matrix_p, dim, dim);
+        BENCH("matrix_mulm_packed", dim, 28, "element", dim * dim, ,
+              dsp_matrix_mulm_packed(matrix_x, matrix_p, matrix_r, dim, dim, dim, 28));
+        BENCH("matrix_mulv", dim, 28, "element", dim * dim, ,
+              dsp_matrix_mulv(matrix_x, matrix_y, matrix_r, dim, dim, 28));
+        BENCH("matrix_mulv_w8", dim, 0, "element", dim * dim, ,
+              dsp_matrix_mulv_w8(weights, matrix_y, matrix_x, matrix_r, dim, dim, 8,
+                                 DSP_ACTIVATION_RELU));
+        BENCH("matrix_mulv_w16", dim, 0, "element", dim * dim, ,
+              dsp_matrix_mulv_w16(weights16, matrix_y, matrix_x, matrix_r, dim, dim, 16,
+                                  DSP_ACTIVATION_RELU));
+        BENCH("matrix_addm", dim, 28, "element", dim * dim, ,
+              dsp_matrix_addm(matrix_x, matrix_y, matrix_r, dim, dim));
+        BENCH("matrix_subm", dim, 28, "element", dim * dim, ,
+              dsp_matrix_subm(matrix_x, matrix_y, matrix_r, dim, dim));
+        BENCH("matrix_adds", dim, 28, "element", dim * dim, ,
+              dsp_matrix_adds(matrix_x, Q28(0.5), matrix_r, dim, dim));
+        BENCH("matrix_muls", dim, 28, "element", dim * dim, ,
+              dsp_matrix_muls(matrix_x, Q28(0.5), matrix_r, dim, dim, 28));
+        BENCH("matrix_negate", dim, 28, "element", dim * dim, ,
+              dsp_matrix_negate(matrix_x, matrix_r, dim, dim));
+        BENCH("matrix_transposition", dim, 28, "element", dim * dim, ,
+              dsp_matrix_transpose(matrix_x, matrix_r, dim, dim, 28));
+    }
+}
+
+static void bench_vector(void)
+{
+    for( int32_t n = 16; n <= 1024; n *= 4 ) {
+        fill(input, n, 4);
+        fill(output, n, 4);
+        BENCH("vector_mulv", n, 28, "element", n, ,
+              dsp_vector_mulv(input, output, state, n, 28));
+        BENCH("vector_dotprod", n, 28, "element", n, ,
+              dsp_vector_dotprod(input, output, n, 28));
+        BENCH("vector_stats", n, 28, "element", n, ,
+              dsp_vector_stats(input, n, 28));
+        BENCH("vector_minimum", n, 28, "element", n, ,
+              dsp_vector_minimum(input, n));
+        BENCH("vector_maximum", n, 28, "element", n, ,
+              dsp_vector_maximum(input, n));
+        BENCH("vector_abs_sum", n, 28, "element", n, ,
+              dsp_vector_abs_sum(input, n, 28));
+        BENCH("vector_mean", n, 28, "element", n, ,
+              dsp_vector_mean(input, n, 28));
+        BENCH("vector_power", n, 28, "element", n, ,
+              dsp_vector_power(input, n, 28));
+        BENCH("vector_rms", n, 28, "element", n, ,
+              dsp_vector_rms(input, n, 28));
+        BENCH("vector_negate", n, 28, "element", n, ,
+              dsp_vector_negate(input, state, n));
+        BENCH("vector_abs", n, 28, "element", n, ,
+              dsp_vector_abs(input, state, n));
+        BENCH("vector_adds", n, 28, "element", n, ,
+              dsp_vector_adds(input, Q28(0.5), state, n));
+        BENCH("vector_muls", n, 28, "element", n, ,
+              dsp_vector_muls(input, Q28(0.5), state, n, 28));
+        BENCH("vector_addv", n, 28, "element", n, ,
+              dsp_vector_addv(input, output, state, n));
+        BENCH("vector_subv", n, 28, "element", n, ,
+              dsp_vector_subv(input, output, state, n));
+        BENCH("vector_mulv_adds", n, 28, "element", n, ,
+              dsp_vector_mulv_adds(input, output, Q28(0.5), state, n, 28));
+        BENCH("vector_muls_addv", n, 28, "element", n, ,
+              dsp_vector_muls_addv(input, Q28(0.5), output, state, n, 28));
+        BENCH("vector_muls_subv", n, 28, "element", n, ,
+              dsp_vector_muls_subv(input, Q28(0.5), output, state, n, 28));
+        BENCH("vector_mulv_addv", n, 28, "element", n, ,
+              dsp_vector_mulv_addv(input, output, input, state, n, 28));
+        BENCH("vector_mulv_subv", n, 28, "element", n, ,
+              dsp_vector_mulv_subv(input, output, input, state, n, 28));
+        BENCH("vector_mulv_complex", n, 28, "element", n, ,
+              dsp_vector_mulv_complex(input, output, output, input, state, matrix_r, n, 28));
+        BENCH("vector_minv", n, 28, "element", n, ,
+              dsp_vector_minv((uint32_t*) state, (uint32_t*) output, n));
+        for( int32_t i = 0; i < n; ++i ) input[i] = (i + 1) * (Q24(4.5) / n);
+        BENCH("vector_sqrt", n, 24, "element", n, ,
+              dsp_vector_sqrt(input, output, n));
+        BENCH("vector_exp", n, 24, "element", n, ,
+              dsp_vector_exp(input, output, n));
+        BENCH("vector_log", n, 24, "element", n, ,
+              dsp_vector_log(input, output, n));
+        // The same functions called per element, to compare with the above
+        BENCH("vector_sqrt_scalar", n, 24, "element", n, ,
+              for( int32_t i = 0; i < n; ++i ) output[i] = dsp_math_sqrt(input[i]));
+        BENCH("vector_exp_scalar", n, 24, "element", n, ,
+              for( int32_t i = 0; i < n; ++i ) output[i] = dsp_math_exp(input[i]));
+        BENCH("vector_log_scalar", n, 24, "element", n, ,
+              for( int32_t i = 0; i < n; ++i ) output[i] = dsp_math_log(input[i]));
+        // The q_format column holds the precision argument
+        for( int32_t precision = 0; precision <= 16; precision += 8 ) {
+            BENCH("vector_atan2_hypot", n, precision, "point", n, fill_complex(n, 4),
+                  dsp_vector_atan2_hypot(data, n, precision));
+            BENCH("vector_atan2_hypot_scalar", n, precision, "point", n, fill_complex(n, 4),
+                  for( int32_t i = 0; i < n; ++i ) dsp_math_atan2_hypot((int*) &data[i], precision));
+        }
+    }
+}
+
+static void bench_complex(void)
+{
+    dsp_complex_t* b = scratch;
+    dsp_complex_t* o = data + MAX_POINTS / 2;
+    volatile dsp_complex_t r;
+    dsp_complex_t x = { random_number() >> 4, random_number() >> 4 };
+    dsp_complex_t y = { random_number() >> 4, random_number() >> 4 };
+    BENCH("complex_add", 1, 28, "call", 1, , r = dsp_complex_add(x, y));
+    BENCH("complex_sub", 1, 28, "call", 1, , r = dsp_complex_sub(x, y));
+    BENCH("complex_mul", 1, 28, "call", 1, , r = dsp_complex_mul(x, y, 28));
+    BENCH("complex_mul_conjugate", 1, 28, "call", 1, , r = dsp_complex_mul_conjugate(x, y, 28));
+    (void) r;
+    for( uint32_t N = 16; N <= 1024; N *= 4 ) {
+        fill_complex(N, 4);
+        for( uint32_t i = 0; i < N; ++i ) {
+            b[i].re = random_number() >> 4;
+            b[i].im = random_number() >> 4;
+        }
+        BENCH("complex_fir", N, 28, "tap", N, ,
+              dsp_complex_fir(data, b, N, N / 2, 28));
+        BENCH("complex_mul_vector", N, 28, "point", N, fill_complex(N, 4),
+              dsp_complex_mul_vector(data, b, N, 28));
+        BENCH("complex_mul_conjugate_vector", N, 28, "point", N, fill_complex(N, 4),
+              dsp_complex_mul_conjugate_vector(data, b, N, 28));
+        BENCH("complex_mul_conjugate_vector3", N, 28, "point", N, ,
+              dsp_complex_mul_conjugate_vector3(o, data, b, N, 28));
+        BENCH("complex_add_vector", N, 28, "point", N, fill_complex(N, 4),
+              dsp_complex_add_vector(data, b, N));
+        BENCH("complex_add_vector_shl", N, 28, "point", N, fill_complex(N, 4),
+              dsp_complex_add_vector_shl(data, b, N, -1));
+        BENCH("complex_add_vector_scale", N, 24, "point", N, fill_complex(N, 4),
+              dsp_complex_add_vector_scale(data, b, N, Q24(0.5)));
+        BENCH("complex_sub_vector", N, 28, "point", N, fill_complex(N, 4),
+              dsp_complex_sub_vector(data, b, N));
+        BENCH("complex_add_vector3", N, 28, "point", N, ,
+              dsp_complex_add_vector3(o, data, b, N));
+        BENCH("complex_sub_vector3", N, 28, "point", N, ,
+              dsp_complex_sub_vector3(o, data, b, N));
+        BENCH("complex_macc_vector", N, 28, "point", N, fill_complex(N, 4),
+              dsp_complex_macc_vector(data, b, o, N, 28));
+        BENCH("complex_nmacc_vector", N, 28, "point", N, fill_complex(N, 4),
+              dsp_complex_nmacc_vector(data, b, o, N, 28));
+        BENCH("complex_scalar_vector3", N, 28, "point", N, ,
+              dsp_complex_scalar_vector3(o, data, N, Q28(0.5), 28));
+        BENCH("complex_magnitude_vector", N, 0, "point", N, fill_complex(N, 4),
+              dsp_complex_magnitude_vector((uint32_t*) output, data, N, 0));
+        for( uint32_t i = 0; i < N; ++i ) {
+            input[i] = (random_number() >> 8) | 1;
+            output[i] = (random_number() >> 8) & 0x7fffff;
+        }
+        BENCH("complex_scale_vector", N, 0, "point", N, fill_complex(N, 8),
+              dsp_complex_scale_vector(data, (uint32_t*) input, (uint32_t*) output, N));
+        BENCH("complex_window_hanning_post_fft_half", N, 31, "point", N, fill_complex(N, 4),
+              dsp_complex_window_hanning_post_fft_half(data, N));
+        BENCH("complex_combine", N, 31, "point", N, ,
+              dsp_complex_combine(input, output, o, N));
+        BENCH("complex_split", N, 31, "point", N, ,
+              dsp_complex_split(data, input, output, N));
+    }
+}
+
+static void bench_math(void)
+{
+    volatile int32_t r;
+    BENCH("math_multiply", 1, 24, "call", 1, , r = dsp_math_multiply(random_state, Q24(0.9), 24));
+    BENCH("math_divide", 1, 24, "call", 1, , r = dsp_math_divide(ONE_Q8_24, random_state | 1, 24));
+    BENCH("math_sqrt", 1, 24, "call", 1, , r = dsp_math_sqrt(random_state >> 1));
+    BENCH("math_sin", 1, 24, "call", 1, , r = dsp_math_sin(random_state >> 6));
+    BENCH("math_atan", 1, 24, "call", 1, , r = dsp_math_atan(random_state >> 6));
+    BENCH("math_exp", 1, 24, "call", 1, , r = dsp_math_exp(random_state >> 8));
+    BENCH("math_log", 1, 24, "call", 1, , r = dsp_math_log((random_state >> 1) | 1));
+    BENCH("math_multiply_sat", 1, 24, "call", 1, , r = dsp_math_multiply_sat(random_state, Q24(0.9), 24));
+    BENCH("math_divide_unsigned", 1, 24, "call", 1, , r = dsp_math_divide_unsigned(ONE_Q8_24, random_state | 1, 24));
+    BENCH("math_cos", 1, 24, "call", 1, , r = dsp_math_cos(random_state >> 6));
+    BENCH("math_asin", 1, 24, "call", 1, , r = dsp_math_asin(random_state >> 8));
+    BENCH("math_acos", 1, 24, "call", 1, , r = dsp_math_acos(random_state >> 8));
+    BENCH("math_sinh", 1, 24, "call", 1, , r = dsp_math_sinh(random_state >> 8));
+    BENCH("math_cosh", 1, 24, "call", 1, , r = dsp_math_cosh(random_state >> 8));
+    BENCH("math_logistics", 1, 24, "call", 1, , r = dsp_math_logistics(random_state >> 6));
+    BENCH("math_logistics_fast", 1, 24, "call", 1, , r = dsp_math_logistics_fast(random_state >> 6));
+    BENCH("math_softplus", 1, 24, "call", 1, , r = dsp_math_softplus(random_state >> 6));
+    BENCH("math_int_sqrt", 1, 0, "call", 1, , r = dsp_math_int_sqrt(random_state));
+    BENCH("math_int_sqrt64", 1, 0, "call", 1, , r = dsp_math_int_sqrt64((uint64_t) random_state << 20));
+    {
+        int z[2] = { random_state >> 4, random_state >> 5 };
+        BENCH("math_atan2_hypot", 1, 0, "call", 1, z[0] = random_state >> 4; z[1] = random_state >> 5,
+              dsp_math_atan2_hypot(z, 0));
+    }
+    (void) r;
+}
+
+static void bench_design(void)
+{
+    BENCH("design_biquad_peaking", 1, 28, "call", 1, ,
+          dsp_design_biquad_peaking(1000.0 / 48000.0, 0.707, 3.0, coeffs, 28));
+    BENCH("design_biquad_peaking_fixed", 1, 28, "call", 1, ,
+          dsp_design_biquad_peaking_fixed(Q31(1000.0 / 48000.0), Q24(0.707), Q24(3.0), coeffs, 28));
+    BENCH("design_biquad_lowshelf", 1, 28, "call", 1, ,
+          dsp_design_biquad_lowshelf(100.0 / 48000.0, 0.707, 6.0, coeffs, 28));
+    BENCH("design_biquad_lowshelf_fixed", 1, 28, "call", 1, ,
+          dsp_design_biquad_lowshelf_fixed(Q31(100.0 / 48000.0), Q24(0.707), Q24(6.0), coeffs, 28));
+    BENCH("design_biquad_highshelf", 1, 28, "call", 1, ,
+          dsp_design_biquad_highshelf(8000.0 / 48000.0, 0.707, 6.0, coeffs, 28));
+    BENCH("design_biquad_highshelf_fixed", 1, 28, "call", 1, ,
+          dsp_design_biquad_highshelf_fixed(Q31(8000.0 / 48000.0), Q24(0.707), Q24(6.0), coeffs, 28));
+    BENCH("design_biquad_lowpass", 1, 28, "call", 1, ,
+          dsp_design_biquad_lowpass(1000.0 / 48000.0, 0.707, coeffs, 28));
+    BENCH("design_biquad_lowpass_fixed", 1, 28, "call", 1, ,
+          dsp_design_biquad_lowpass_fixed(Q31(1000.0 / 48000.0), Q24(0.707), coeffs, 28));
+    BENCH("design_biquad_highpass", 1, 28, "call", 1, ,
+          dsp_design_biquad_highpass(1000.0 / 48000.0, 0.707, coeffs, 28));
+    BENCH("design_biquad_highpass_fixed", 1, 28, "call", 1, ,
+          dsp_design_biquad_highpass_fixed(Q31(1000.0 / 48000.0), Q24(0.707), coeffs, 28));
+    BENCH("design_biquad_allpass", 1, 28, "call", 1, ,
+          dsp_design_biquad_allpass(1000.0 / 48000.0, 0.707, coeffs, 28));
+    BENCH("design_biquad_allpass_fixed", 1, 28, "call", 1, ,
+          dsp_design_biquad_allpass_fixed(Q31(1000.0 / 48000.0), Q24(0.707), coeffs, 28));
+    BENCH("design_biquad_notch", 1, 28, "call", 1, ,
+          dsp_design_biquad_notch(1000.0 / 48000.0, 0.707, coeffs, 28));
+    BENCH("design_biquad_notch_fixed", 1, 28, "call", 1, ,
+          dsp_design_biquad_notch_fixed(Q31(1000.0 / 48000.0), Q24(0.707), coeffs, 28));
+    BENCH("design_biquad_bandpass", 1, 28, "call", 1, ,
+          dsp_design_biquad_bandpass(900.0 / 48000.0, 1100.0 / 48000.0, coeffs, 28));
+}
+
+static void bench_goertzel(void)
+{
+    uint32_t bins[MAX_BINS];
+    for( int32_t i = 0; i < MAX_BINS; ++i ) bins[i] = 3 + 15 * i;
+    for( int32_t num_bins = 8; num_bins <= MAX_BINS; num_bins *= 4 ) {
+        dsp_goertzel_init(goertzel, bins, num_bins, DFT_POINTS, dsp_sine_1024);
+        // Each run starts a frame, to keep the state within its headroom
+        BENCH("goertzel_update", num_bins, 31, "sample", 256,
+              fill(input, 256, 0); dsp_goertzel_result(goertzel, data),
+              dsp_goertzel_update(goertzel, input, 256));
+        dsp_goertzel_sliding_init(goertzel, bins, num_bins, DFT_POINTS);
+        BENCH("goertzel_sliding_update", num_bins, 31, "sample", 256, fill(input, 256, 0),
+              dsp_goertzel_sliding_update(goertzel, input, 256, dsp_sine_1024));
+        BENCH("goertzel_sliding_result", num_bins, 31, "call", 1, ,
+              dsp_goertzel_sliding_result(goertzel, data, dsp_sine_1024));
+    }
+}
+
+int main(void)
+{
+    unsigned t0 = get_time();
+    overhead = get_time() - t0;
+
+    printf("BENCH,kernel,size,q_format,unit,min,median,max\n");
+    bench_fft();
+    bench_fft_mixed();
+    bench_dct();
+    bench_stft();
+    bench_bfp();
+    bench_filters();
+    bench_filters_block();
+    bench_adaptive();
+    bench_matrix();
+    bench_vector();
+    bench_complex();
+    bench_math();
+    bench_design();
+    bench_goertzel();
+    exit(0);
+    return 0;
+}
@@ -0,0 +1,12 @@
+import xmostest
+
+def runtest():
+    resources = xmostest.request_resource("xsim")
+     
+    tester = xmostest.ComparisonTester(open('dct_test.expect'),
+                                       'lib_dsp', 'simple_tests',
+                                       'test_dct', {})
+     
+    xmostest.run_on_simulator(resources['xsim'],
+                              'test_dct/bin/test.xe',
+                              tester=tester, timeout=1200)
@@ -0,0 +1,147 @@
+// Copyright (c) 2017, XMOS Ltd, All rights reserved
+// XMOS DSP Library - FFT based DCT-II/III/IV test
+//
+// For each length, the outputs of the transforms are compared with a 64-bit
+// direct evaluation of their definitions: every output for lengths up to
+// CHECKED_OUTPUTS, and CHECKED_OUTPUTS evenly spaced ones above that. The
+// inverses transform the output of the forward transforms, and must also
+// give back their input.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <dsp.h>
+
+#define MAX_N           2048
+#define CHECKED_OUTPUTS 256
+#define SUM_SHIFT       16   // Of each product in the 64-bit sums
+
+int32_t input[MAX_N];
+int32_t coeffs[MAX_N];
+int32_t output[MAX_N];
+dsp_complex_t scratch[MAX_N / 2];
+
+static unsigned random_state = 0x12345678;
+
+static int32_t random_number(void)
+{
+    random_state = random_state * 1664525 + 1013904223;
+    return (int32_t) random_state;
+}
+
+static const int32_t* sine_table(const uint32_t N)
+{
+    switch( N ) {
+    case 4:     return dsp_sine_4;
+    case 8:     return dsp_sine_8;
+    case 16:    return dsp_sine_16;
+    case 32:    return dsp_sine_32;
+    case 64:    return dsp_sine_64;
+    case 128:   return dsp_sine_128;
+    case 256:   return dsp_sine_256;
+    case 512:   return dsp_sine_512;
+    case 1024:  return dsp_sine_1024;
+    case 2048:  return dsp_sine_2048;
+    case 4096:  return dsp_sine_4096;
+    case 8192:  return dsp_sine_8192;
+    default:    return dsp_sine_16384;
+    }
+}
+
+// cos(2*pi*m/M) from the quarter sine table of M points
+static int64_t cosine(const int32_t sine[], const uint32_t M, const uint32_t m)
+{
+    const uint32_t q = M / 4;
+    switch( m / q ) {
+    case 0:     return sine[q - m];
+    case 1:     return -sine[m - q];
+    case 2:     return -sine[3*q - m];
+    default:    return sine[m - 3*q];
+    }
+}
+
+// sum(x[j] * cos(pi*a*(b*j + c)/(4N))), in units of 2^(SUM_SHIFT - 31)
+static int64_t dct_sum(const int32_t x[], const uint32_t N, const uint32_t a,
+                       const uint32_t b, const uint32_t c, const int32_t dct_sine[])
+{
+    int64_t sum = 0;
+    for( uint32_t j = 0; j < N; ++j ) {
+        uint32_t m = (a * (b * j + c)) % (8 * N);
+        sum += (x[j] * cosine(dct_sine, 8 * N, m)) >> SUM_SHIFT;
+    }
+    return sum;
+}
+
+static int32_t to_int(const int64_t sum)
+{
+    return (int32_t) ((sum + (1 << (30 - SUM_SHIFT))) >> (31 - SUM_SHIFT));
+}
+
+static int check(const int32_t a, const int32_t b, const int32_t tolerance)
+{
+    int32_t e = a - b;
+    return e <= tolerance && e >= -tolerance;
+}
+
+// Returns the number of the checked outputs of the DCT-II (iv = 0) or the
+// DCT-IV (iv = 1) of input that differ from their definitions
+static int32_t check_forward(const uint32_t N, const int32_t iv, const int32_t dct_sine[])
+{
+    const uint32_t step = N > CHECKED_OUTPUTS ? N / CHECKED_OUTPUTS : 1;
+    int32_t errors = 0;
+    for( uint32_t k = 0; k < N; k += step ) {
+        int64_t sum = dct_sum(input, N, iv ? 2*k + 1 : 2*k, 2, 1, dct_sine);
+        if( !check(coeffs[k], to_int(sum / (int64_t) N), 8) ) ++errors;
+    }
+    return errors;
+}
+
+// As check_forward(), for the inverses of coeffs, which must also be
+// within round_trip of the input
+static int32_t check_inverse(const uint32_t N, const int32_t iv, const int32_t dct_sine[],
+                             const int32_t round_trip)
+{
+    const uint32_t step = N > CHECKED_OUTPUTS ? N / CHECKED_OUTPUTS : 1;
+    int32_t errors = 0;
+    for( uint32_t n = 0; n < N; n += step ) {
+        int32_t expected;
+        if( iv ) {
+            expected = to_int(2 * dct_sum(coeffs, N, 2*n + 1, 2, 1, dct_sine));
+        } else {
+            // coeffs[0] + 2 * sum over k > 0
+            expected = to_int(2 * dct_sum(coeffs, N, 2 * (2*n + 1), 1, 0, dct_sine)) - coeffs[0];
+        }
+        if( !check(output[n], expected, N / 4 + 32) ) ++errors;
+        if( !check(output[n], input[n], round_trip) ) ++errors;
+    }
+    return errors;
+}
+
+int main(void)
+{
+    for( uint32_t N = 8; N <= MAX_N; N *= 2 ) {
+        const int32_t* sine = sine_table(N / 2);
+        const int32_t* dct_sine = sine_table(8 * N);
+        int32_t errors = 0;
+
+        for( uint32_t i = 0; i < N; ++i ) input[i] = random_number() >> 1;
+
+        dsp_dct_forward(coeffs, input, scratch, N, sine, dct_sine);
+        errors += check_forward(N, 0, dct_sine);
+        dsp_dct_inverse(output, coeffs, scratch, N, sine, dct_sine);
+        errors += check_inverse(N, 0, dct_sine, N / 2 + 16);
+
+        dsp_dct_iv_forward(coeffs, input, scratch, N, sine, dct_sine);
+        errors += check_forward(N, 1, dct_sine);
+        dsp_dct_iv_inverse(output, coeffs, scratch, N, sine, dct_sine);
+        errors += check_inverse(N, 1, dct_sine, N + 16);
+
+        if( errors == 0 ) {
+            printf("DCT %d points: PASS\n", N);
+        } else {
+            printf("DCT %d points: FAIL with %d errors\n", N, errors);
+        }
+    }
+    exit(0);
+    return 0;
+}
@@ -35,6 +35,7 @@ def do_fft_test(length_log2, testlevel, test_dir_name, test_name):
 
     gen_test.generate(180, length_log2, 1, seed, source_directory)
     shutil.copy(os.path.join(test_dir_name,'src','test.xc'), source_directory)
+    shutil.copy('fft_test.h', source_directory)
     shutil.copy(os.path.join(test_dir_name,'Makefile'), directory_name)
 
     resources = xmostest.request_resource("xsim")
@@ -70,6 +71,19 @@ def runtest():
             do_fft_test(r, "smoke", 'test_fft_index_bit_reverse', "index_bit_reversal")
             do_fft_test(r, "smoke", 'test_fft_split_and_merge', "fft_split_and_merge")
             do_fft_test(r, "smoke", 'test_fft_short_long', "short_and_long_conversion ")
+            do_fft_test(r, "smoke", 'test_fft_radix4', "radix4_fft")
+            do_fft_test(r, "smoke", 'test_fft_sine_shared', "sine_shared_fft")
+            do_fft_test(r, "smoke", 'test_fft_sine_strided', "sine_strided_fft")
+            do_fft_test(r, "smoke", 'test_fft_bit_reverse_fused', "bit_reverse_fused_fft")
+            do_fft_test(r, "smoke", 'test_fft_bfp', "bfp_fft")
+            do_fft_test(r, "smoke", 'test_fft_short', "short_fft")
+            if r >= 4:
+                do_fft_test(r, "smoke", 'test_fft_parallel', "parallel_fft")
+            if r <= 11:
+                do_fft_test(r, "smoke", 'test_fft_batch', "batch_fft")
+                do_fft_test(r, "smoke", 'test_fft_mixed', "mixed_radix_fft")
+                do_fft_test(r, "smoke", 'test_fft_plan', "plan_fft")
+                do_fft_test(r, "smoke", 'test_fft_spectrum', "spectrum_fft")
     except:
         #clean everything up
         for file in os.listdir("."):
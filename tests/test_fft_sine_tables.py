@@ -0,0 +1,12 @@
+import xmostest
+
+def runtest():
+    resources = xmostest.request_resource("xsim")
+     
+    tester = xmostest.ComparisonTester(open('fft_sine_tables_test.expect'),
+                                       'lib_dsp', 'simple_tests',
+                                       'test_fft_sine_tables', {})
+     
+    xmostest.run_on_simulator(resources['xsim'],
+                              'test_fft_sine_tables/bin/test.xe',
+                              tester=tester, timeout=1200)
@@ -0,0 +1,45 @@
+// Copyright (c) 2017, XMOS Ltd, All rights reserved
+// XMOS DSP Library - Shared sine table test
+//
+// Built with -DDSP_SINE_SHARED=16384, so only the 16384 point table is
+// linked in. The separate table for each N is computed here with the
+// expression of generatesine.sh; it must be every (16384/N)th value of the
+// shared table, and equal to the table of dsp_fft_sine_generate().
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <dsp.h>
+
+#if DSP_SINE_SHARED != 16384
+#error "This test must be built with DSP_SINE_SHARED=16384"
+#endif
+
+int32_t separate[DSP_SINE_SHARED / 4 + 1];
+int32_t generated[DSP_SINE_SHARED / 4 + 1];
+
+static void report(const char* name, const int pass)
+{
+    printf("%s: %s\n", name, pass ? "PASS" : "FAIL");
+}
+
+int main(void)
+{
+    int pass = 1, generated_pass = 1;
+    for( uint32_t N = 4; N <= DSP_SINE_SHARED; N *= 2 ) {
+        uint32_t quarter = N / 4;
+        for( uint32_t i = 0; i < quarter; ++i ) {
+            separate[i] = (int32_t) (sin(i * 3.1415926535 / 2 / quarter) * 2147483648.0);
+        }
+        separate[quarter] = 0x7fffffff;
+        dsp_fft_sine_generate(generated, N);
+        for( uint32_t i = 0; i <= quarter; ++i ) {
+            pass = pass && separate[i] == dsp_sine_shared[i * (DSP_SINE_SHARED / N)];
+            generated_pass = generated_pass && generated[i] == separate[i];
+        }
+    }
+    report("Shared table against the separate tables", pass);
+    report("dsp_fft_sine_generate against the separate tables", generated_pass);
+    return 0;
+}
@@ -0,0 +1,12 @@
+import xmostest
+
+def runtest():
+    resources = xmostest.request_resource("xsim")
+     
+    tester = xmostest.ComparisonTester(open('fifo_test.expect'),
+                                       'lib_dsp', 'simple_tests',
+                                       'app_fifo_pipeline', {})
+     
+    xmostest.run_on_simulator(resources['xsim'],
+                              '../AN00209_xCORE-200_DSP_Library/app_fifo_pipeline/bin/app_fifo_pipeline.xe',
+                              tester=tester)
@@ -0,0 +1,178 @@
+// Copyright (c) 2017, XMOS Ltd, All rights reserved
+// XMOS DSP Library - Instrumentation test
+//
+// Built with DSP_INSTRUMENT=1, so the calls below go through the wrappers
+// of dsp_instrument.c. After each call the records of this logical core
+// are read back: there must be one duration record of the function, and
+// a saturation record with the number of clamped outputs when the inputs
+// are chosen to clamp. Calls made inside the library, such as the complex
+// FFT of a real FFT, must not be recorded. Finally the ring is overfilled
+// to check the count of dropped records.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <xs1.h>
+#include <dsp.h>
+
+#if !DSP_INSTRUMENT
+#error "This test must be built with DSP_INSTRUMENT=1"
+#endif
+
+#define FFT_N    64
+#define TAPS     8
+#define BLOCK    16
+#define SECTIONS 3
+
+// Global, to enforce 64 bit alignment
+dsp_complex_t data[FFT_N];
+int32_t coeffs[SECTIONS * DSP_NUM_COEFFS_PER_BIQUAD];
+int32_t state[DSP_FILTERS_FIR_BLOCK_STATE_LENGTH(TAPS)];
+int32_t input[BLOCK];
+int32_t output[BLOCK];
+int32_t matrix_x[4], matrix_y[4], matrix_r[4];
+uint32_t records[DSP_INSTRUMENT_RING_LENGTH];
+
+static unsigned random_state = 0x12345678;
+
+static int32_t random_number(void)
+{
+    random_state = random_state * 1664525 + 1013904223;
+    return (int32_t) random_state;
+}
+
+static void fill(int32_t x[], const uint32_t n, const int32_t value)
+{
+    for( uint32_t i = 0; i < n; ++i ) x[i] = value;
+}
+
+// Returns 1 if the records since the last check are a duration record of
+// function, followed by a saturation record of saturated outputs if
+// saturated is not 0
+static int check_records(const dsp_instrument_function_t function, const uint32_t saturated)
+{
+    const uint32_t core = get_logical_core_id();
+    uint32_t n = dsp_instrument_read(records, DSP_INSTRUMENT_RING_LENGTH);
+    if( n != (saturated ? 2 : 1) ) return 0;
+    for( uint32_t i = 0; i < n; ++i ) {
+        if( DSP_INSTRUMENT_RECORD_CORE(records[i]) != core ||
+            DSP_INSTRUMENT_RECORD_FUNCTION(records[i]) != function ) {
+            return 0;
+        }
+    }
+    if( DSP_INSTRUMENT_RECORD_EVENT(records[0]) != DSP_INSTRUMENT_EVENT_TICKS ||
+        DSP_INSTRUMENT_RECORD_VALUE(records[0]) == 0 ) {
+        return 0;
+    }
+    if( saturated && (DSP_INSTRUMENT_RECORD_EVENT(records[1]) != DSP_INSTRUMENT_EVENT_SATURATION ||
+                      DSP_INSTRUMENT_RECORD_VALUE(records[1]) != saturated) ) {
+        return 0;
+    }
+    return 1;
+}
+
+static void report(const char* name, const int pass)
+{
+    printf("%s: %s\n", name, pass ? "PASS" : "FAIL");
+}
+
+static void test_fft(void)
+{
+    for( uint32_t i = 0; i < FFT_N; ++i ) {
+        data[i].re = random_number() >> 1;
+        data[i].im = random_number() >> 1;
+    }
+    dsp_fft_bit_reverse(data, FFT_N);
+    dsp_fft_forward(data, FFT_N, dsp_sine_64);
+    report("dsp_fft_forward", check_records(DSP_INSTRUMENT_FFT_FORWARD, 0));
+    dsp_fft_bit_reverse(data, FFT_N);
+    dsp_fft_inverse(data, FFT_N, dsp_sine_64);
+    report("dsp_fft_inverse", check_records(DSP_INSTRUMENT_FFT_INVERSE, 0));
+
+    dsp_fft_bit_reverse_and_forward_real((int32_t*) data, 2 * FFT_N, dsp_sine_64, dsp_sine_128);
+    report("dsp_fft_bit_reverse_and_forward_real",
+           check_records(DSP_INSTRUMENT_FFT_FORWARD_REAL, 0));
+    dsp_fft_bit_reverse_and_inverse_real((int32_t*) data, 2 * FFT_N, dsp_sine_64, dsp_sine_128);
+    report("dsp_fft_bit_reverse_and_inverse_real",
+           check_records(DSP_INSTRUMENT_FFT_INVERSE_REAL, 0));
+}
+
+// Coefficients of 0.75 and samples of 0.5 give 0.375 per tap, so a sum of
+// three taps or more clamps
+static void test_filters(void)
+{
+    fill(coeffs, TAPS, Q31(0.75));
+    fill(state, TAPS, 0);
+    dsp_filters_fir(Q31(0.5), coeffs, state, TAPS, 31);
+    report("dsp_filters_fir", check_records(DSP_INSTRUMENT_FILTERS_FIR, 0));
+    fill(state, TAPS, Q31(0.5));
+    dsp_filters_fir(Q31(0.5), coeffs, state, TAPS, 31);
+    report("dsp_filters_fir saturation", check_records(DSP_INSTRUMENT_FILTERS_FIR, 1));
+
+    // The first two outputs are 0.375 and 0.75, the others clamp
+    fill(state, DSP_FILTERS_FIR_BLOCK_STATE_LENGTH(TAPS), 0);
+    fill(input, BLOCK, Q31(0.5));
+    dsp_filters_fir_block(input, output, BLOCK, coeffs, state, TAPS, 31);
+    report("dsp_filters_fir_block saturation",
+           check_records(DSP_INSTRUMENT_FILTERS_FIR_BLOCK, BLOCK - 2));
+
+    // Sections with b0 = 1.5 in Q30 and no feedback: the first section
+    // gives 1.5 * 2^30, the second and third clamp
+    fill(coeffs, SECTIONS * DSP_NUM_COEFFS_PER_BIQUAD, 0);
+    for( int32_t s = 0; s < SECTIONS; ++s ) coeffs[s * DSP_NUM_COEFFS_PER_BIQUAD] = Q30(1.5);
+    fill(state, SECTIONS * DSP_NUM_STATES_PER_BIQUAD, 0);
+    dsp_filters_biquad(1 << 20, coeffs, state, 30);
+    report("dsp_filters_biquad", check_records(DSP_INSTRUMENT_FILTERS_BIQUAD, 0));
+    fill(state, SECTIONS * DSP_NUM_STATES_PER_BIQUAD, 0);
+    dsp_filters_biquad(INT32_MAX, coeffs, state, 30);
+    report("dsp_filters_biquad saturation", check_records(DSP_INSTRUMENT_FILTERS_BIQUAD, 1));
+    fill(state, SECTIONS * DSP_NUM_STATES_PER_BIQUAD, 0);
+    dsp_filters_biquads(1 << 30, coeffs, state, SECTIONS, 30);
+    report("dsp_filters_biquads saturation", check_records(DSP_INSTRUMENT_FILTERS_BIQUADS, 2));
+}
+
+static void test_adaptive(void)
+{
+    int32_t error;
+    fill(coeffs, TAPS, 0);
+    fill(state, TAPS, Q28(0.01));
+    dsp_adaptive_lms(Q28(0.01), Q28(0.02), &error, coeffs, state, TAPS, Q28(0.01), 28);
+    report("dsp_adaptive_lms", check_records(DSP_INSTRUMENT_ADAPTIVE_LMS, 0));
+    dsp_adaptive_nlms(Q28(0.01), Q28(0.02), &error, coeffs, state, TAPS, Q28(0.01), 28);
+    report("dsp_adaptive_nlms", check_records(DSP_INSTRUMENT_ADAPTIVE_NLMS, 0));
+}
+
+static void test_matrix(void)
+{
+    fill(matrix_x, 4, Q28(0.5));
+    fill(matrix_y, 4, Q28(0.25));
+    dsp_matrix_mulm(matrix_x, matrix_y, matrix_r, 2, 2, 2, 28);
+    report("dsp_matrix_mulm", check_records(DSP_INSTRUMENT_MATRIX_MULM, 0));
+}
+
+// Records beyond the capacity of the ring are counted as dropped, once
+static void test_dropped(void)
+{
+    fill(coeffs, TAPS, 0);
+    for( int32_t i = 0; i < DSP_INSTRUMENT_RING_LENGTH + 5; ++i ) {
+        dsp_filters_fir(i, coeffs, state, TAPS, 31);
+    }
+    int pass = dsp_instrument_read(records, DSP_INSTRUMENT_RING_LENGTH) == DSP_INSTRUMENT_RING_LENGTH;
+    pass = pass && dsp_instrument_read(records, DSP_INSTRUMENT_RING_LENGTH) == 0;
+    pass = pass && dsp_instrument_dropped() == 5;
+    pass = pass && dsp_instrument_dropped() == 0;
+    report("dsp_instrument_dropped", pass);
+}
+
+int main(void)
+{
+    // Nothing has been recorded yet
+    report("dsp_instrument_read", dsp_instrument_read(records, DSP_INSTRUMENT_RING_LENGTH) == 0);
+    test_fft();
+    test_filters();
+    test_adaptive();
+    test_matrix();
+    test_dropped();
+    exit(0);
+    return 0;
+}
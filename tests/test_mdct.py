@@ -0,0 +1,12 @@
+import xmostest
+
+def runtest():
+    resources = xmostest.request_resource("xsim")
+     
+    tester = xmostest.ComparisonTester(open('mdct_test.expect'),
+                                       'lib_dsp', 'simple_tests',
+                                       'test_mdct', {})
+     
+    xmostest.run_on_simulator(resources['xsim'],
+                              'test_mdct/bin/test.xe',
+                              tester=tester, timeout=1200)
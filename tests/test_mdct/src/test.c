@@ -0,0 +1,159 @@
+// Copyright (c) 2017, XMOS Ltd, All rights reserved
+// XMOS DSP Library - MDCT, inverse MDCT and window test
+//
+// For each length and for the sine and KBD windows, a random signal is
+// streamed through dsp_mdct_forward() and dsp_mdct_inverse() one hop at a
+// time. The overlap-added output must be the input delayed by one hop, and
+// the coefficients of each frame are compared with a 64-bit direct
+// evaluation of the MDCT on CHECKED_OUTPUTS evenly spaced bins. The windows
+// must be rising and satisfy w[n]^2 + w[M-1-n]^2 = 1.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <dsp.h>
+
+#define MAX_M           2048
+#define HOPS            4
+#define CHECKED_OUTPUTS 64
+#define SUM_SHIFT       16   // Of each product in the 64-bit sums
+#define KBD_ALPHA       4.0
+
+int32_t window[MAX_M];
+int32_t input[2][MAX_M];
+int32_t coeffs[MAX_M];
+int32_t output[MAX_M];
+int32_t analysis[MAX_M];
+int32_t synthesis[MAX_M];
+dsp_complex_t scratch[MAX_M / 2];
+
+static unsigned random_state = 0x12345678;
+
+static int32_t random_number(void)
+{
+    random_state = random_state * 1664525 + 1013904223;
+    return (int32_t) random_state;
+}
+
+static const int32_t* sine_table(const uint32_t N)
+{
+    switch( N ) {
+    case 4:     return dsp_sine_4;
+    case 8:     return dsp_sine_8;
+    case 16:    return dsp_sine_16;
+    case 32:    return dsp_sine_32;
+    case 64:    return dsp_sine_64;
+    case 128:   return dsp_sine_128;
+    case 256:   return dsp_sine_256;
+    case 512:   return dsp_sine_512;
+    case 1024:  return dsp_sine_1024;
+    case 2048:  return dsp_sine_2048;
+    case 4096:  return dsp_sine_4096;
+    case 8192:  return dsp_sine_8192;
+    default:    return dsp_sine_16384;
+    }
+}
+
+// cos(2*pi*m/M) from the quarter sine table of M points
+static int64_t cosine(const int32_t sine[], const uint32_t M, const uint32_t m)
+{
+    const uint32_t q = M / 4;
+    switch( m / q ) {
+    case 0:     return sine[q - m];
+    case 1:     return -sine[m - q];
+    case 2:     return -sine[3*q - m];
+    default:    return sine[m - 3*q];
+    }
+}
+
+static int check(const int32_t a, const int32_t b, const int32_t tolerance)
+{
+    int32_t e = a - b;
+    return e <= tolerance && e >= -tolerance;
+}
+
+// Number of the values of the rising half window that are not rising or
+// are not power complementary
+static int32_t check_window(const uint32_t M)
+{
+    int32_t errors = 0;
+    for( uint32_t n = 0; n < M; ++n ) {
+        int64_t p = (int64_t) window[n] * window[n] + (int64_t) window[M-1-n] * window[M-1-n];
+        if( !check((int32_t) ((p >> 31) - 0x7fffffff), 0, 64) ) ++errors;
+        if( window[n] <= 0 || (n > 0 && window[n] < window[n-1]) ) ++errors;
+    }
+    return errors;
+}
+
+// Number of checked coefficients of the frame [previous, current] that
+// differ from sum(w[n] * x[n] * cos(pi/M*(n+0.5+M/2)*(k+0.5))) / 2M
+static int32_t check_coeffs(const int32_t previous[], const int32_t current[],
+                            const uint32_t M, const int32_t dct_sine[])
+{
+    const uint32_t step = M > CHECKED_OUTPUTS ? M / CHECKED_OUTPUTS : 1;
+    int32_t errors = 0;
+    for( uint32_t k = 0; k < M; k += step ) {
+        int64_t sum = 0;
+        for( uint32_t n = 0; n < 2 * M; ++n ) {
+            int32_t x = n < M ? previous[n] : current[n - M];
+            int32_t w = n < M ? window[n] : window[2*M - 1 - n];
+            uint32_t m = ((2*n + 1 + M) * (2*k + 1)) % (8 * M);
+            int64_t wx = ((int64_t) w * x) >> 31;
+            sum += (wx * cosine(dct_sine, 8 * M, m)) >> SUM_SHIFT;
+        }
+        sum /= (int64_t) (2 * M);
+        if( !check(coeffs[k], (int32_t) ((sum + (1 << (30 - SUM_SHIFT))) >> (31 - SUM_SHIFT)), 8) ) {
+            ++errors;
+        }
+    }
+    return errors;
+}
+
+// Streams HOPS blocks of M samples through the MDCT and back
+static int32_t check_round_trip(const uint32_t M, const int32_t sine[], const int32_t dct_sine[])
+{
+    int32_t errors = 0;
+    for( uint32_t n = 0; n < M; ++n ) {
+        analysis[n] = synthesis[n] = input[1][n] = 0;
+    }
+    for( uint32_t hop = 0; hop < HOPS; ++hop ) {
+        int32_t* current = input[hop & 1];
+        const int32_t* previous = input[(hop & 1) ^ 1];
+        for( uint32_t n = 0; n < M; ++n ) current[n] = random_number() >> 1;
+
+        dsp_mdct_forward(coeffs, current, analysis, scratch, M, window, sine, dct_sine);
+        errors += check_coeffs(previous, current, M, dct_sine);
+        dsp_mdct_inverse(output, coeffs, synthesis, scratch, M, window, sine, dct_sine);
+        for( uint32_t n = 0; n < M; ++n ) {
+            if( !check(output[n], previous[n], 3 * M + 32) ) ++errors;
+        }
+    }
+    return errors;
+}
+
+int main(void)
+{
+    for( uint32_t M = 8; M <= MAX_M; M *= 2 ) {
+        const int32_t* sine = sine_table(M / 2);
+        const int32_t* dct_sine = sine_table(8 * M);
+        int32_t errors;
+
+        dsp_mdct_window_sine(window, M);
+        errors = check_window(M) + check_round_trip(M, sine, dct_sine);
+        if( errors == 0 ) {
+            printf("MDCT %d coefficients, sine window: PASS\n", M);
+        } else {
+            printf("MDCT %d coefficients, sine window: FAIL with %d errors\n", M, errors);
+        }
+
+        dsp_mdct_window_kbd(window, M, KBD_ALPHA);
+        errors = check_window(M) + check_round_trip(M, sine, dct_sine);
+        if( errors == 0 ) {
+            printf("MDCT %d coefficients, KBD window: PASS\n", M);
+        } else {
+            printf("MDCT %d coefficients, KBD window: FAIL with %d errors\n", M, errors);
+        }
+    }
+    exit(0);
+    return 0;
+}
@@ -0,0 +1,12 @@
+import xmostest
+
+def runtest():
+    resources = xmostest.request_resource("xsim")
+     
+    tester = xmostest.ComparisonTester(open('stft_test.expect'),
+                                       'lib_dsp', 'simple_tests',
+                                       'app_stft', {})
+     
+    xmostest.run_on_simulator(resources['xsim'],
+                              '../AN00209_xCORE-200_DSP_Library/app_stft/bin/app_stft.xe',
+                              tester=tester, timeout=1200)